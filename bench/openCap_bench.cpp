@@ -0,0 +1,996 @@
+// openCap_bench - 无界面基准测试程序
+// 使用确定性的合成截图帧（文字界面、渐变、照片、噪声）驱动渲染器、覆盖层绘制、裁剪和编码，
+// 结果以JSON输出（每次操作耗时、吞吐量、内存分配次数），用于跨版本跟踪热点路径的性能
+//
+// 用法：QT_QPA_PLATFORM=offscreen openCap_bench [--output result.json] [--filter renderer]
+//       非整数缩放比例：QT_SCALE_FACTOR=1.5 openCap_bench
+//       屏幕采集（需要X服务器）：QT_QPA_PLATFORM=xcb xvfb-run openCap_bench --filter capture
+
+#include <QApplication>
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScreen>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+#include "screenshot/capture/CaptureBackend.h"
+#include "screenshot/core/DisplayTopology.h"
+#include "screenshot/core/ScreenshotFrame.h"
+#include "screenshot/core/ScreenshotOverlay.h"
+#include "screenshot/managers/ClipboardMimeData.h"
+#include "screenshot/managers/ExportManager.h"
+#include "screenshot/managers/ScreenshotProcessor.h"
+#include "screenshot/ui/IconAtlas.h"
+#include "screenshot/ui/IconProvider.h"
+#include "screenshot/ui/ScreenshotRenderer.h"
+#include "utils/ImageEncoder.h"
+#include "utils/QoiCodec.h"
+#include "utils/TraceRecorder.h"
+
+namespace
+{
+// 内存分配计数（常量初始化，早于任何分配）
+std::atomic<quint64> g_allocationCount{0};
+} // namespace
+
+#if defined(__GLIBC__)
+// glibc：替换malloc系列函数，operator new和QImage的像素缓冲区都会被统计
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+  g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+  g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+  g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+static const char* const ALLOCATION_COUNTER = "malloc";
+#else
+// 其他平台：只统计operator new（QImage的像素缓冲区不计入）
+void* operator new(std::size_t size)
+{
+  g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+static const char* const ALLOCATION_COUNTER = "operator new";
+#endif
+
+namespace
+{
+// 合成图案
+enum class Pattern
+{
+  Text,     // 文字密集的界面
+  Gradient, // 渐变
+  Photo,    // 照片（低频平滑变化加少量噪声）
+  Noise     // 随机噪声（最难压缩）
+};
+
+struct PatternInfo
+{
+  Pattern pattern;
+  const char* name;
+};
+
+constexpr PatternInfo PATTERNS[] = {
+    {Pattern::Text, "text"},
+    {Pattern::Gradient, "gradient"},
+    {Pattern::Photo, "photo"},
+    {Pattern::Noise, "noise"},
+};
+
+// 截图尺寸（物理像素）
+struct SizeInfo
+{
+  const char* name;
+  int width;
+  int height;
+};
+
+constexpr SizeInfo SIZES[] = {
+    {"1080p", 1920, 1080},
+    {"4k", 3840, 2160},
+    {"8k", 7680, 4320},
+    {"3x1080p", 5760, 1080}, // 三台1080p显示器并排
+};
+
+// 确定性的伪随机数（线性同余）
+class Random
+{
+public:
+  explicit Random(quint32 seed) : m_state(seed) {}
+
+  quint32 next()
+  {
+    m_state = m_state * 1664525u + 1013904223u;
+    return m_state >> 8;
+  }
+
+  int bounded(int limit) { return int(next() % quint32(limit)); }
+
+private:
+  quint32 m_state;
+};
+
+// 文字界面：标题栏、侧边栏和多栏文字
+void paintTextPattern(QImage& image, Random& random)
+{
+  static const char* const WORDS[] = {"screenshot", "capture", "overlay", "region", "pixel",
+                                      "render",     "toolbar", "save",    "copy",   "frame",
+                                      "display",    "window",  "select",  "export", "clip"};
+  constexpr int WORD_COUNT = int(sizeof(WORDS) / sizeof(WORDS[0]));
+
+  image.fill(QColor(250, 250, 250));
+
+  QPainter painter(&image);
+  QFont font("Arial");
+  font.setPixelSize(13);
+  painter.setFont(font);
+
+  // 每1920像素宽为一个“显示器”，各自有标题栏和侧边栏
+  for (int screenX = 0; screenX < image.width(); screenX += 1920)
+  {
+    painter.fillRect(screenX, 0, 1920, 28, QColor(60, 63, 65));
+    painter.fillRect(screenX, 28, 240, image.height() - 28, QColor(236, 238, 240));
+
+    painter.setPen(QColor(40, 40, 40));
+    for (int y = 48; y < image.height(); y += 18)
+    {
+      for (int column = screenX + 260; column < screenX + 1900; column += 420)
+      {
+        QString line;
+        for (int i = 0; i < 6; ++i)
+        {
+          line += QString(WORDS[random.bounded(WORD_COUNT)]) + ' ';
+        }
+        painter.drawText(column, y, line);
+      }
+    }
+  }
+}
+
+// 渐变：水平、垂直和对角方向叠加
+void paintGradientPattern(QImage& image)
+{
+  const int width = image.width();
+  const int height = image.height();
+  for (int y = 0; y < height; ++y)
+  {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    for (int x = 0; x < width; ++x)
+    {
+      line[x] = qRgb(x * 255 / width, y * 255 / height, (x + y) * 255 / (width + height));
+    }
+  }
+}
+
+// 照片：行列方向的低频正弦乘积加少量噪声
+void paintPhotoPattern(QImage& image, Random& random)
+{
+  const int width = image.width();
+  const int height = image.height();
+
+  std::vector<float> columnWave[3];
+  std::vector<float> rowWave[3];
+  for (int channel = 0; channel < 3; ++channel)
+  {
+    const float columnFrequency = 0.002f + 0.001f * random.bounded(8);
+    const float rowFrequency = 0.002f + 0.001f * random.bounded(8);
+    const float phase = 0.01f * random.bounded(628);
+    columnWave[channel].resize(size_t(width));
+    rowWave[channel].resize(size_t(height));
+    for (int x = 0; x < width; ++x)
+    {
+      columnWave[channel][size_t(x)] = std::sin(x * columnFrequency + phase);
+    }
+    for (int y = 0; y < height; ++y)
+    {
+      rowWave[channel][size_t(y)] = std::cos(y * rowFrequency - phase);
+    }
+  }
+
+  for (int y = 0; y < height; ++y)
+  {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    for (int x = 0; x < width; ++x)
+    {
+      int channels[3];
+      for (int channel = 0; channel < 3; ++channel)
+      {
+        const float value = 128.0f + 100.0f * columnWave[channel][size_t(x)] *
+                                         rowWave[channel][size_t(y)];
+        channels[channel] = qBound(0, int(value) + random.bounded(9) - 4, 255);
+      }
+      line[x] = qRgb(channels[0], channels[1], channels[2]);
+    }
+  }
+}
+
+// 随机噪声
+void paintNoisePattern(QImage& image, Random& random)
+{
+  for (int y = 0; y < image.height(); ++y)
+  {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    for (int x = 0; x < image.width(); ++x)
+    {
+      line[x] = 0xFF000000 | random.next();
+    }
+  }
+}
+
+// 生成合成截图帧（同一尺寸和图案每次生成的像素都相同）
+ScreenshotFrame::Ptr generateFrame(Pattern pattern, const QSize& deviceSize, qreal devicePixelRatio)
+{
+  QImage image(deviceSize, ScreenshotFrameView::FORMAT);
+  Random random(quint32(deviceSize.width()) * 31u + quint32(pattern));
+
+  switch (pattern)
+  {
+    case Pattern::Text:
+      paintTextPattern(image, random);
+      break;
+    case Pattern::Gradient:
+      paintGradientPattern(image);
+      break;
+    case Pattern::Photo:
+      paintPhotoPattern(image, random);
+      break;
+    case Pattern::Noise:
+      paintNoisePattern(image, random);
+      break;
+  }
+
+  return ScreenshotFrame::fromImage(std::move(image), devicePixelRatio);
+}
+
+// 单项测试结果
+struct BenchResult
+{
+  QString name;
+  QString size;
+  QString pattern;
+  quint64 iterations = 0;
+  double nanosecondsPerOp = 0.0;
+  double pixelsPerOp = 0.0;
+  double allocationsPerOp = 0.0;
+  qint64 outputBytes = 0; // 编码结果的大小（仅编码测试）
+
+  QJsonObject toJson() const
+  {
+    QJsonObject json;
+    json["name"] = name;
+    json["size"] = size;
+    json["pattern"] = pattern;
+    json["iterations"] = double(iterations);
+    json["ns_per_op"] = nanosecondsPerOp;
+    json["mpixels_per_s"] =
+        nanosecondsPerOp > 0.0 ? pixelsPerOp * 1000.0 / nanosecondsPerOp : 0.0;
+    json["allocations_per_op"] = allocationsPerOp;
+    if (outputBytes > 0)
+    {
+      json["output_bytes"] = double(outputBytes);
+    }
+    return json;
+  }
+};
+
+// 测试运行器：至少运行minIterations次且总时间不少于minTimeMs
+class BenchRunner
+{
+public:
+  // 单次操作，返回输出字节数（没有输出时返回0）
+  using Operation = std::function<qint64()>;
+
+  BenchRunner(const QString& filter, int minTimeMs, int minIterations)
+    : m_filter(filter),
+      m_minTimeNs(qint64(minTimeMs) * 1000000),
+      m_minIterations(minIterations)
+  {
+  }
+
+  bool accepts(const QString& name) const
+  {
+    return m_filter.isEmpty() || name.contains(m_filter);
+  }
+
+  void run(const QString& name,
+           const SizeInfo& size,
+           const char* pattern,
+           double pixelsPerOp,
+           const Operation& operation)
+  {
+    if (!accepts(name))
+    {
+      return;
+    }
+
+    // 预热一次，排除首次分配缓冲区等一次性开销
+    qint64 outputBytes = operation();
+
+    const quint64 allocationsBefore = g_allocationCount.load(std::memory_order_relaxed);
+    QElapsedTimer timer;
+    timer.start();
+
+    quint64 iterations = 0;
+    while (iterations < quint64(m_minIterations) || timer.nsecsElapsed() < m_minTimeNs)
+    {
+      outputBytes = operation();
+      ++iterations;
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+    const quint64 allocations =
+        g_allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    BenchResult result;
+    result.name = name;
+    result.size = size.name;
+    result.pattern = pattern;
+    result.iterations = iterations;
+    result.nanosecondsPerOp = double(elapsed) / double(iterations);
+    result.pixelsPerOp = pixelsPerOp;
+    result.allocationsPerOp = double(allocations) / double(iterations);
+    result.outputBytes = outputBytes;
+    m_results.append(result.toJson());
+
+    fprintf(stderr,
+            "%-26s %-8s %-9s %12.0f ns/op %10.1f Mpx/s %8.1f allocs/op\n",
+            qPrintable(name),
+            size.name,
+            pattern,
+            result.nanosecondsPerOp,
+            result.toJson()["mpixels_per_s"].toDouble(),
+            result.allocationsPerOp);
+  }
+
+  const QJsonArray& results() const { return m_results; }
+
+private:
+  QString m_filter;
+  qint64 m_minTimeNs;
+  int m_minIterations;
+  QJsonArray m_results;
+};
+
+// 把图像编码到内存，返回编码后的字节数
+qint64 encodeImage(const QImage& image, const char* format)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+  QImageWriter writer(&buffer, format);
+  if (!writer.write(image))
+  {
+    qWarning() << "编码失败:" << format << writer.errorString();
+    return 0;
+  }
+  return buffer.size();
+}
+
+// 用并行编码器把图像编码到内存，返回编码后的字节数
+qint64 encodeImageParallel(const QImage& image, const char* format, ImageEncoder::Level level)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+  QString errorMessage;
+  if (!ImageEncoder::write(image, &buffer, format, level, -1, &errorMessage))
+  {
+    qWarning() << "编码失败:" << format << errorMessage;
+    return 0;
+  }
+  return buffer.size();
+}
+
+// 等待渲染器在后台生成变暗背景
+void waitForBackdrop(ScreenshotRenderer& renderer)
+{
+  while (!renderer.isBackdropReady())
+  {
+    QThread::msleep(1);
+    renderer.prepareFrame();
+  }
+}
+
+// 运行一个尺寸和图案组合的全部测试
+void runFrameBenchmarks(BenchRunner& runner,
+                        const SizeInfo& size,
+                        const PatternInfo& pattern,
+                        qreal devicePixelRatio)
+{
+  ScreenshotFrame::Ptr frame =
+      generateFrame(pattern.pattern, QSize(size.width, size.height), devicePixelRatio);
+  if (frame->isNull())
+  {
+    qWarning() << "合成帧内存分配失败:" << size.name;
+    return;
+  }
+
+  const QSize logicalSize = frame->logicalSize();
+  const QRect logicalRect(QPoint(0, 0), logicalSize);
+  const double framePixels = double(frame->width()) * frame->height();
+
+  // 选择区域：居中，占宽高的3/4
+  const QRect selection(logicalSize.width() / 8,
+                        logicalSize.height() / 8,
+                        logicalSize.width() * 3 / 4,
+                        logicalSize.height() * 3 / 4);
+  const QRect deviceSelection = frame->mapToDevice(selection);
+  const double selectionPixels = double(deviceSelection.width()) * deviceSelection.height();
+
+  // 渲染器
+  {
+    ScreenshotRenderer renderer(frame);
+    renderer.prepareFrame();
+    waitForBackdrop(renderer);
+
+    QImage pixels(frame->size(), ScreenshotFrameView::FORMAT);
+    runner.run("renderer.backdrop_blit",
+               size,
+               pattern.name,
+               framePixels,
+               [&]()
+               {
+                 renderer.blitBackdrop(
+                     pixels, pixels.rect(), QRegion(logicalRect), selection, true);
+                 return qint64(0);
+               });
+
+    QImage target(frame->size(), ScreenshotFrameView::FORMAT);
+    target.setDevicePixelRatio(devicePixelRatio);
+    runner.run("renderer.backdrop_painter",
+               size,
+               pattern.name,
+               framePixels,
+               [&]()
+               {
+                 QPainter painter(&target);
+                 renderer.drawBackdrop(painter, selection, true);
+                 return qint64(0);
+               });
+
+    // 放大镜沿对角线移动，每次都是新的位置
+    int step = 0;
+    const int magnifierSide = frame->mapToDevice(QRect(0, 0, 120, 120)).width();
+    runner.run("renderer.magnifier",
+               size,
+               pattern.name,
+               double(magnifierSide) * magnifierSide,
+               [&]()
+               {
+                 step = (step + 7) % qMin(logicalSize.width(), logicalSize.height());
+                 QPainter painter(&target);
+                 renderer.drawMagnifier(
+                     painter, QPoint(step, step), logicalSize.width(), logicalSize.height());
+                 return qint64(0);
+               });
+  }
+
+  // 覆盖层绘制（完整重绘和放大镜大小的局部重绘）
+  if (runner.accepts("overlay."))
+  {
+    // 单屏拓扑：覆盖层按屏幕几何设置窗口位置
+    DisplayTopology::Screen screen;
+    screen.name = "bench";
+    screen.geometry = logicalRect;
+    screen.devicePixelRatio = devicePixelRatio;
+    screen.deviceSize = frame->size();
+    ScreenshotFrameSet::Ptr frames =
+        ScreenshotFrameSet::create(DisplayTopology::fromScreens({screen}), {frame});
+
+    ScreenshotOverlay overlay(frames, 0);
+    overlay.setGeometry(logicalRect);
+    overlay.show();
+    QCoreApplication::processEvents();
+
+    runner.run("overlay.paint_full",
+               size,
+               pattern.name,
+               framePixels,
+               [&]()
+               {
+                 overlay.repaint();
+                 return qint64(0);
+               });
+
+    int step = 0;
+    const int partialRange = qMax(1, qMin(logicalSize.width(), logicalSize.height()) - 256);
+    const QRect partial = frame->mapToDevice(QRect(0, 0, 256, 256));
+    runner.run("overlay.paint_partial",
+               size,
+               pattern.name,
+               double(partial.width()) * partial.height(),
+               [&]()
+               {
+                 step = (step + 13) % partialRange;
+                 QMouseEvent move(QEvent::MouseMove,
+                                  QPointF(step, step),
+                                  overlay.mapToGlobal(QPointF(step, step)),
+                                  Qt::NoButton,
+                                  Qt::NoButton,
+                                  Qt::NoModifier);
+                 QCoreApplication::sendEvent(&overlay, &move);
+                 overlay.repaint(QRect(step, step, 256, 256));
+                 return qint64(0);
+               });
+
+    overlay.hide();
+
+    // 截图会话启动：从触发到第一帧绘制完成，比较随会话新建覆盖层和复用预先创建的覆盖层
+    // （两者都包含结束会话时隐藏窗口和保存指标的开销）
+    runner.run("overlay.session_cold",
+               size,
+               pattern.name,
+               framePixels,
+               [&]()
+               {
+                 ScreenshotOverlay coldOverlay(frames, 0);
+                 coldOverlay.show();
+                 coldOverlay.repaint();
+                 coldOverlay.endSession();
+                 return qint64(0);
+               });
+
+    ScreenshotOverlay pooledOverlay(frames->topology(), 0);
+    pooledOverlay.winId();
+    runner.run("overlay.session_warm",
+               size,
+               pattern.name,
+               framePixels,
+               [&]()
+               {
+                 pooledOverlay.beginSession(frames);
+                 pooledOverlay.show();
+                 pooledOverlay.repaint();
+                 pooledOverlay.endSession();
+                 return qint64(0);
+               });
+  }
+
+  // 裁剪和编码：processor.crop为零拷贝视图，processor.crop.copy为旧的整块复制，用于对比
+  ScreenshotProcessor processor(frame);
+  runner.run("processor.crop",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               QImage cropped = processor.cropScreenshot(selection);
+               return qint64(cropped.sizeInBytes());
+             });
+  runner.run("processor.crop.copy",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               QImage cropped = processor.cropScreenshot(selection).copy();
+               return qint64(cropped.sizeInBytes());
+             });
+
+  const QImage cropped = processor.cropScreenshot(selection);
+  runner.run("encode.png",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]() { return encodeImage(cropped, "png"); });
+  runner.run("encode.jpeg",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]() { return encodeImage(cropped, "jpeg"); });
+
+  // 并行编码器的各个等级（encode.png.balanced.serial为单线程，用于计算多核加速比）
+  for (ImageEncoder::Level level :
+       {ImageEncoder::Level::Fast, ImageEncoder::Level::Balanced, ImageEncoder::Level::Small})
+  {
+    for (const char* format : {"png", "jpeg"})
+    {
+      runner.run(QString("encode.%1.%2").arg(format, ImageEncoder::levelName(level)),
+                 size,
+                 pattern.name,
+                 selectionPixels,
+                 [&]() { return encodeImageParallel(cropped, format, level); });
+    }
+  }
+  ImageEncoder::setThreadCount(1);
+  runner.run("encode.png.balanced.serial",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]() { return encodeImageParallel(cropped, "png", ImageEncoder::Level::Balanced); });
+  ImageEncoder::setThreadCount(0);
+
+  // QOI与PNG对比：编码（encode.qoi）和解码回帧格式（decode.*）
+  runner.run("encode.qoi",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]() { return encodeImageParallel(cropped, "qoi", ImageEncoder::Level::Balanced); });
+
+  QByteArray pngData;
+  QByteArray qoiData;
+  {
+    QBuffer pngBuffer(&pngData);
+    pngBuffer.open(QIODevice::WriteOnly);
+    ImageEncoder::write(cropped, &pngBuffer, "png");
+    QBuffer qoiBuffer(&qoiData);
+    qoiBuffer.open(QIODevice::WriteOnly);
+    ImageEncoder::write(cropped, &qoiBuffer, "qoi");
+  }
+  runner.run("decode.png",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               QImage image = QImage::fromData(pngData, "png")
+                                  .convertToFormat(ScreenshotFrameView::FORMAT);
+               return qint64(image.sizeInBytes());
+             });
+  runner.run("decode.qoi",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               QBuffer buffer(&qoiData);
+               buffer.open(QIODevice::ReadOnly);
+               QImage image = QoiDecoder::read(&buffer, nullptr);
+               return qint64(image.sizeInBytes());
+             });
+
+  // 剪切板：放入剪切板只创建数据（clipboard.copy），后台裁剪并压缩（clipboard.compress），
+  // 粘贴时才按请求的格式编码（clipboard.paste.png）
+  runner.run("clipboard.copy",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               ClipboardMimeData mimeData([&]() { return processor.cropScreenshot(selection); });
+               return qint64(0);
+             });
+  QThreadPool::globalInstance()->waitForDone(); // 后台压缩引用了processor
+  runner.run("clipboard.compress",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               ClipboardMimeData mimeData([&]() { return processor.cropScreenshot(selection); });
+               mimeData.waitForCompressed();
+               return qint64(mimeData.compressedSize());
+             });
+  {
+    ClipboardMimeData mimeData([&]() { return processor.cropScreenshot(selection); });
+    mimeData.waitForCompressed();
+    runner.run("clipboard.paste.png",
+               size,
+               pattern.name,
+               selectionPixels,
+               [&]() { return qint64(mimeData.data("image/png").size()); });
+  }
+
+  // 导出流水线：GUI线程只提交任务（export.submit），裁剪、编码和写入在线程池中完成（export.png）
+  ExportManager exporter;
+  const QString exportPath = QDir::temp().absoluteFilePath("openCap_bench_export.png");
+  auto cropSelection = [&]() { return processor.cropScreenshot(selection); };
+  runner.run("export.submit",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               exporter.cancel(exporter.submit(cropSelection, exportPath));
+               return qint64(0);
+             });
+  exporter.waitForDone();
+
+  runner.run("export.png",
+             size,
+             pattern.name,
+             selectionPixels,
+             [&]()
+             {
+               exporter.submit(cropSelection, exportPath);
+               exporter.waitForDone();
+               return QFileInfo(exportPath).size();
+             });
+  QFile::remove(exportPath);
+}
+
+// 工具栏图标：逐个解析绘制SVG、映射磁盘上的图标图集，以及创建整个工具栏的耗时
+void runIconBenchmarks(BenchRunner& runner)
+{
+  const SizeInfo size = {"toolbar", 0, 0};
+  const QStringList names = IconAtlas::iconNames();
+  const QList<int> pixelSizes = IconAtlas::defaultPixelSizes();
+  const QString cachePath = QDir::temp().absoluteFilePath("openCap_bench_icon_atlas.bin");
+
+  runner.run("icons.svg",
+             size,
+             "white",
+             0.0,
+             [&]()
+             {
+               qint64 count = 0;
+               for (const QString& name : names)
+               {
+                 count += IconProvider::createWhiteSvgIcon(":/icons/" + name).isNull() ? 0 : 1;
+               }
+               return count;
+             });
+
+  // 预热时生成缓存，之后每次都是映射已有的缓存
+  runner.run("icons.atlas",
+             size,
+             "white",
+             0.0,
+             [&]()
+             {
+               IconAtlas atlas(cachePath, pixelSizes);
+               qint64 count = 0;
+               for (const QString& name : names)
+               {
+                 count += atlas.icon(name).isNull() ? 0 : 1;
+               }
+               return count;
+             });
+  QFile::remove(cachePath);
+
+  runner.run("icons.toolbar_create",
+             size,
+             "white",
+             0.0,
+             [&]()
+             {
+               ScreenshotToolbar toolbar;
+               toolbar.ensurePolished();
+               return qint64(0);
+             });
+}
+
+// 跟踪点：记录一个作用域区间的开销，以及导出整个环形缓冲区的耗时
+void runTraceBenchmarks(BenchRunner& runner)
+{
+  const SizeInfo size = {"ring", TraceRecorder::CAPACITY, 1};
+  TraceRecorder& trace = TraceRecorder::instance();
+
+  runner.run("trace.scope",
+             size,
+             "events",
+             1.0,
+             [&]()
+             {
+               TraceRecorder::Scope traceScope("bench", "scope");
+               return qint64(0);
+             });
+
+  // 先写满环形缓冲区，导出的是最大数量的事件
+  for (int i = 0; i < TraceRecorder::CAPACITY; ++i)
+  {
+    trace.instant("bench", "fill");
+  }
+  runner.run("trace.export",
+             size,
+             "events",
+             double(TraceRecorder::CAPACITY),
+             [&]() { return qint64(trace.toChromeJson().size()); });
+}
+
+// 屏幕采集：从采集请求到像素可读的耗时（需要真实的显示服务器，例如Xvfb）
+void runCaptureBenchmarks(BenchRunner& runner)
+{
+  QScreen* screen = QGuiApplication::primaryScreen();
+  if (!screen || QGuiApplication::platformName() == QLatin1String("offscreen"))
+  {
+    return;
+  }
+
+  const qreal devicePixelRatio = screen->devicePixelRatio();
+  const QRect deviceRect = ScreenshotFrame::mapToDevice(screen->geometry(), devicePixelRatio);
+  const SizeInfo size = {"screen", deviceRect.width(), deviceRect.height()};
+
+  // 所有屏幕的物理像素总数
+  const DisplayTopology::Ptr topology = DisplayTopology::current();
+  double desktopPixels = 0.0;
+  for (const DisplayTopology::Screen& info : topology->screens())
+  {
+    desktopPixels += double(info.deviceSize.width()) * info.deviceSize.height();
+  }
+  const QRect desktopRect = topology->virtualGeometry();
+  const SizeInfo desktopSize = {"desktop", desktopRect.width(), desktopRect.height()};
+
+  for (const char* backendName : {"qt", "x11shm"})
+  {
+    const QString name = QString("capture.%1").arg(backendName);
+    const QString allName = name + ".all";
+    const QString permissionName = name + ".permission";
+    if (!runner.accepts(name) && !runner.accepts(allName) && !runner.accepts(permissionName))
+    {
+      continue;
+    }
+
+    // 不可用时工厂会退回其他后端，此时跳过
+    std::unique_ptr<CaptureBackend> backend = CaptureBackend::create(backendName);
+    if (backend->name() != QLatin1String(backendName))
+    {
+      fprintf(stderr, "%-26s 不可用，跳过\n", qPrintable(name));
+      continue;
+    }
+
+    runner.run(name,
+               size,
+               "desktop",
+               double(size.width) * size.height,
+               [&]()
+               {
+                 // 读取首尾像素，确认像素已经可用
+                 ScreenshotFrame::Ptr frame = backend->captureScreen(screen);
+                 if (!frame || frame->isNull())
+                 {
+                   return qint64(0);
+                 }
+                 const QRgb first = frame->pixel(0, 0);
+                 const QRgb last = frame->pixel(frame->width() - 1, frame->height() - 1);
+                 return frame->byteCount() + qint64(first == last);
+               });
+
+    // 采集所有屏幕（后端支持时并发采集）
+    runner.run(allName,
+               desktopSize,
+               "desktop",
+               desktopPixels,
+               [&]()
+               {
+                 ScreenshotFrameSet::Ptr frames = backend->captureAll(topology);
+                 return frames ? frames->byteCount() : qint64(0);
+               });
+
+    // 启动时的权限检查（不使用缓存），与上面采集整个屏幕的旧方式对比
+    runner.run(permissionName,
+               size,
+               "desktop",
+               1.0,
+               [&]() { return qint64(backend->probePermission()); });
+  }
+}
+} // namespace
+
+// 基准测试程序入口
+int main(int argc, char* argv[])
+{
+  // 默认无界面运行，不需要显示服务器
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+  {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  // 覆盖层销毁时会保存帧指标，避免覆盖用户真实会话的指标文件
+  if (qEnvironmentVariableIsEmpty("OPENCAP_METRICS_FILE"))
+  {
+    qputenv("OPENCAP_METRICS_FILE",
+            QDir::temp().absoluteFilePath("openCap_bench_metrics.json").toLocal8Bit());
+  }
+
+  QApplication app(argc, argv);
+  app.setApplicationName("openCap_bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("openCap 热点路径基准测试");
+  parser.addHelpOption();
+  QCommandLineOption outputOption("output", "JSON结果输出文件（默认输出到标准输出）", "file");
+  QCommandLineOption filterOption("filter", "只运行名称包含该字符串的测试", "name");
+  QCommandLineOption sizeOption("size", "只运行指定尺寸：1080p、4k、8k、3x1080p", "size");
+  QCommandLineOption patternOption(
+      "pattern", "只运行指定图案：text、gradient、photo、noise", "pattern");
+  QCommandLineOption minTimeOption("min-time", "每项测试的最短运行时间（毫秒）", "ms", "500");
+  QCommandLineOption minIterationsOption("min-iterations", "每项测试的最少运行次数", "n", "3");
+  parser.addOptions(
+      {outputOption, filterOption, sizeOption, patternOption, minTimeOption, minIterationsOption});
+  parser.process(app);
+
+  // 调试输出会计入耗时并淹没结果，基准测试期间关闭
+  QLoggingCategory::setFilterRules("*.debug=false");
+
+  const qreal devicePixelRatio =
+      app.primaryScreen() ? app.primaryScreen()->devicePixelRatio() : 1.0;
+  BenchRunner runner(parser.value(filterOption),
+                     parser.value(minTimeOption).toInt(),
+                     qMax(1, parser.value(minIterationsOption).toInt()));
+
+  for (const SizeInfo& size : SIZES)
+  {
+    if (parser.isSet(sizeOption) && parser.value(sizeOption) != size.name)
+    {
+      continue;
+    }
+
+    for (const PatternInfo& pattern : PATTERNS)
+    {
+      if (parser.isSet(patternOption) && parser.value(patternOption) != pattern.name)
+      {
+        continue;
+      }
+
+      runFrameBenchmarks(runner, size, pattern, devicePixelRatio);
+    }
+  }
+
+  runIconBenchmarks(runner);
+  runTraceBenchmarks(runner);
+  runCaptureBenchmarks(runner);
+
+  QJsonObject report;
+  report["qt_version"] = qVersion();
+  report["platform"] = QGuiApplication::platformName();
+  report["device_pixel_ratio"] = devicePixelRatio;
+  report["threads"] = QThread::idealThreadCount();
+  report["allocation_counter"] = ALLOCATION_COUNTER;
+  report["results"] = runner.results();
+  const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+  if (!parser.isSet(outputOption))
+  {
+    fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    return 0;
+  }
+
+  QFile file(parser.value(outputOption));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qWarning() << "无法写入结果文件:" << file.fileName() << file.errorString();
+    return 1;
+  }
+  file.write(json);
+  return 0;
+}
@@ -5,11 +5,17 @@
 #include <QtWidgets/QApplication> // 包含Qt应用程序框架
 
 #include "screenshot/core/ScreenshotApp.h" // 包含截图应用程序头文件
+#include "utils/TraceRecorder.h"           // 包含跟踪记录器头文件
 
 // 应用程序主入口函数
 int main(int argc, char* argv[])
 {
-  QApplication app(argc, argv); // 创建Qt应用程序实例，传入命令行参数
+  TraceRecorder& trace = TraceRecorder::instance(); // 跟踪时钟从这里开始
+  trace.instant("startup", "main");
+
+  const qint64 appStart = TraceRecorder::now();
+  QApplication app(argc, argv);                             // 创建Qt应用程序实例，传入命令行参数
+  trace.complete("startup", "main.qapplication", appStart); // 记录Qt应用程序初始化耗时
 
   // 设置应用程序信息
   app.setApplicationName("截图工具");   // 设置应用程序名称
@@ -18,7 +24,9 @@ int main(int argc, char* argv[])
   app.setQuitOnLastWindowClosed(false); // 不在最后一个窗口关闭时退出应用程序
 
   // 创建并启动截图应用
-  ScreenshotApp screenshotApp; // 创建截图应用程序实例
+  const qint64 screenshotAppStart = TraceRecorder::now();
+  ScreenshotApp screenshotApp;                                          // 创建截图应用程序实例
+  trace.complete("startup", "main.screenshot_app", screenshotAppStart); // 记录构造耗时
 
   return app.exec(); // 启动Qt事件循环，程序在此处等待事件
 }
\ No newline at end of file
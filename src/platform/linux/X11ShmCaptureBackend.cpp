@@ -0,0 +1,385 @@
+#include "X11ShmCaptureBackend.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRect>
+#include <QScreen>
+#include <QThread>
+#include <atomic>
+#include <mutex>
+
+#include "../../screenshot/capture/QtCaptureBackend.h"
+#include "../../utils/PixelKernels.h"
+
+#ifdef OPENCAP_HAVE_XSHM
+  // X11头文件定义了None、Bool等宏，必须放在所有Qt头文件之后
+  #include <X11/Xlib.h>
+  #include <X11/Xutil.h>
+  #include <X11/extensions/XShm.h>
+  #include <sys/ipc.h>
+  #include <sys/shm.h>
+
+// 独立的X连接，所有Xlib调用都在互斥锁保护下进行
+struct X11ShmCaptureBackend::Connection
+{
+  Display* display = nullptr;
+  Window root = 0;
+  Visual* visual = nullptr;
+  int depth = 0;
+  std::mutex mutex;
+
+  ~Connection()
+  {
+    if (display)
+    {
+      XCloseDisplay(display);
+    }
+  }
+};
+
+// 共享内存段：持有连接的引用，后端销毁后仍被帧使用的段可以安全释放
+struct X11ShmCaptureBackend::Segment
+{
+  std::shared_ptr<Connection> connection;
+  XShmSegmentInfo info = {};
+  qsizetype size = 0;
+  std::atomic<bool> inUse{false};
+
+  ~Segment()
+  {
+    if (!connection)
+    {
+      return; // 创建失败的段没有附加到X服务器
+    }
+    std::lock_guard<std::mutex> lock(connection->mutex);
+    XShmDetach(connection->display, &info);
+    XSync(connection->display, False);
+    shmdt(info.shmaddr);
+  }
+};
+
+namespace
+{
+// X请求的错误是异步返回的，默认的错误处理函数会直接退出进程；
+// 附加共享内存段和采集期间临时捕获错误（例如远程X服务器无法共享内存、区域超出根窗口）
+bool g_requestFailed = false;
+
+int requestErrorHandler(Display*, XErrorEvent*)
+{
+  g_requestFailed = true;
+  return 0;
+}
+} // namespace
+
+// 构造函数：打开独立的X连接并检查MIT-SHM扩展和像素格式
+X11ShmCaptureBackend::X11ShmCaptureBackend() : m_connection(std::make_shared<Connection>())
+{
+  Display* display = XOpenDisplay(nullptr);
+  if (!display)
+  {
+    qWarning() << "无法连接X服务器";
+    return;
+  }
+  m_connection->display = display;
+
+  if (!XShmQueryExtension(display))
+  {
+    qWarning() << "X服务器不支持MIT-SHM扩展";
+    return;
+  }
+
+  // 只支持与QRgb内存布局一致的32位真彩色（0x??RRGGBB，字节序与本机相同）
+  const int screen = DefaultScreen(display);
+  Visual* visual = DefaultVisual(display, screen);
+  const int depth = DefaultDepth(display, screen);
+  const int byteOrder = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? LSBFirst : MSBFirst;
+  if ((depth != 24 && depth != 32) || visual->red_mask != 0xFF0000 ||
+      visual->green_mask != 0x00FF00 || visual->blue_mask != 0x0000FF ||
+      ImageByteOrder(display) != byteOrder)
+  {
+    qWarning() << "X服务器像素格式不兼容，深度:" << depth;
+    return;
+  }
+
+  m_connection->root = RootWindow(display, screen);
+  m_connection->visual = visual;
+  m_connection->depth = depth;
+}
+
+// 析构函数：仍被帧使用的共享内存段在帧释放时自行回收
+X11ShmCaptureBackend::~X11ShmCaptureBackend()
+{
+}
+
+// 是否可用
+bool X11ShmCaptureBackend::isValid() const
+{
+  return m_connection->visual != nullptr;
+}
+
+// 采集根窗口上对应屏幕（或区域）的像素
+ScreenshotFrame::Ptr X11ShmCaptureBackend::grab(QScreen* screen, const QRect& logicalRect)
+{
+  if (!isValid() || !screen)
+  {
+    return nullptr;
+  }
+
+  // 根窗口覆盖所有显示器，使用物理像素坐标：Qt的高DPI缩放不缩放屏幕左上角的位置，
+  // 只有屏幕内的坐标按设备像素比换算
+  const qreal dpr = screen->devicePixelRatio();
+  const QRect screenRect = screen->geometry();
+  const QRect localRect = QRect(QPoint(0, 0), screenRect.size());
+  QRect deviceRect = ScreenshotFrame::mapToDevice(localRect, dpr);
+  if (!logicalRect.isNull())
+  {
+    deviceRect = ScreenshotFrame::mapToDevice(logicalRect, dpr).intersected(deviceRect);
+  }
+  deviceRect.translate(screenRect.topLeft());
+  if (deviceRect.isEmpty())
+  {
+    return nullptr;
+  }
+
+  const qsizetype bytesPerLine = qsizetype(deviceRect.width()) * qsizetype(sizeof(QRgb));
+  std::shared_ptr<Segment> segment = acquireSegment(bytesPerLine * deviceRect.height());
+  if (!segment)
+  {
+    return grabWithFallback(screen, logicalRect);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_connection->mutex);
+    Display* display = m_connection->display;
+
+    // XImage只是描述共享内存的结构体，不分配像素
+    XImage* image = XShmCreateImage(display,
+                                    m_connection->visual,
+                                    unsigned(m_connection->depth),
+                                    ZPixmap,
+                                    segment->info.shmaddr,
+                                    &segment->info,
+                                    unsigned(deviceRect.width()),
+                                    unsigned(deviceRect.height()));
+    bool ok = image && image->bits_per_pixel == 32 && image->bytes_per_line == bytesPerLine;
+    if (ok)
+    {
+      g_requestFailed = false;
+      XErrorHandler previousHandler = XSetErrorHandler(requestErrorHandler);
+      ok = XShmGetImage(
+          display, m_connection->root, image, deviceRect.x(), deviceRect.y(), AllPlanes);
+      XSync(display, False);
+      XSetErrorHandler(previousHandler);
+      ok = ok && !g_requestFailed;
+    }
+    if (image)
+    {
+      // 像素属于共享内存段，销毁结构体前断开，避免被XDestroyImage释放
+      image->data = nullptr;
+      XDestroyImage(image);
+    }
+
+    if (!ok)
+    {
+      qWarning() << "XShmGetImage失败，区域:" << deviceRect;
+      segment->inUse.store(false);
+      return nullptr;
+    }
+  }
+
+  // 最高字节由X服务器决定，原地补齐alpha后即为帧格式，不需要转换
+  QRgb* pixels = reinterpret_cast<QRgb*>(segment->info.shmaddr);
+  PixelKernels::opaqueRow(pixels, qsizetype(deviceRect.width()) * deviceRect.height());
+
+  // 帧直接包装共享内存，最后一个引用释放时回收共享内存段
+  QImage image(reinterpret_cast<uchar*>(segment->info.shmaddr),
+               deviceRect.width(),
+               deviceRect.height(),
+               bytesPerLine,
+               ScreenshotFrameView::FORMAT,
+               &X11ShmCaptureBackend::releaseSegment,
+               new std::shared_ptr<Segment>(segment));
+  return ScreenshotFrame::fromImage(std::move(image), dpr);
+}
+
+// 取得空闲且足够大的共享内存段，没有时新建
+std::shared_ptr<X11ShmCaptureBackend::Segment> X11ShmCaptureBackend::acquireSegment(
+    qsizetype bytes)
+{
+  std::lock_guard<std::mutex> segmentLock(m_segmentMutex);
+  for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    bool expected = false;
+    if ((*it)->size >= bytes && (*it)->inUse.compare_exchange_strong(expected, true))
+    {
+      return *it;
+    }
+  }
+
+  // 段数已满时丢弃一个空闲但太小的段
+  if (int(m_segments.size()) >= MAX_SEGMENTS)
+  {
+    for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if (!(*it)->inUse.load())
+      {
+        m_segments.erase(it);
+        break;
+      }
+    }
+  }
+  if (int(m_segments.size()) >= MAX_SEGMENTS)
+  {
+    qWarning() << "共享内存段都在使用中";
+    return nullptr;
+  }
+
+  auto segment = std::make_shared<Segment>();
+  segment->connection = m_connection;
+  segment->size = bytes;
+  segment->info.shmid = shmget(IPC_PRIVATE, size_t(bytes), IPC_CREAT | 0600);
+  if (segment->info.shmid < 0)
+  {
+    qWarning() << "共享内存段创建失败，大小:" << bytes;
+    segment->connection = nullptr;
+    return nullptr;
+  }
+
+  segment->info.shmaddr = static_cast<char*>(shmat(segment->info.shmid, nullptr, 0));
+  segment->info.readOnly = False;
+  bool attached = segment->info.shmaddr != reinterpret_cast<char*>(-1);
+  if (attached)
+  {
+    std::lock_guard<std::mutex> lock(m_connection->mutex);
+    g_requestFailed = false;
+    XErrorHandler previousHandler = XSetErrorHandler(requestErrorHandler);
+    XShmAttach(m_connection->display, &segment->info);
+    XSync(m_connection->display, False);
+    XSetErrorHandler(previousHandler);
+    attached = !g_requestFailed;
+  }
+
+  // 标记删除：所有进程（包括X服务器）断开后系统自动回收
+  shmctl(segment->info.shmid, IPC_RMID, nullptr);
+
+  if (!attached)
+  {
+    qWarning() << "共享内存段附加失败";
+    if (segment->info.shmaddr != reinterpret_cast<char*>(-1))
+    {
+      shmdt(segment->info.shmaddr);
+    }
+    segment->info.shmaddr = nullptr;
+    segment->connection = nullptr;
+    return nullptr;
+  }
+
+  qDebug() << "共享内存段已创建，大小:" << bytes / 1024 << "KB";
+  segment->inUse.store(true);
+  m_segments.push_back(segment);
+  return segment;
+}
+
+// 共享内存段都被存活的帧占用时改用Qt后端采集（需要复制像素）
+ScreenshotFrame::Ptr X11ShmCaptureBackend::grabWithFallback(QScreen* screen,
+                                                            const QRect& logicalRect)
+{
+  // QScreen::grabWindow只能在GUI线程中调用；工作线程返回空指针，由captureAll在GUI线程中重试
+  if (QThread::currentThread() != QCoreApplication::instance()->thread())
+  {
+    return nullptr;
+  }
+
+  if (!m_fallback)
+  {
+    m_fallback = std::make_unique<QtCaptureBackend>();
+  }
+  qDebug() << "共享内存段都在使用中，使用Qt后端采集";
+  return m_fallback->captureRegion(screen, logicalRect);
+}
+
+// 帧释放时回收共享内存段（可能在任意线程调用）
+void X11ShmCaptureBackend::releaseSegment(void* info)
+{
+  auto* segment = static_cast<std::shared_ptr<Segment>*>(info);
+  (*segment)->inUse.store(false);
+  delete segment;
+}
+
+// XShmGetImage由X服务器串行处理，并发的收益来自补齐alpha和多个屏幕的请求重叠
+bool X11ShmCaptureBackend::supportsConcurrentCapture() const
+{
+  return true;
+}
+
+#else
+// 未找到libX11/libXext时的空实现
+struct X11ShmCaptureBackend::Connection
+{
+};
+
+struct X11ShmCaptureBackend::Segment
+{
+};
+
+X11ShmCaptureBackend::X11ShmCaptureBackend()
+{
+}
+
+X11ShmCaptureBackend::~X11ShmCaptureBackend()
+{
+}
+
+bool X11ShmCaptureBackend::isValid() const
+{
+  return false;
+}
+
+ScreenshotFrame::Ptr X11ShmCaptureBackend::grab(QScreen*, const QRect&)
+{
+  return nullptr;
+}
+
+ScreenshotFrame::Ptr X11ShmCaptureBackend::grabWithFallback(QScreen*, const QRect&)
+{
+  return nullptr;
+}
+
+std::shared_ptr<X11ShmCaptureBackend::Segment> X11ShmCaptureBackend::acquireSegment(qsizetype)
+{
+  return nullptr;
+}
+
+void X11ShmCaptureBackend::releaseSegment(void*)
+{
+}
+
+bool X11ShmCaptureBackend::supportsConcurrentCapture() const
+{
+  return false;
+}
+#endif
+
+// 后端名称
+QString X11ShmCaptureBackend::name() const
+{
+  return "x11shm";
+}
+
+// 原始像素格式（X服务器返回的32位RGB）
+QImage::Format X11ShmCaptureBackend::nativeFormat() const
+{
+  return QImage::Format_RGB32;
+}
+
+// 采集结果的设备像素比
+qreal X11ShmCaptureBackend::devicePixelRatio(QScreen* screen) const
+{
+  return screen ? screen->devicePixelRatio() : 1.0;
+}
+
+// X11没有屏幕录制权限，连接可用即可采集
+CaptureBackend::Permission X11ShmCaptureBackend::queryPermission(QScreen*)
+{
+  return isValid() ? Permission::Granted : Permission::Denied;
+}
@@ -0,0 +1,50 @@
+#ifndef X11SHMCAPTUREBACKEND_H
+#define X11SHMCAPTUREBACKEND_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../screenshot/capture/CaptureBackend.h"
+
+class QtCaptureBackend;
+
+// X11 MIT-SHM采集后端 - X服务器把帧缓冲区像素直接写入共享内存段，截图帧直接包装该内存，
+// 整个过程没有任何像素拷贝；共享内存段在帧释放后回收，供后续采集重复使用
+// 只有定义了OPENCAP_HAVE_XSHM（找到了libX11和libXext）时才可用
+class X11ShmCaptureBackend : public CaptureBackend
+{
+public:
+  X11ShmCaptureBackend();
+  ~X11ShmCaptureBackend() override;
+
+  // X服务器是否支持MIT-SHM且像素格式兼容（不可用时应改用其他后端）
+  bool isValid() const;
+
+  QString name() const override;
+  QImage::Format nativeFormat() const override;
+  qreal devicePixelRatio(QScreen* screen) const override;
+
+protected:
+  ScreenshotFrame::Ptr grab(QScreen* screen, const QRect& logicalRect) override;
+  bool supportsConcurrentCapture() const override;
+  Permission queryPermission(QScreen* screen) override;
+
+private:
+  struct Connection; // 独立的X连接（与Qt的连接互不影响，可在任意线程释放段）
+  struct Segment;    // 共享内存段
+
+  std::shared_ptr<Segment> acquireSegment(qsizetype bytes); // 取得空闲的共享内存段
+  static void releaseSegment(void* info);                   // 帧释放时回收共享内存段
+  // 共享内存段耗尽时改用Qt后端采集（只在GUI线程中，工作线程返回空指针）
+  ScreenshotFrame::Ptr grabWithFallback(QScreen* screen, const QRect& logicalRect);
+
+  std::shared_ptr<Connection> m_connection;
+  std::vector<std::shared_ptr<Segment>> m_segments;
+  std::mutex m_segmentMutex;                    // 保护m_segments（多个屏幕并发采集）
+  std::unique_ptr<QtCaptureBackend> m_fallback; // 共享内存段耗尽时使用的Qt后端（按需创建）
+
+  static constexpr int MAX_SEGMENTS = 8; // 同时存活的帧数上限（多屏时每个屏幕各占一个）
+};
+
+#endif // X11SHMCAPTUREBACKEND_H
@@ -0,0 +1,15 @@
+#ifndef MACSCREENCAPTUREPERMISSION_H // 防止头文件重复包含的宏定义开始
+#define MACSCREENCAPTUREPERMISSION_H // 定义头文件标识符
+
+// macOS屏幕录制权限查询类（只查询系统授权状态，不采集任何像素）
+class MacScreenCapturePermission
+{
+public:
+  // 是否已授予屏幕录制权限（不会弹出授权提示）
+  static bool isGranted();
+
+  // 请求屏幕录制权限：未授权时弹出系统提示（每个进程只会提示一次），返回当前是否已授权
+  static bool request();
+};
+
+#endif // MACSCREENCAPTUREPERMISSION_H   // 防止头文件重复包含的宏定义结束
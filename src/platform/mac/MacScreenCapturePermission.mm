@@ -0,0 +1,17 @@
+#include "MacScreenCapturePermission.h" // 包含macOS屏幕录制权限头文件
+#include <CoreGraphics/CoreGraphics.h>  // 包含CoreGraphics框架（屏幕录制权限接口）
+#include <QDebug>                       // 包含Qt调试输出功能
+
+// 是否已授予屏幕录制权限
+bool MacScreenCapturePermission::isGranted() {
+  return CGPreflightScreenCaptureAccess(); // 只读取授权状态，开销可以忽略
+}
+
+// 请求屏幕录制权限
+bool MacScreenCapturePermission::request() {
+  const bool granted = CGRequestScreenCaptureAccess(); // 未授权时系统弹出提示
+  if (!granted) {
+    qDebug() << "MacScreenCapturePermission: 已请求屏幕录制权限，授权后需要重新启动应用";
+  }
+  return granted;
+}
@@ -0,0 +1,192 @@
+#include "CaptureBackend.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <future>
+#include <vector>
+
+#include "../../platform/linux/X11ShmCaptureBackend.h"
+#include "../../utils/TraceRecorder.h"
+#include "QtCaptureBackend.h"
+#include "SyntheticCaptureBackend.h"
+
+// 构造函数
+CaptureBackend::CaptureBackend() : m_lastCaptureLatency(-1), m_permission(Permission::Unknown)
+{
+}
+
+// 析构函数
+CaptureBackend::~CaptureBackend()
+{
+}
+
+// 创建采集后端
+std::unique_ptr<CaptureBackend> CaptureBackend::create(const QString& spec)
+{
+  QString backendSpec = spec;
+  if (backendSpec.isEmpty())
+  {
+    backendSpec = qEnvironmentVariable("OPENCAP_CAPTURE_BACKEND");
+  }
+
+  // 后端名称之后可以带查询参数
+  const int queryStart = backendSpec.indexOf('?');
+  const QString backendName = backendSpec.left(queryStart).trimmed().toLower();
+  const QString query = queryStart >= 0 ? backendSpec.mid(queryStart + 1) : QString();
+
+  std::unique_ptr<CaptureBackend> backend;
+  if (backendName == "synthetic")
+  {
+    backend = std::make_unique<SyntheticCaptureBackend>(
+        SyntheticCaptureBackend::parseOptions(query));
+  }
+
+  // X11下默认优先使用MIT-SHM后端，不可用时退回Qt后端
+  const bool preferX11Shm =
+      backendName.isEmpty() && QGuiApplication::platformName() == QLatin1String("xcb");
+  if (!backend && (backendName == "x11shm" || preferX11Shm))
+  {
+    auto shmBackend = std::make_unique<X11ShmCaptureBackend>();
+    if (shmBackend->isValid())
+    {
+      backend = std::move(shmBackend);
+    }
+    else if (!preferX11Shm)
+    {
+      qWarning() << "X11 MIT-SHM采集后端不可用，使用Qt后端";
+    }
+  }
+
+  if (!backend)
+  {
+    if (!backendName.isEmpty() && backendName != "qt" && backendName != "x11shm")
+    {
+      qWarning() << "未知的采集后端:" << backendName << "，使用Qt后端";
+    }
+    backend = std::make_unique<QtCaptureBackend>();
+  }
+
+  qDebug() << "采集后端:" << backend->name();
+  return backend;
+}
+
+// 采集整个屏幕
+ScreenshotFrame::Ptr CaptureBackend::captureScreen(QScreen* screen)
+{
+  return captureRegion(screen, QRect());
+}
+
+// 采集屏幕内的区域
+ScreenshotFrame::Ptr CaptureBackend::captureRegion(QScreen* screen, const QRect& logicalRect)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  ScreenshotFrame::Ptr frame = grab(screen, logicalRect);
+
+  m_lastCaptureLatency = timer.nsecsElapsed();
+  qDebug() << name() << "采集耗时:" << m_lastCaptureLatency / 1000 << "us"
+           << "原始格式:" << nativeFormat();
+  return frame;
+}
+
+// 采集拓扑中的所有屏幕
+ScreenshotFrameSet::Ptr CaptureBackend::captureAll(const DisplayTopology::Ptr& topology)
+{
+  if (!topology || topology->isEmpty())
+  {
+    qWarning() << "没有可采集的屏幕";
+    return nullptr;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  const int count = topology->count();
+  std::vector<ScreenshotFrame::Ptr> frames(size_t(count));
+  if (count > 1 && supportsConcurrentCapture())
+  {
+    // 其余屏幕交给工作线程，第一个屏幕在当前线程采集，总耗时接近最慢的单个屏幕
+    std::vector<std::future<ScreenshotFrame::Ptr>> pending;
+    pending.reserve(size_t(count - 1));
+    for (int i = 1; i < count; ++i)
+    {
+      QScreen* screen = topology->screen(i).screen;
+      pending.push_back(std::async(std::launch::async,
+                                   [this, screen]()
+                                   {
+                                     TraceRecorder::Scope traceScope("capture", "grab_screen");
+                                     return grab(screen, QRect());
+                                   }));
+    }
+
+    {
+      TraceRecorder::Scope traceScope("capture", "grab_screen");
+      frames[0] = grab(topology->screen(0).screen, QRect());
+    }
+    for (int i = 1; i < count; ++i)
+    {
+      frames[size_t(i)] = pending[size_t(i - 1)].get();
+      if (!frames[size_t(i)])
+      {
+        // 后端的退回方式可能只能在当前线程中使用（例如共享内存段耗尽时改用Qt采集）
+        TraceRecorder::Scope traceScope("capture", "grab_screen_retry");
+        frames[size_t(i)] = grab(topology->screen(i).screen, QRect());
+      }
+    }
+  }
+  else
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      TraceRecorder::Scope traceScope("capture", "grab_screen");
+      frames[size_t(i)] = grab(topology->screen(i).screen, QRect());
+    }
+  }
+
+  m_lastCaptureLatency = timer.nsecsElapsed();
+  qDebug() << name() << "采集" << count << "个屏幕耗时:" << m_lastCaptureLatency / 1000 << "us"
+           << "并发:" << (count > 1 && supportsConcurrentCapture());
+  return ScreenshotFrameSet::create(topology, std::move(frames));
+}
+
+// 默认不支持并发采集
+bool CaptureBackend::supportsConcurrentCapture() const
+{
+  return false;
+}
+
+// 最近一次采集的耗时
+qint64 CaptureBackend::lastCaptureLatency() const
+{
+  return m_lastCaptureLatency;
+}
+
+// 屏幕录制权限（缓存）
+CaptureBackend::Permission CaptureBackend::permission()
+{
+  if (m_permission == Permission::Unknown)
+  {
+    m_permission = probePermission();
+  }
+  return m_permission;
+}
+
+// 重新检查屏幕录制权限
+CaptureBackend::Permission CaptureBackend::probePermission()
+{
+  return queryPermission(QGuiApplication::primaryScreen());
+}
+
+// 默认的权限检查：采集1x1像素，避免为了检查权限分配整个屏幕的帧
+CaptureBackend::Permission CaptureBackend::queryPermission(QScreen* screen)
+{
+  if (!screen)
+  {
+    return Permission::Unknown;
+  }
+
+  ScreenshotFrame::Ptr probe = grab(screen, QRect(0, 0, 1, 1));
+  return probe && !probe->isNull() ? Permission::Granted : Permission::Denied;
+}
@@ -0,0 +1,69 @@
+#ifndef CAPTUREBACKEND_H
+#define CAPTUREBACKEND_H
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <memory>
+
+#include "../core/DisplayTopology.h"
+#include "../core/ScreenshotFrame.h"
+#include "../core/ScreenshotFrameSet.h"
+
+class QScreen;
+
+// 截图采集后端接口 - 负责从屏幕（或替代数据源）获取像素并生成截图帧
+// 使用者只通过本接口采集，不直接调用平台API；每次采集的耗时由基类统一记录
+class CaptureBackend
+{
+public:
+  // 屏幕录制权限
+  enum class Permission
+  {
+    Unknown, // 尚未检查
+    Granted, // 已授权
+    Denied   // 未授权
+  };
+
+  virtual ~CaptureBackend();
+
+  // 创建采集后端：spec为空时读取环境变量OPENCAP_CAPTURE_BACKEND，未设置时使用Qt后端
+  // spec格式：qt | synthetic[?size=3840x2160&dpr=1.5&fps=60&source=图片文件或目录]
+  static std::unique_ptr<CaptureBackend> create(const QString& spec = QString());
+
+  // 采集整个屏幕，失败时返回空指针
+  ScreenshotFrame::Ptr captureScreen(QScreen* screen);
+  // 采集屏幕内的区域（相对于屏幕左上角的逻辑坐标），失败时返回空指针
+  ScreenshotFrame::Ptr captureRegion(QScreen* screen, const QRect& logicalRect);
+  // 采集拓扑中的所有屏幕：支持并发时每个屏幕一个工作线程，采集失败的屏幕在集合中为空指针
+  ScreenshotFrameSet::Ptr captureAll(const DisplayTopology::Ptr& topology);
+
+  // 最近一次采集的耗时（纳秒，captureAll为所有屏幕的总耗时），尚未采集时为-1
+  qint64 lastCaptureLatency() const;
+
+  // 屏幕录制权限：第一次调用时检查，结果在进程生命周期内缓存
+  Permission permission();
+  // 不使用缓存重新检查权限（优先使用平台查询，否则只采集主屏幕左上角的1x1像素）
+  Permission probePermission();
+
+  // 后端信息
+  virtual QString name() const = 0;                          // 后端名称
+  virtual QImage::Format nativeFormat() const = 0;           // 数据源的原始像素格式
+  virtual qreal devicePixelRatio(QScreen* screen) const = 0; // 采集结果的设备像素比
+
+protected:
+  CaptureBackend();
+
+  // 实际的采集操作：logicalRect为空矩形时采集整个屏幕
+  virtual ScreenshotFrame::Ptr grab(QScreen* screen, const QRect& logicalRect) = 0;
+  // 是否可以在多个线程中同时调用grab（默认不可以，在调用线程中逐个屏幕采集）
+  virtual bool supportsConcurrentCapture() const;
+  // 检查屏幕录制权限（默认采集屏幕左上角的1x1像素，能采集到即视为已授权）
+  virtual Permission queryPermission(QScreen* screen);
+
+private:
+  qint64 m_lastCaptureLatency; // 最近一次采集的耗时
+  Permission m_permission;     // 缓存的屏幕录制权限
+};
+
+#endif // CAPTUREBACKEND_H
@@ -0,0 +1,81 @@
+#include "QtCaptureBackend.h"
+
+#include <QDebug>
+#include <QPixmap>
+#include <QScreen>
+
+#ifdef Q_OS_MACOS
+#include "../../platform/mac/MacScreenCapturePermission.h"
+#endif
+
+// 构造函数
+QtCaptureBackend::QtCaptureBackend() : m_nativeFormat(QImage::Format_Invalid)
+{
+}
+
+// 后端名称
+QString QtCaptureBackend::name() const
+{
+  return "qt";
+}
+
+// 原始像素格式（由平台决定，采集之前未知）
+QImage::Format QtCaptureBackend::nativeFormat() const
+{
+  return m_nativeFormat;
+}
+
+// 采集结果的设备像素比
+qreal QtCaptureBackend::devicePixelRatio(QScreen* screen) const
+{
+  return screen ? screen->devicePixelRatio() : 1.0;
+}
+
+// 使用QScreen::grabWindow采集
+ScreenshotFrame::Ptr QtCaptureBackend::grab(QScreen* screen, const QRect& logicalRect)
+{
+  if (!screen)
+  {
+    qWarning() << "无法获取屏幕";
+    return nullptr;
+  }
+
+  QPixmap pixmap = logicalRect.isNull() ? screen->grabWindow(0)
+                                        : screen->grabWindow(0,
+                                                             logicalRect.x(),
+                                                             logicalRect.y(),
+                                                             logicalRect.width(),
+                                                             logicalRect.height());
+  if (pixmap.isNull())
+  {
+    qWarning() << "屏幕捕获失败！这可能是权限问题。";
+    qWarning() << "请在 系统偏好设置 > 安全性与隐私 > 隐私 > 屏幕录制 中添加此应用";
+    return nullptr;
+  }
+
+  // 取出图像后立即释放像素图，使图像成为唯一持有者，后续格式转换可以原地完成
+  QImage image = pixmap.toImage();
+  pixmap = QPixmap();
+  m_nativeFormat = image.format();
+
+  // 帧携带屏幕的设备像素比，确保显示时不会被放大
+  return ScreenshotFrame::fromImage(std::move(image), screen->devicePixelRatio());
+}
+
+// 检查屏幕录制权限：macOS直接查询系统授权状态（未授权的grabWindow仍会返回只有桌面背景的图像）
+CaptureBackend::Permission QtCaptureBackend::queryPermission(QScreen* screen)
+{
+#ifdef Q_OS_MACOS
+  Q_UNUSED(screen);
+  if (MacScreenCapturePermission::isGranted())
+  {
+    return Permission::Granted;
+  }
+
+  // 未授权时请求一次，系统会弹出授权提示并把应用加入屏幕录制列表
+  MacScreenCapturePermission::request();
+  return Permission::Denied;
+#else
+  return CaptureBackend::queryPermission(screen);
+#endif
+}
@@ -0,0 +1,25 @@
+#ifndef QTCAPTUREBACKEND_H
+#define QTCAPTUREBACKEND_H
+
+#include "CaptureBackend.h"
+
+// Qt采集后端 - 使用QScreen::grabWindow采集，所有平台可用
+// grabWindow和像素图只能在GUI线程中使用，多个屏幕逐个采集
+class QtCaptureBackend : public CaptureBackend
+{
+public:
+  QtCaptureBackend();
+
+  QString name() const override;
+  QImage::Format nativeFormat() const override;
+  qreal devicePixelRatio(QScreen* screen) const override;
+
+protected:
+  ScreenshotFrame::Ptr grab(QScreen* screen, const QRect& logicalRect) override;
+  Permission queryPermission(QScreen* screen) override;
+
+private:
+  QImage::Format m_nativeFormat; // 最近一次采集得到的原始格式
+};
+
+#endif // QTCAPTUREBACKEND_H
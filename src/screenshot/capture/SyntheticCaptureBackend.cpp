@@ -0,0 +1,199 @@
+#include "SyntheticCaptureBackend.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QThread>
+#include <QUrlQuery>
+#include <QtMath>
+
+#include "../../utils/PixelKernels.h"
+#include "../../utils/QoiCodec.h"
+
+// 构造函数：预先解码所有回放图片，采集时不再有解码开销
+SyntheticCaptureBackend::SyntheticCaptureBackend(const Options& options)
+  : m_options(options),
+    m_frameIndex(0)
+{
+  for (const QString& file : m_options.files)
+  {
+    // QOI直接解码为帧格式，不经过QImageReader
+    QString errorMessage;
+    QImage image = QFileInfo(file).suffix().compare("qoi", Qt::CaseInsensitive) == 0
+                       ? QoiDecoder::read(file, &errorMessage)
+                       : QImage(file);
+    if (image.isNull())
+    {
+      qWarning() << "无法读取回放图片:" << file << errorMessage;
+      continue;
+    }
+    m_images.push_back(image.convertToFormat(ScreenshotFrameView::FORMAT));
+  }
+
+  if (!m_options.files.isEmpty() && m_images.empty())
+  {
+    qWarning() << "没有可回放的图片，使用测试图案";
+  }
+
+  m_clock.start();
+}
+
+// 解析查询参数
+SyntheticCaptureBackend::Options SyntheticCaptureBackend::parseOptions(const QString& query)
+{
+  Options options;
+  const QUrlQuery params(query);
+
+  const QStringList size = params.queryItemValue("size").split('x');
+  if (size.size() == 2 && size[0].toInt() > 0 && size[1].toInt() > 0)
+  {
+    options.size = QSize(size[0].toInt(), size[1].toInt());
+  }
+
+  if (params.hasQueryItem("dpr") && params.queryItemValue("dpr").toDouble() > 0.0)
+  {
+    options.devicePixelRatio = params.queryItemValue("dpr").toDouble();
+  }
+
+  if (params.hasQueryItem("fps"))
+  {
+    options.framesPerSecond = qMax(0.0, params.queryItemValue("fps").toDouble());
+  }
+
+  // 数据源可以是单个图片文件，也可以是目录（按文件名顺序回放其中所有图片）
+  const QString source = params.queryItemValue("source", QUrl::FullyDecoded);
+  if (QFileInfo(source).isDir())
+  {
+    QStringList filters;
+    for (const QByteArray& format : QImageReader::supportedImageFormats())
+    {
+      filters << "*." + QString::fromLatin1(format);
+    }
+    filters << "*.qoi";
+
+    const QDir dir(source);
+    for (const QString& file : dir.entryList(filters, QDir::Files, QDir::Name))
+    {
+      options.files << dir.absoluteFilePath(file);
+    }
+  }
+  else if (!source.isEmpty())
+  {
+    options.files << source;
+  }
+
+  return options;
+}
+
+// 后端名称
+QString SyntheticCaptureBackend::name() const
+{
+  return "synthetic";
+}
+
+// 原始像素格式（回放图片和生成图案都已是帧格式）
+QImage::Format SyntheticCaptureBackend::nativeFormat() const
+{
+  return ScreenshotFrameView::FORMAT;
+}
+
+// 采集结果的设备像素比（与实际屏幕无关）
+qreal SyntheticCaptureBackend::devicePixelRatio(QScreen*) const
+{
+  return m_options.devicePixelRatio;
+}
+
+// 合成数据源不需要屏幕录制权限
+CaptureBackend::Permission SyntheticCaptureBackend::queryPermission(QScreen*)
+{
+  return Permission::Granted;
+}
+
+// 最近一次采集的帧序号
+quint64 SyntheticCaptureBackend::frameIndex() const
+{
+  return m_frameIndex.load();
+}
+
+// 各屏幕的采集互不影响，可以在工作线程中同时进行
+bool SyntheticCaptureBackend::supportsConcurrentCapture() const
+{
+  return true;
+}
+
+// 采集：等待下一帧，然后取出回放图片或生成图案
+ScreenshotFrame::Ptr SyntheticCaptureBackend::grab(QScreen*, const QRect& logicalRect)
+{
+  const quint64 index = waitForNextFrame();
+
+  QImage image = m_images.empty() ? generatePattern(index)
+                                  : m_images[size_t(index % m_images.size())];
+
+  // 区域采集只保留对应的物理像素
+  if (!logicalRect.isNull())
+  {
+    const QRect deviceRect = ScreenshotFrame::mapToDevice(logicalRect, m_options.devicePixelRatio);
+    image = image.copy(deviceRect.intersected(image.rect()));
+  }
+
+  return ScreenshotFrame::fromImage(std::move(image), m_options.devicePixelRatio);
+}
+
+// 等待下一帧产生：帧按固定间隔产生，采集总是得到当前时刻之后的第一帧，模拟与刷新同步的采集延迟
+quint64 SyntheticCaptureBackend::waitForNextFrame()
+{
+  if (m_options.framesPerSecond <= 0.0)
+  {
+    return ++m_frameIndex;
+  }
+
+  // 同时采集的多个屏幕读到相同的上一帧序号，得到同一帧
+  const qint64 interval = qMax<qint64>(1, qint64(1.0e9 / m_options.framesPerSecond));
+  const qint64 now = m_clock.nsecsElapsed();
+  quint64 previous = m_frameIndex.load();
+  const quint64 index = qMax(quint64(now / interval) + 1, previous + 1);
+  const qint64 wait = qint64(index) * interval - now;
+  if (wait > 0)
+  {
+    QThread::usleep(quint64(wait / 1000));
+  }
+  while (index > previous && !m_frameIndex.compare_exchange_weak(previous, index))
+  {
+  }
+  return index;
+}
+
+// 生成测试图案：静态渐变背景上叠加随帧序号移动的竖条和棋盘格，相同序号的帧像素完全相同
+QImage SyntheticCaptureBackend::generatePattern(quint64 index) const
+{
+  QImage image(m_options.size, ScreenshotFrameView::FORMAT);
+  if (image.isNull())
+  {
+    qWarning() << "测试图案内存分配失败，尺寸:" << m_options.size;
+    return image;
+  }
+
+  const int width = image.width();
+  const int height = image.height();
+  const int barWidth = qMax(1, width / 32);
+  const int barLeft = int((index * quint64(barWidth / 2 + 1)) % quint64(width));
+  const int barRight = qMin(width, barLeft + barWidth);
+  const int cell = qMax(1, height / 16);
+  const int shift = int(index % quint64(cell * 2));
+
+  for (int y = 0; y < height; ++y)
+  {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    const int green = y * 255 / height;
+    for (int x = 0; x < width; ++x)
+    {
+      // 棋盘格区域（左上角）和渐变背景
+      const bool checker = x < width / 4 && y < height / 4 && ((x + shift) / cell + y / cell) % 2;
+      line[x] = checker ? 0xFF202020 : qRgb(x * 255 / width, green, 160);
+    }
+    PixelKernels::fillRow(line + barLeft, 0xFFFFFFFF, barRight - barLeft);
+  }
+
+  return image;
+}
@@ -0,0 +1,52 @@
+#ifndef SYNTHETICCAPTUREBACKEND_H
+#define SYNTHETICCAPTUREBACKEND_H
+
+#include <QElapsedTimer>
+#include <QSize>
+#include <QStringList>
+#include <atomic>
+#include <vector>
+
+#include "CaptureBackend.h"
+
+// 合成采集后端 - 不访问屏幕，按指定帧率回放图片文件或生成确定性的测试图案
+// 无需显示器和录屏权限，用于无界面的端到端延迟和吞吐量测试
+class SyntheticCaptureBackend : public CaptureBackend
+{
+public:
+  // 后端参数
+  struct Options
+  {
+    QSize size = QSize(1920, 1080); // 帧尺寸（物理像素，回放图片时使用图片尺寸）
+    qreal devicePixelRatio = 1.0;   // 设备像素比
+    qreal framesPerSecond = 60.0;   // 新帧产生的速率，0表示不限速
+    QStringList files;              // 回放的图片文件，为空时生成测试图案
+  };
+
+  explicit SyntheticCaptureBackend(const Options& options);
+
+  // 解析查询参数：size=3840x2160&dpr=1.5&fps=60&source=图片文件或目录
+  static Options parseOptions(const QString& query);
+
+  QString name() const override;
+  QImage::Format nativeFormat() const override;
+  qreal devicePixelRatio(QScreen* screen) const override;
+
+  quint64 frameIndex() const; // 最近一次采集的帧序号
+
+protected:
+  ScreenshotFrame::Ptr grab(QScreen* screen, const QRect& logicalRect) override;
+  bool supportsConcurrentCapture() const override;
+  Permission queryPermission(QScreen* screen) override;
+
+private:
+  quint64 waitForNextFrame();                  // 等待下一帧产生，返回其序号
+  QImage generatePattern(quint64 index) const; // 生成指定序号的测试图案
+
+  Options m_options;
+  std::vector<QImage> m_images;      // 已解码的回放图片（预乘ARGB32）
+  QElapsedTimer m_clock;             // 帧时钟
+  std::atomic<quint64> m_frameIndex; // 最近一次采集的帧序号
+};
+
+#endif // SYNTHETICCAPTUREBACKEND_H
@@ -0,0 +1,197 @@
+#include "DisplayTopology.h"
+
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QtMath>
+
+#include "ScreenshotFrame.h"
+
+namespace
+{
+DisplayTopology::Ptr g_current; // 缓存的当前拓扑
+quint64 g_serial = 0;           // 最近一次创建的拓扑版本号
+bool g_watching = false;        // 是否已监听屏幕变化
+} // namespace
+
+// 构造函数
+DisplayTopology::DisplayTopology(std::vector<Screen> screens, int primaryIndex, quint64 serial)
+  : m_screens(std::move(screens)), m_primaryIndex(primaryIndex), m_serial(serial)
+{
+  for (const Screen& screen : m_screens)
+  {
+    m_virtualGeometry = m_virtualGeometry.united(screen.geometry);
+  }
+}
+
+// 当前拓扑
+DisplayTopology::Ptr DisplayTopology::current()
+{
+  if (g_current)
+  {
+    return g_current;
+  }
+
+  // 首次访问时开始监听屏幕增删，之后由信号使缓存失效
+  if (!g_watching)
+  {
+    g_watching = true;
+    QObject::connect(qApp,
+                     &QGuiApplication::screenAdded,
+                     qApp,
+                     [](QScreen* screen)
+                     {
+                       watchScreen(screen);
+                       invalidate();
+                     });
+    QObject::connect(qApp, &QGuiApplication::screenRemoved, qApp, []() { invalidate(); });
+    QObject::connect(qApp, &QGuiApplication::primaryScreenChanged, qApp, []() { invalidate(); });
+    for (QScreen* screen : QGuiApplication::screens())
+    {
+      watchScreen(screen);
+    }
+  }
+
+  const QList<QScreen*> qscreens = QGuiApplication::screens();
+  std::vector<Screen> screens;
+  screens.reserve(size_t(qscreens.size()));
+  int primaryIndex = -1;
+  for (QScreen* qscreen : qscreens)
+  {
+    Screen screen;
+    screen.screen = qscreen;
+    screen.name = qscreen->name();
+    screen.geometry = qscreen->geometry();
+    screen.devicePixelRatio = qscreen->devicePixelRatio();
+    screen.deviceSize =
+        ScreenshotFrame::mapToDevice(QRect(QPoint(0, 0), screen.geometry.size()),
+                                     screen.devicePixelRatio)
+            .size();
+    if (qscreen == QGuiApplication::primaryScreen())
+    {
+      primaryIndex = int(screens.size());
+    }
+    screens.push_back(screen);
+  }
+
+  g_current = fromScreens(std::move(screens), primaryIndex);
+
+  qDebug() << "显示器拓扑已更新，屏幕数:" << g_current->count()
+           << "虚拟桌面:" << g_current->virtualGeometry();
+  for (const Screen& screen : g_current->screens())
+  {
+    qDebug() << "  -" << screen.name << screen.geometry << "设备像素比:" << screen.devicePixelRatio
+             << "物理尺寸:" << screen.deviceSize;
+  }
+  return g_current;
+}
+
+// 由给定的屏幕列表创建拓扑
+DisplayTopology::Ptr DisplayTopology::fromScreens(std::vector<Screen> screens, int primaryIndex)
+{
+  if (primaryIndex < 0 || primaryIndex >= int(screens.size()))
+  {
+    primaryIndex = screens.empty() ? -1 : 0;
+  }
+  return Ptr(new DisplayTopology(std::move(screens), primaryIndex, ++g_serial));
+}
+
+// 是否没有屏幕
+bool DisplayTopology::isEmpty() const
+{
+  return m_screens.empty();
+}
+
+// 屏幕数量
+int DisplayTopology::count() const
+{
+  return int(m_screens.size());
+}
+
+// 获取屏幕信息
+const DisplayTopology::Screen& DisplayTopology::screen(int index) const
+{
+  return m_screens[size_t(index)];
+}
+
+// 获取全部屏幕
+const std::vector<DisplayTopology::Screen>& DisplayTopology::screens() const
+{
+  return m_screens;
+}
+
+// 主屏幕序号
+int DisplayTopology::primaryIndex() const
+{
+  return m_primaryIndex;
+}
+
+// 屏幕序号
+int DisplayTopology::indexOf(const QScreen* screen) const
+{
+  for (int i = 0; i < count(); ++i)
+  {
+    if (m_screens[size_t(i)].screen == screen)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// 逻辑点所在的屏幕
+int DisplayTopology::indexAt(const QPoint& logicalPos) const
+{
+  for (int i = 0; i < count(); ++i)
+  {
+    if (m_screens[size_t(i)].geometry.contains(logicalPos))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// 虚拟桌面的逻辑范围
+QRect DisplayTopology::virtualGeometry() const
+{
+  return m_virtualGeometry;
+}
+
+// 拓扑版本号
+quint64 DisplayTopology::serial() const
+{
+  return m_serial;
+}
+
+// 逻辑矩形换算为屏幕帧内的物理像素矩形
+QRect DisplayTopology::mapToDevice(int index, const QRect& logicalRect) const
+{
+  const Screen& target = screen(index);
+  return ScreenshotFrame::mapToDevice(logicalRect.translated(-target.geometry.topLeft()),
+                                      target.devicePixelRatio);
+}
+
+// 逻辑点所在的物理像素
+QPoint DisplayTopology::mapToDevice(int index, const QPoint& logicalPos) const
+{
+  const Screen& target = screen(index);
+  const QPoint local = logicalPos - target.geometry.topLeft();
+  return QPoint(qFloor(local.x() * target.devicePixelRatio),
+                qFloor(local.y() * target.devicePixelRatio));
+}
+
+// 丢弃缓存
+void DisplayTopology::invalidate()
+{
+  g_current.reset();
+}
+
+// 监听单个屏幕的几何和缩放比例变化
+void DisplayTopology::watchScreen(QScreen* screen)
+{
+  // 缩放比例变化时逻辑几何和逻辑DPI会随之变化
+  QObject::connect(screen, &QScreen::geometryChanged, qApp, []() { invalidate(); });
+  QObject::connect(screen, &QScreen::logicalDotsPerInchChanged, qApp, []() { invalidate(); });
+  QObject::connect(screen, &QScreen::physicalDotsPerInchChanged, qApp, []() { invalidate(); });
+}
@@ -0,0 +1,63 @@
+#ifndef DISPLAYTOPOLOGY_H
+#define DISPLAYTOPOLOGY_H
+
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QScreen;
+
+// 显示器拓扑 - 所有屏幕的逻辑几何和设备像素比的快照，创建后不可修改
+// 当前拓扑会被缓存，屏幕增删或几何、缩放比例变化后才重建，绘制和裁剪时不再逐次查询QScreen
+// 坐标约定：逻辑坐标为虚拟桌面坐标；物理像素坐标相对于各屏幕帧的左上角
+class DisplayTopology
+{
+public:
+  using Ptr = std::shared_ptr<const DisplayTopology>;
+
+  // 单个屏幕
+  struct Screen
+  {
+    QScreen* screen = nullptr;    // 对应的屏幕（仅用于采集，拓扑失效后不要再使用）
+    QString name;                 // 屏幕名称
+    QRect geometry;               // 逻辑几何（虚拟桌面坐标）
+    qreal devicePixelRatio = 1.0; // 设备像素比
+    QSize deviceSize;             // 物理像素尺寸
+  };
+
+  // 当前拓扑（只能在GUI线程调用），没有屏幕时返回空拓扑
+  static Ptr current();
+  // 由给定的屏幕列表创建拓扑（不依赖真实屏幕的场景使用）
+  static Ptr fromScreens(std::vector<Screen> screens, int primaryIndex = 0);
+
+  // 屏幕信息
+  bool isEmpty() const;
+  int count() const;
+  const Screen& screen(int index) const;
+  const std::vector<Screen>& screens() const;
+  int primaryIndex() const;                    // 主屏幕序号，没有屏幕时为-1
+  int indexOf(const QScreen* screen) const;    // 屏幕序号，不属于本拓扑时为-1
+  int indexAt(const QPoint& logicalPos) const; // 逻辑点所在的屏幕，不在任何屏幕内时为-1
+  QRect virtualGeometry() const;               // 虚拟桌面的逻辑范围
+  quint64 serial() const;                      // 拓扑版本号，每次重建加一
+
+  // 逻辑坐标换算为屏幕帧内的物理像素（按边取整，与ScreenshotFrame::mapToDevice一致）
+  QRect mapToDevice(int index, const QRect& logicalRect) const;
+  QPoint mapToDevice(int index, const QPoint& logicalPos) const; // 逻辑点所在的物理像素
+
+private:
+  DisplayTopology(std::vector<Screen> screens, int primaryIndex, quint64 serial);
+
+  static void invalidate(); // 丢弃缓存，下次访问时重建
+  static void watchScreen(QScreen* screen);
+
+  std::vector<Screen> m_screens; // 屏幕列表（与QGuiApplication::screens()顺序一致）
+  int m_primaryIndex;            // 主屏幕序号
+  QRect m_virtualGeometry;       // 虚拟桌面的逻辑范围
+  quint64 m_serial;              // 拓扑版本号
+};
+
+#endif // DISPLAYTOPOLOGY_H
@@ -0,0 +1,117 @@
+#include "FramePyramid.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <chrono>
+
+#include "../../utils/PixelKernels.h"
+
+// 构造函数
+FramePyramid::FramePyramid(ScreenshotFrame::Ptr frame)
+  : m_frame(std::move(frame)), m_started(false)
+{
+}
+
+// 获取指定级别的视图，缺少的级别在后台生成
+ScreenshotFrameView FramePyramid::level(int index, int* actualIndex)
+{
+  if (actualIndex)
+  {
+    *actualIndex = 0;
+  }
+  if (!m_frame || m_frame->isNull())
+  {
+    return ScreenshotFrameView();
+  }
+
+  index = qBound(0, index, MAX_LEVEL);
+  collect();
+  if (index > builtLevels() && !m_started)
+  {
+    // 8K截图的第1级也要缩小上亿字节，不能在绘制中同步生成
+    m_started = true;
+    m_future = std::async(std::launch::async, &FramePyramid::buildLevels, m_frame);
+  }
+
+  // 生成完成前（或帧太小无法继续缩小时）返回已有的最接近的级别
+  index = qMin(index, builtLevels());
+  if (actualIndex)
+  {
+    *actualIndex = index;
+  }
+  return index == 0 ? m_frame->view() : imageView(m_levels[index - 1]);
+}
+
+// 已生成的级别数量
+int FramePyramid::builtLevels() const
+{
+  return int(m_levels.size());
+}
+
+// 是否正在后台生成
+bool FramePyramid::isBuilding() const
+{
+  return m_future.valid();
+}
+
+// 收取后台生成的结果（不等待）
+void FramePyramid::collect()
+{
+  if (m_future.valid() &&
+      m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+  {
+    m_levels = m_future.get();
+  }
+}
+
+// 包装金字塔图像为视图
+ScreenshotFrameView FramePyramid::imageView(const QImage& image) const
+{
+  return ScreenshotFrameView(image.constBits(),
+                             image.width(),
+                             image.height(),
+                             image.bytesPerLine(),
+                             m_frame->devicePixelRatio());
+}
+
+// 逐级生成所有级别（在后台线程执行），每一级从上一级缩小
+std::vector<QImage> FramePyramid::buildLevels(ScreenshotFrame::Ptr frame)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  std::vector<QImage> levels;
+  ScreenshotFrameView source = frame->view();
+  while (int(levels.size()) < MAX_LEVEL && source.width() >= 2 && source.height() >= 2)
+  {
+    // 尺寸减半，奇数边的最后一行/列舍弃
+    const int width = source.width() / 2;
+    const int height = source.height() / 2;
+
+    QImage image(width, height, ScreenshotFrameView::FORMAT);
+    if (image.isNull())
+    {
+      qWarning() << "帧金字塔内存分配失败，级别:" << levels.size() + 1;
+      break;
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+      PixelKernels::downsampleRow(source.row(y * 2),
+                                  source.row(y * 2 + 1),
+                                  reinterpret_cast<QRgb*>(image.scanLine(y)),
+                                  width);
+    }
+    levels.push_back(std::move(image));
+
+    const QImage& last = levels.back();
+    source = ScreenshotFrameView(last.constBits(),
+                                 last.width(),
+                                 last.height(),
+                                 last.bytesPerLine(),
+                                 frame->devicePixelRatio());
+  }
+
+  qDebug() << "帧金字塔已生成" << levels.size() << "个级别，耗时:" << timer.elapsed() << "ms";
+  return levels;
+}
@@ -0,0 +1,40 @@
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include <QImage>
+#include <future>
+#include <vector>
+
+#include "ScreenshotFrame.h"
+
+// 截图帧金字塔 - 逐级2x2缩小的帧副本，供放大镜的缩小预览使用
+// 第一次请求缩小级别时在后台线程生成所有级别，生成完成前返回原始帧，之后一直复用
+class FramePyramid
+{
+public:
+  explicit FramePyramid(ScreenshotFrame::Ptr frame);
+
+  // 获取指定级别的视图（只在GUI线程中调用），第0级为原始帧，第n级的尺寸为原始帧的 1/2^n
+  // 请求的级别尚未生成时返回已有的最接近的级别；actualIndex写入实际返回的级别，可以为空
+  ScreenshotFrameView level(int index, int* actualIndex = nullptr);
+
+  // 已生成的级别数量（不含第0级）
+  int builtLevels() const;
+  // 是否正在后台生成
+  bool isBuilding() const;
+
+  // 最大支持的级别
+  static constexpr int MAX_LEVEL = 5;
+
+private:
+  void collect();                                                   // 收取后台生成的结果
+  ScreenshotFrameView imageView(const QImage& image) const;         // 包装金字塔图像为视图
+  static std::vector<QImage> buildLevels(ScreenshotFrame::Ptr frame); // 生成所有级别（后台线程）
+
+  ScreenshotFrame::Ptr m_frame;              // 原始帧（第0级）
+  std::vector<QImage> m_levels;              // 第1级起的缩小图像
+  std::future<std::vector<QImage>> m_future; // 后台生成任务
+  bool m_started;                            // 是否已经启动过生成（只启动一次）
+};
+
+#endif // FRAMEPYRAMID_H
@@ -1,23 +1,47 @@
 #include "ScreenshotApp.h" // 包含截图应用程序头文件
 
 #include <QApplication>   // 包含Qt应用程序框架
+#include <QCursor>        // 包含Qt光标功能
 #include <QDateTime>      // 包含Qt日期时间功能
 #include <QDebug>         // 包含Qt调试输出功能
 #include <QDir>           // 包含Qt目录操作功能
+#include <QElapsedTimer>  // 包含Qt高精度计时器
+#include <QFile>          // 包含Qt文件操作功能
 #include <QFileDialog>    // 包含Qt文件对话框功能
 #include <QFileInfo>      // 包含Qt文件信息功能
-#include <QPixmap>        // 包含Qt像素图类
+#include <QJsonDocument>  // 包含Qt JSON文档
 #include <QScreen>        // 包含Qt屏幕相关功能
 #include <QStandardPaths> // 包含Qt标准路径功能
 #include <QTimer>         // 包含Qt定时器功能
 
+#include "../../utils/TraceRecorder.h"         // 包含跟踪记录器头文件
+#include "../capture/CaptureBackend.h"         // 包含截图采集后端头文件
+#include "../managers/ExportManager.h"         // 包含导出管理器头文件
+#include "../managers/SelectionManager.h"      // 包含选择区域管理器头文件
 #include "../platform/mac/MacGlobalShortcut.h" // 包含全局快捷键头文件
 #include "../system/SystemTray.h"              // 包含系统托盘头文件
 #include "ScreenshotOverlay.h"                 // 包含截图覆盖层头文件
 
 // 截图应用程序构造函数
-ScreenshotApp::ScreenshotApp(QObject* parent) : QObject(parent) // 调用基类构造函数
+ScreenshotApp::ScreenshotApp(QObject* parent)
+  : QObject(parent),            // 调用基类构造函数
+    m_globalShortcut(nullptr),  // 初始化全局快捷键为nullptr
+    m_overlayPoolEnabled(true), // 默认复用预先创建的覆盖窗口
+    m_sessionActive(false),     // 初始化会话状态
+    m_startupPhaseStart(0)      // 第一个启动阶段从构造开始
 {
+  m_startupTimer.start(); // 开始记录启动耗时
+
+  // OPENCAP_OVERLAY_POOL=0时每次截图重新创建覆盖窗口（用于对比启动延迟）
+  if (qEnvironmentVariableIsSet("OPENCAP_OVERLAY_POOL"))
+  {
+    m_overlayPoolEnabled = qEnvironmentVariableIntValue("OPENCAP_OVERLAY_POOL") != 0;
+  }
+
+  // 创建截图采集后端（可通过OPENCAP_CAPTURE_BACKEND切换为合成后端）
+  m_captureBackend = CaptureBackend::create();
+  markStartupPhase("capture_backend");
+
   // 创建系统托盘
   m_systemTray = std::make_unique<SystemTray>(this); // 使用智能指针创建系统托盘对象
 
@@ -30,6 +54,49 @@ ScreenshotApp::ScreenshotApp(QObject* parent) : QObject(parent) // 调用基类
           &SystemTray::exitRequested, // 连接退出请求信号
           this,
           &ScreenshotApp::exitApplication); // 到退出应用程序槽函数
+  connect(m_systemTray.get(),
+          &SystemTray::traceExportRequested, // 连接导出跟踪数据信号
+          this,
+          &ScreenshotApp::exportTrace); // 到导出跟踪数据槽函数
+  markStartupPhase("system_tray");
+
+  // 导出在后台完成，失败时通过托盘通知（覆盖窗口早已关闭）
+  connect(&ExportManager::shared(),
+          &ExportManager::exportFailed, // 连接导出失败信号
+          this,
+          [this](int, const QString& errorMessage)
+          {
+            m_systemTray->showMessage("截图工具",
+                                      QString("保存截图失败: %1").arg(errorMessage),
+                                      QSystemTrayIcon::Warning);
+          });
+  connect(&ExportManager::shared(),
+          &ExportManager::progressChanged, // 连接导出进度信号
+          this,
+          [this](int, int percent)
+          {
+            m_systemTray->setToolTip(QString("截图工具 - 正在保存截图 %1%（剩余%2个）")
+                                         .arg(percent)
+                                         .arg(ExportManager::shared().pendingCount()));
+            m_systemTray->setExportInProgress(true);
+          });
+  connect(m_systemTray.get(),
+          &SystemTray::exportCancelRequested, // 连接取消保存信号
+          &ExportManager::shared(),
+          &ExportManager::cancelAll); // 到取消所有导出槽函数
+
+  // 所有导出结束后恢复托盘提示
+  auto restoreToolTip = [this]()
+  {
+    if (ExportManager::shared().pendingCount() == 0)
+    {
+      m_systemTray->setToolTip("截图工具");
+      m_systemTray->setExportInProgress(false);
+    }
+  };
+  connect(&ExportManager::shared(), &ExportManager::exportFinished, this, restoreToolTip);
+  connect(&ExportManager::shared(), &ExportManager::exportFailed, this, restoreToolTip);
+  connect(&ExportManager::shared(), &ExportManager::exportCancelled, this, restoreToolTip);
 
   // 创建全局快捷键 Cmd+Shift+A
   m_globalShortcut = new MacGlobalShortcut(this);
@@ -47,9 +114,11 @@ ScreenshotApp::ScreenshotApp(QObject* parent) : QObject(parent) // 调用基类
   {
     qWarning() << "全局快捷键注册失败";
   }
+  markStartupPhase("global_shortcut");
 
-  // 检查屏幕录制权限
-  checkScreenRecordingPermission();
+  // 事件循环启动后预先创建覆盖窗口并检查屏幕录制权限，不阻塞托盘图标的显示
+  QTimer::singleShot(0, this, &ScreenshotApp::warmOverlayPool);
+  QTimer::singleShot(0, this, &ScreenshotApp::checkScreenRecordingPermission);
 }
 
 // 析构函数，清理资源
@@ -67,59 +136,105 @@ ScreenshotApp::~ScreenshotApp()
 // 开始截图操作
 void ScreenshotApp::startScreenshot()
 {
+  // 触发时刻，覆盖层第一帧绘制完成时记录启动延迟
+  QElapsedTimer trigger;
+  trigger.start();
+  TraceRecorder::Scope traceScope("session", "start_screenshot");
+
   qDebug() << "开始截图模式"; // 输出调试信息
 
-  // 如果已经有覆盖窗口在运行，取消当前截图而不是启动新的
-  if (m_screenshotOverlay) // 检查是否存在截图覆盖窗口
+  // 如果已经有截图会话在进行，忽略本次请求
+  if (m_sessionActive) // 检查是否存在截图会话
   {
     return;
   }
 
-  // 先捕获全屏
+  // 先并发捕获所有屏幕
   m_fullScreenCapture = captureFullScreen(); // 调用捕获全屏方法
 
-  if (m_fullScreenCapture.isNull()) // 检查截图是否成功
+  if (!m_fullScreenCapture) // 检查截图是否成功
   {
     qWarning() << "无法捕获屏幕"; // 输出警告信息
-    return;                       // 直接返回
+    if (m_captureBackend->permission() == CaptureBackend::Permission::Denied)
+    {
+      qWarning() << "屏幕录制权限未授权，请手动授权";
+    }
+    return; // 直接返回
   }
 
-  qDebug() << "屏幕捕获完成，开始创建覆盖窗口"; // 输出调试信息
+  // 复用预先创建的覆盖窗口；显示器拓扑变化后（或未启用复用时）重新创建
+  const DisplayTopology::Ptr& topology = m_fullScreenCapture->topology();
+  if (m_overlays.empty() || m_overlays.front()->topology() != topology)
+  {
+    qDebug() << "屏幕捕获完成，开始创建覆盖窗口"; // 输出调试信息
+    destroyOverlays();
+    createOverlays(topology);
+  }
 
-  // 创建截图覆盖窗口
-  m_screenshotOverlay =
-      std::make_unique<ScreenshotOverlay>(m_fullScreenCapture); // 创建覆盖窗口对象
+  // 每个屏幕一个覆盖窗口，各自只绘制本屏幕的帧；选择区域在所有覆盖窗口之间共享
+  std::vector<ScreenshotOverlay*> sessionOverlays;
+  for (const auto& overlay : m_overlays)
+  {
+    if (!m_fullScreenCapture->frame(overlay->screenIndex())) // 跳过采集失败的屏幕
+    {
+      qWarning() << "屏幕采集失败，不显示覆盖窗口:" << overlay->screenIndex(); // 输出警告信息
+      continue;
+    }
 
-  // 连接信号
-  connect(m_screenshotOverlay.get(),
-          &ScreenshotOverlay::screenshotFinished, // 连接截图完成信号
-          this,
-          &ScreenshotApp::onScreenshotFinished); // 到截图完成处理函数
-  connect(m_screenshotOverlay.get(),
-          &ScreenshotOverlay::screenshotCancelled, // 连接截图取消信号
-          this,
-          &ScreenshotApp::onScreenshotCancelled); // 到截图取消处理函数
+    overlay->beginSession(m_fullScreenCapture, trigger); // 更换截图帧并清除上一次会话的状态
+    sessionOverlays.push_back(overlay.get());
+  }
 
-  qDebug() << "显示覆盖窗口（不创建新桌面）"; // 输出调试信息
+  if (sessionOverlays.empty()) // 检查是否有可显示的覆盖窗口
+  {
+    m_fullScreenCapture.reset(); // 释放截图帧
+    return;                      // 直接返回
+  }
+  m_sessionActive = true;
 
-  // 显示覆盖窗口 - 使用show()而不是showFullScreen()避免创建新桌面
-  m_screenshotOverlay->show(); // 显示覆盖窗口
+  qDebug() << "显示覆盖窗口（不创建新桌面），数量:" << sessionOverlays.size(); // 输出调试信息
 
-  // 立即提升窗口层级
-  // m_screenshotOverlay->raise();          // 提升窗口到最前
-  // m_screenshotOverlay->activateWindow(); // 激活窗口
+  // 显示覆盖窗口 - 使用show()而不是showFullScreen()避免创建新桌面
+  for (ScreenshotOverlay* overlay : sessionOverlays)
+  {
+    overlay->show(); // 显示覆盖窗口
+  }
 
   qDebug() << "窗口显示完成，延迟提升层级"; // 输出调试信息
 
-  // 延迟提升窗口层级以确保覆盖状态栏
+  // 延迟提升窗口层级以确保覆盖状态栏，最后由鼠标所在屏幕的覆盖窗口持有焦点
+  const qint64 windowLevelScheduled = TraceRecorder::now();
   QTimer::singleShot(50,
-                     m_screenshotOverlay.get(),
-                     [this]() // 延迟50毫秒执行
+                     this,
+                     [this, windowLevelScheduled]() // 延迟50毫秒执行
                      {
-                       if (m_screenshotOverlay) // 检查窗口是否仍然存在
+                       TraceRecorder::instance().complete(
+                           "session", "window_level_delay", windowLevelScheduled);
+                       if (!m_sessionActive) // 检查会话是否仍在进行
+                       {
+                         return;
+                       }
+
+                       TraceRecorder::Scope traceScope("session", "set_window_level");
+                       qDebug() << "执行延迟窗口层级提升"; // 输出调试信息
+                       const int cursorScreen =
+                           m_fullScreenCapture->topology()->indexAt(QCursor::pos());
+                       ScreenshotOverlay* focusOwner = nullptr;
+                       for (const auto& overlay : m_overlays)
                        {
-                         qDebug() << "执行延迟窗口层级提升";    // 输出调试信息
-                         m_screenshotOverlay->setWindowLevel(); // 设置窗口层级
+                         if (!overlay->isVisible()) // 跳过本次会话未显示的覆盖窗口
+                         {
+                           continue;
+                         }
+                         overlay->setWindowLevel(); // 设置窗口层级
+                         if (!focusOwner || overlay->screenIndex() == cursorScreen)
+                         {
+                           focusOwner = overlay.get();
+                         }
+                       }
+                       for (const auto& overlay : m_overlays)
+                       {
+                         overlay->setFocusOwner(overlay.get() == focusOwner);
                        }
                      });
 }
@@ -128,6 +243,12 @@ void ScreenshotApp::startScreenshot()
 void ScreenshotApp::exitApplication()
 {
   qDebug() << "退出应用程序"; // 输出调试信息
+
+  // 指定了跟踪文件时退出前自动导出
+  if (qEnvironmentVariableIsSet("OPENCAP_TRACE_FILE"))
+  {
+    exportTrace();
+  }
   QApplication::quit();       // 退出Qt应用程序
 }
 
@@ -136,23 +257,16 @@ void ScreenshotApp::onScreenshotFinished(const QRect& region)
 {
   qDebug() << "截图完成，区域:" << region; // 输出截图区域信息
 
-  // 先裁剪并保存截图数据，避免覆盖层关闭后数据丢失
-  QPixmap croppedPixmap = cropScreenshot(region); // 裁剪截图
+  // 导出任务持有截图帧，覆盖窗口可以立即关闭；关闭后也不会阻止文件对话框
+  ScreenshotFrameSet::Ptr frames = m_fullScreenCapture;
+  closeOverlays();
+  m_fullScreenCapture.reset();
 
-  // 安全关闭覆盖窗口，避免系统级别窗口阻止文件对话框
-  if (m_screenshotOverlay) // 检查窗口是否存在
+  // 确定按钮已复制到剪切板（区域为空），不需要保存
+  if (!region.isEmpty())
   {
-    qDebug() << "正在关闭截图窗口"; // 输出调试信息
-    m_screenshotOverlay->close();   // 关闭窗口
-    m_screenshotOverlay.reset();    // 重置智能指针，释放资源
+    saveScreenshotWithDialog(frames, region); // 选择保存位置后在后台裁剪和编码
   }
-
-  // 保存截图
-  saveScreenshotWithDialog(croppedPixmap); // 调用保存截图方法
-
-  // 释放全屏截图内存（截图完成后不再需要）
-  m_fullScreenCapture = QPixmap();
-  qDebug() << "已释放全屏截图内存"; // 输出调试信息
 }
 
 // 处理截图取消事件
@@ -161,98 +275,270 @@ void ScreenshotApp::onScreenshotCancelled()
   qDebug() << "截图已取消"; // 输出调试信息
 
   // 安全关闭覆盖窗口
-  if (m_screenshotOverlay) // 检查窗口是否存在
+  closeOverlays();
+
+  // 释放全屏截图帧（截图取消后不再需要）
+  m_fullScreenCapture.reset();
+  qDebug() << "已释放全屏截图内存"; // 输出调试信息
+}
+
+// 某个屏幕的覆盖层修改了共享的选择区域，通知其他屏幕的覆盖层
+void ScreenshotApp::onSelectionChanged()
+{
+  for (const auto& overlay : m_overlays)
   {
-    qDebug() << "正在关闭截图窗口"; // 输出调试信息
-    m_screenshotOverlay->close();   // 关闭窗口
-    m_screenshotOverlay.reset();    // 重置智能指针，释放资源
+    if (overlay.get() != sender())
+    {
+      overlay->syncSelection();
+    }
   }
+}
 
-  // 释放全屏截图内存（截图取消后不再需要）
-  m_fullScreenCapture = QPixmap();
-  qDebug() << "已释放全屏截图内存"; // 输出调试信息
+// 鼠标进入某个屏幕的覆盖层，由该覆盖层接收键盘输入
+void ScreenshotApp::onOverlayPointerEntered()
+{
+  for (const auto& overlay : m_overlays)
+  {
+    overlay->setFocusOwner(overlay.get() == sender());
+  }
+}
+
+// 结束截图会话，隐藏所有屏幕的覆盖窗口
+void ScreenshotApp::closeOverlays()
+{
+  if (!m_sessionActive) // 检查会话是否在进行
+  {
+    return;
+  }
+  m_sessionActive = false;
+
+  qDebug() << "正在关闭截图窗口"; // 输出调试信息
+  for (const auto& overlay : m_overlays)
+  {
+    overlay->endSession(); // 隐藏窗口并释放截图帧
+  }
+
+  // 未启用复用时释放覆盖窗口；显示器拓扑已变化时趁空闲重新预先创建，不占用下一次截图的时间
+  if (!m_overlayPoolEnabled)
+  {
+    destroyOverlays();
+  }
+  else if (!m_overlays.empty() && m_overlays.front()->topology() != DisplayTopology::current())
+  {
+    destroyOverlays();
+    warmOverlayPool();
+  }
 }
 
-// 捕获全屏截图
-QPixmap ScreenshotApp::captureFullScreen()
+// 预先创建所有屏幕的覆盖窗口：管理器、工具栏（图标和样式表）和原生窗口都在截图前准备好
+void ScreenshotApp::warmOverlayPool()
 {
-  // 获取主屏幕
-  QScreen* primaryScreen = QApplication::primaryScreen(); // 获取主屏幕对象
-  if (!primaryScreen)                                     // 检查屏幕是否存在
+  markStartupPhase("event_loop"); // 构造结束到事件循环第一次空闲（托盘图标显示等）
+
+  if (!m_overlayPoolEnabled || m_sessionActive || !m_overlays.empty())
   {
-    qWarning() << "无法获取主屏幕"; // 输出警告信息
-    return QPixmap();               // 返回空像素图
+    return;
   }
 
-  // 捕获整个屏幕
-  QPixmap screenshot = primaryScreen->grabWindow(0); // 捕获整个屏幕内容
+  QElapsedTimer timer;
+  timer.start();
+  createOverlays(DisplayTopology::current());
+  markStartupPhase("overlay_pool");
+  qDebug() << "覆盖窗口已预先创建，数量:" << m_overlays.size()
+           << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms"; // 输出调试信息
+}
 
-  if (screenshot.isNull()) // 检查截图是否成功
+// 为显示器拓扑中的每个屏幕创建隐藏的覆盖窗口
+void ScreenshotApp::createOverlays(const DisplayTopology::Ptr& topology)
+{
+  TraceRecorder::Scope traceScope("overlay", "create_overlays");
+
+  if (topology->isEmpty()) // 检查屏幕是否存在
   {
-    qWarning() << "屏幕捕获失败！这可能是权限问题。";                                // 输出警告信息
-    qWarning() << "请在 系统偏好设置 > 安全性与隐私 > 隐私 > 屏幕录制 中添加此应用"; // 输出权限提示
+    qWarning() << "无法获取屏幕"; // 输出警告信息
+    return;                       // 直接返回
   }
-  else // 截图成功
+
+  m_selectionManager = std::make_unique<SelectionManager>();
+  for (int i = 0; i < topology->count(); ++i)
   {
-    qDebug() << "屏幕捕获成功，尺寸:" << screenshot.size(); // 输出截图尺寸信息
-    // 设置正确的设备像素比，确保显示时不会被放大
-    screenshot.setDevicePixelRatio(primaryScreen->devicePixelRatio()); // 设置设备像素比
+    auto overlay = std::make_unique<ScreenshotOverlay>(
+        topology, i, m_selectionManager.get()); // 创建覆盖窗口对象
+
+    // 连接信号
+    connect(overlay.get(),
+            &ScreenshotOverlay::screenshotFinished, // 连接截图完成信号
+            this,
+            &ScreenshotApp::onScreenshotFinished); // 到截图完成处理函数
+    connect(overlay.get(),
+            &ScreenshotOverlay::screenshotCancelled, // 连接截图取消信号
+            this,
+            &ScreenshotApp::onScreenshotCancelled); // 到截图取消处理函数
+    connect(overlay.get(),
+            &ScreenshotOverlay::selectionChanged, // 连接选择区域变化信号
+            this,
+            &ScreenshotApp::onSelectionChanged); // 到其他覆盖窗口的同步函数
+    connect(overlay.get(),
+            &ScreenshotOverlay::pointerEntered, // 连接鼠标进入信号
+            this,
+            &ScreenshotApp::onOverlayPointerEntered); // 到焦点切换函数
+
+    overlay->winId(); // 预先创建原生窗口，显示时不再创建
+    m_overlays.push_back(std::move(overlay));
   }
+}
 
-  return screenshot; // 返回截图
+// 释放所有覆盖窗口
+void ScreenshotApp::destroyOverlays()
+{
+  m_overlays.clear();         // 释放所有覆盖窗口
+  m_selectionManager.reset(); // 覆盖窗口释放后再释放共享的选择区域
+}
+
+// 捕获所有屏幕
+ScreenshotFrameSet::Ptr ScreenshotApp::captureFullScreen()
+{
+  TraceRecorder::Scope traceScope("capture", "capture_full_screen");
+
+  // 获取缓存的显示器拓扑（屏幕变化后才会重建）
+  DisplayTopology::Ptr topology = DisplayTopology::current();
+  if (topology->isEmpty()) // 检查屏幕是否存在
+  {
+    qWarning() << "无法获取屏幕"; // 输出警告信息
+    return nullptr;               // 返回空帧集合
+  }
+
+  // 由采集后端并发捕获每个屏幕，每一帧携带各自屏幕的设备像素比，确保显示时不会被放大
+  ScreenshotFrameSet::Ptr frames = m_captureBackend->captureAll(topology);
+  if (!frames || frames->isNull()) // 检查截图是否成功
+  {
+    return nullptr; // 返回空帧集合
+  }
+
+  qDebug() << "屏幕捕获成功，屏幕数:" << frames->count() << "内存:" << frames->byteCount() / 1024
+           << "KB" << "耗时:" << m_captureBackend->lastCaptureLatency() / 1000000.0
+           << "ms"; // 输出截图信息
+  return frames;
 }
 
 // 检查屏幕录制权限
 void ScreenshotApp::checkScreenRecordingPermission()
 {
-  // 尝试进行一次测试截图来触发权限请求
+  // 只查询平台授权状态或采集1x1像素，不再为了检查权限采集整个主屏幕；
+  // OPENCAP_PERMISSION_PROBE=full时按原来的方式采集整个主屏幕，用于对比启动耗时
+  const bool fullProbe = qEnvironmentVariable("OPENCAP_PERMISSION_PROBE") == QLatin1String("full");
+
+  CaptureBackend::Permission permission = CaptureBackend::Permission::Unknown;
   QScreen* primaryScreen = QApplication::primaryScreen();
-  if (primaryScreen)
+  if (fullProbe && primaryScreen)
   {
-    QPixmap testScreenshot = primaryScreen->grabWindow(0);
-    if (testScreenshot.isNull())
-    {
-      qDebug() << "屏幕录制权限未授权，请手动授权";
-    }
-    else
-    {
-      qDebug() << "屏幕录制权限已授权";
-    }
+    ScreenshotFrame::Ptr testScreenshot = m_captureBackend->captureScreen(primaryScreen);
+    permission = testScreenshot ? CaptureBackend::Permission::Granted
+                                : CaptureBackend::Permission::Denied;
+  }
+  else
+  {
+    permission = m_captureBackend->permission();
+  }
+  markStartupPhase("permission_probe");
+
+  if (permission == CaptureBackend::Permission::Denied)
+  {
+    qDebug() << "屏幕录制权限未授权，请手动授权";
+  }
+  else if (permission == CaptureBackend::Permission::Granted)
+  {
+    qDebug() << "屏幕录制权限已授权";
+  }
+
+  saveStartupMetrics();
+}
+
+// 记录启动阶段的耗时（每个阶段只记录第一次，之后重建覆盖窗口等不计入启动）
+void ScreenshotApp::markStartupPhase(const char* phase)
+{
+  if (m_startupPhases.contains(phase))
+  {
+    return;
   }
+
+  const qint64 now = m_startupTimer.nsecsElapsed();
+  const qint64 duration = now - m_startupPhaseStart;
+  m_startupPhases[phase] = double(duration) / 1000.0;
+  m_startupPhaseStart = now;
+
+  // 同时作为跟踪区间记录（阶段名称都是字符串字面量）
+  TraceRecorder::instance().complete("startup", phase, TraceRecorder::now() - duration, duration);
 }
 
-// 裁剪截图并返回裁剪后的像素图
-QPixmap ScreenshotApp::cropScreenshot(const QRect& region)
+// 导出跟踪数据（Chrome/Perfetto跟踪JSON）
+void ScreenshotApp::exportTrace()
 {
-  if (m_fullScreenCapture.isNull() || region.isEmpty()) // 检查截图数据和区域是否有效
+  const QString path = TraceRecorder::instance().exportTo();
+  if (!path.isEmpty())
   {
-    qWarning() << "无效的截图数据或区域"; // 输出警告信息
-    return QPixmap();                     // 返回空像素图
+    qDebug() << "可以在 ui.perfetto.dev 或 chrome://tracing 中打开:" << path; // 输出调试信息
   }
+}
 
-  // 获取设备像素比，处理Retina屏幕
-  QScreen* screen = QApplication::primaryScreen();                    // 获取主屏幕
-  qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0; // 获取设备像素比
+// 保存启动指标：各阶段耗时，以及权限检查不再采集的主屏幕帧大小（高分辨率屏幕上的节省）
+// 只在设置了OPENCAP_METRICS_FILE时写入该文件所在目录，普通启动只输出调试信息
+void ScreenshotApp::saveStartupMetrics()
+{
+  QJsonObject json;
+  json["platform"] = QGuiApplication::platformName();
+  json["capture_backend"] = m_captureBackend->name();
+  json["permission_probe_mode"] =
+      qEnvironmentVariable("OPENCAP_PERMISSION_PROBE") == QLatin1String("full") ? "full" : "lazy";
+  json["phases_us"] = m_startupPhases;
+  json["total_us"] = double(m_startupTimer.nsecsElapsed()) / 1000.0;
 
-  // 调整区域坐标到实际像素
-  QRect actualRegion(region.x() * devicePixelRatio,       // 调整X坐标
-                     region.y() * devicePixelRatio,       // 调整Y坐标
-                     region.width() * devicePixelRatio,   // 调整宽度
-                     region.height() * devicePixelRatio); // 调整高度
+  QScreen* primaryScreen = QApplication::primaryScreen();
+  if (primaryScreen)
+  {
+    const qreal devicePixelRatio = primaryScreen->devicePixelRatio();
+    const QRect deviceRect =
+        ScreenshotFrame::mapToDevice(primaryScreen->geometry(), devicePixelRatio);
+    QJsonObject screen;
+    screen["width"] = deviceRect.width();
+    screen["height"] = deviceRect.height();
+    screen["device_pixel_ratio"] = devicePixelRatio;
+    screen["full_capture_bytes"] = double(deviceRect.width()) * deviceRect.height() * 4;
+    json["primary_screen"] = screen;
+  }
 
-  // 从全屏截图中裁剪选定区域
-  QPixmap croppedPixmap = m_fullScreenCapture.copy(actualRegion); // 裁剪截图
+  qDebug() << "启动耗时:" << json["total_us"].toDouble() / 1000.0 << "ms"
+           << "权限检查:" << m_startupPhases["permission_probe"].toDouble() / 1000.0
+           << "ms"; // 输出调试信息
 
-  return croppedPixmap; // 返回裁剪后的像素图
+  const QString metricsFile = qEnvironmentVariable("OPENCAP_METRICS_FILE");
+  if (metricsFile.isEmpty())
+  {
+    return;
+  }
+
+  const QString path = QFileInfo(metricsFile).absolutePath() + "/startup.json";
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qWarning() << "启动指标保存失败:" << path << file.errorString();
+    return;
+  }
+
+  file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+  qDebug() << "启动指标已保存:" << path; // 输出调试信息
 }
 
 // 显示文件对话框保存截图
-void ScreenshotApp::saveScreenshotWithDialog(const QPixmap& croppedPixmap)
+void ScreenshotApp::saveScreenshotWithDialog(const ScreenshotFrameSet::Ptr& frames,
+                                             const QRect& region)
 {
-  if (croppedPixmap.isNull()) // 检查截图数据是否有效
+  if (!frames || region.isEmpty()) // 检查截图数据和区域是否有效
   {
-    qWarning() << "无效的截图数据"; // 输出警告信息
-    return;                         // 直接返回
+    qWarning() << "无效的截图数据或区域"; // 输出警告信息
+    return;                               // 直接返回
   }
 
   // 生成默认文件名
@@ -264,12 +550,19 @@ void ScreenshotApp::saveScreenshotWithDialog(const QPixmap& croppedPixmap)
       QStandardPaths::writableLocation(QStandardPaths::DesktopLocation); // 获取桌面路径
 
   // 显示文件保存对话框，让用户选择保存位置和文件名
+  // QOI为无损格式，编码和解码比PNG快得多，适合临时保存或交给其他工具处理
+  const QString pngFilter = QStringLiteral("PNG图片 (*.png)");
+  const QString jpegFilter = QStringLiteral("JPEG图片 (*.jpg)");
+  const QString qoiFilter = QStringLiteral("QOI图片 (*.qoi)");
+  const QString allFilter = QStringLiteral("所有文件 (*)");
+  const QString filters = QStringList({pngFilter, jpegFilter, qoiFilter, allFilter}).join(";;");
+  QString selectedFilter = pngFilter; // 用户选择的文件类型
   QString filePath = QFileDialog::getSaveFileName(
       nullptr,                                             // 父窗口（nullptr表示无父窗口）
       QStringLiteral("保存截图"),                          // 对话框标题
       QDir(desktopPath).absoluteFilePath(defaultFileName), // 默认文件路径
-      QStringLiteral("PNG图片 (*.png);;JPEG图片 (*.jpg);;所有文件 (*)") // 文件过滤器
-  );
+      filters,                                             // 文件类型过滤器
+      &selectedFilter);                                    // 用户选择的文件类型
 
   // 检查用户是否取消了保存操作
   if (filePath.isEmpty()) // 如果文件路径为空，说明用户取消了保存
@@ -278,27 +571,33 @@ void ScreenshotApp::saveScreenshotWithDialog(const QPixmap& croppedPixmap)
     return;                           // 直接返回
   }
 
-  // 确保文件有正确的扩展名
+  // 确保文件有正确的扩展名（导出时按扩展名选择编码格式）
   QFileInfo fileInfo(filePath);    // 获取文件信息
   if (fileInfo.suffix().isEmpty()) // 如果没有扩展名
   {
-    filePath += ".png"; // 默认添加PNG扩展名
+    if (selectedFilter == jpegFilter) // 选择了JPEG
+    {
+      filePath += ".jpg"; // 添加JPEG扩展名
+    }
+    else if (selectedFilter == qoiFilter) // 选择了QOI
+    {
+      filePath += ".qoi"; // 添加QOI扩展名
+    }
+    else // 选择了PNG或所有文件
+    {
+      filePath += ".png"; // 默认添加PNG扩展名
+    }
   }
 
-  // 保存截图
-  if (croppedPixmap.save(filePath)) // 保存图片（Qt会自动根据扩展名选择格式）
-  {
-    qDebug() << "截图已保存到:" << filePath; // 输出成功信息
-  }
-  else // 保存失败
-  {
-    qWarning() << "保存截图失败:" << filePath; // 输出失败信息
-  }
+  // 区域使用虚拟桌面坐标，按所在屏幕的设备像素比换算到实际像素并裁剪（按边取整，
+  // 非整数缩放比例下也逐像素准确）；单个屏幕内的区域零拷贝引用截图帧，跨屏幕的区域自动拼接。
+  // 裁剪和编码都在导出线程池中完成，GUI线程立即返回，可以马上开始下一次截图
+  // （ImageEncoder按扩展名选择编码器：PNG/JPEG/QOI使用自带的编码器，其他格式交给QImageWriter）
+  ExportManager::shared().submit([frames, region]() { return frames->crop(region); }, filePath);
 }
 
 // 保存截图到文件（保留原方法以兼容）
 void ScreenshotApp::saveScreenshot(const QRect& region)
 {
-  QPixmap croppedPixmap = cropScreenshot(region); // 裁剪截图
-  saveScreenshotWithDialog(croppedPixmap);        // 保存截图
+  saveScreenshotWithDialog(m_fullScreenCapture, region); // 保存截图
 }
\ No newline at end of file
@@ -1,12 +1,19 @@
 #ifndef SCREENSHOTAPP_H // 防止头文件重复包含的宏定义开始
 #define SCREENSHOTAPP_H // 定义头文件标识符
 
-#include <QObject> // 包含Qt对象基类
-#include <QPixmap> // 包含Qt像素图类
-#include <memory>  // 包含C++智能指针
+#include <QElapsedTimer> // 包含Qt高精度计时器
+#include <QImage>        // 包含Qt图像类
+#include <QJsonObject>   // 包含Qt JSON对象
+#include <QObject>       // 包含Qt对象基类
+#include <memory>        // 包含C++智能指针
+#include <vector>        // 包含C++动态数组
 
+#include "ScreenshotFrameSet.h" // 包含虚拟桌面截图帧集合
+
+class CaptureBackend;    // 前向声明采集后端类
 class SystemTray;        // 前向声明系统托盘类
 class ScreenshotOverlay; // 前向声明截图覆盖层类
+class SelectionManager;  // 前向声明选择区域管理器类
 class MacGlobalShortcut; // 前向声明全局快捷键类
 
 // 截图应用程序主类，继承自QObject
@@ -25,30 +32,53 @@ public slots:
   void startScreenshot();
   // 公共槽函数：退出应用程序
   void exitApplication();
+  // 公共槽函数：导出跟踪数据（Chrome/Perfetto跟踪JSON）
+  void exportTrace();
 
 private slots:
   // 私有槽函数：处理截图完成事件，接收选中的区域
   void onScreenshotFinished(const QRect& region);
   // 私有槽函数：处理截图取消事件
   void onScreenshotCancelled();
+  // 私有槽函数：某个屏幕的覆盖层修改了共享的选择区域
+  void onSelectionChanged();
+  // 私有槽函数：鼠标进入某个屏幕的覆盖层
+  void onOverlayPointerEntered();
 
 private:
   // 私有成员函数：保存截图到文件，接收选中的区域
   void saveScreenshot(const QRect& region);
-  // 私有成员函数：裁剪截图并返回裁剪后的像素图
-  QPixmap cropScreenshot(const QRect& region);
-  // 私有成员函数：显示文件对话框保存截图
-  void saveScreenshotWithDialog(const QPixmap& croppedPixmap);
-  // 私有成员函数：捕获全屏截图并返回像素图
-  QPixmap captureFullScreen();
-  // 私有成员函数：检查屏幕录制权限
+  // 私有成员函数：显示文件对话框选择保存位置，之后在导出线程池中裁剪并保存截图
+  void saveScreenshotWithDialog(const ScreenshotFrameSet::Ptr& frames, const QRect& region);
+  // 私有成员函数：并发捕获所有屏幕并返回虚拟桌面截图帧集合
+  ScreenshotFrameSet::Ptr captureFullScreen();
+  // 私有成员函数：检查屏幕录制权限（启动后空闲时执行，结果缓存在采集后端中）
   void checkScreenRecordingPermission();
+  // 私有成员函数：记录启动阶段的耗时（从上一个阶段结束到现在）
+  void markStartupPhase(const char* phase);
+  // 私有成员函数：保存启动指标
+  void saveStartupMetrics();
+  // 私有成员函数：结束截图会话，隐藏所有屏幕的覆盖窗口
+  void closeOverlays();
+  // 私有成员函数：预先创建所有屏幕的覆盖窗口，截图时直接复用
+  void warmOverlayPool();
+  // 私有成员函数：为显示器拓扑中的每个屏幕创建隐藏的覆盖窗口
+  void createOverlays(const DisplayTopology::Ptr& topology);
+  // 私有成员函数：释放所有覆盖窗口
+  void destroyOverlays();
 
   // 私有成员变量
-  std::unique_ptr<SystemTray> m_systemTray;               // 系统托盘管理器（智能指针）
-  std::unique_ptr<ScreenshotOverlay> m_screenshotOverlay; // 截图覆盖层（智能指针）
-  QPixmap m_fullScreenCapture;                            // 存储全屏截图数据
-  MacGlobalShortcut* m_globalShortcut;                    // 全局快捷键（Cmd+Shift+A）
+  std::unique_ptr<CaptureBackend> m_captureBackend;           // 截图采集后端（智能指针）
+  std::unique_ptr<SystemTray> m_systemTray;                   // 系统托盘管理器（智能指针）
+  std::unique_ptr<SelectionManager> m_selectionManager;       // 所有覆盖层共享的选择区域
+  std::vector<std::unique_ptr<ScreenshotOverlay>> m_overlays; // 每个屏幕一个覆盖层（会话间复用）
+  ScreenshotFrameSet::Ptr m_fullScreenCapture;                // 所有屏幕的截图帧（与覆盖层共享）
+  MacGlobalShortcut* m_globalShortcut;                        // 全局快捷键（Cmd+Shift+A）
+  bool m_overlayPoolEnabled;                                  // 是否复用预先创建的覆盖窗口
+  bool m_sessionActive;                                       // 截图会话是否正在进行
+  QElapsedTimer m_startupTimer;                               // 启动计时器（构造时开始）
+  qint64 m_startupPhaseStart;                                 // 当前启动阶段的开始时间
+  QJsonObject m_startupPhases;                                // 各启动阶段的耗时（微秒）
 };
 
 #endif // SCREENSHOTAPP_H      // 防止头文件重复包含的宏定义结束
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "ScreenshotFrame.h"
+
+#include <QDebug>
+#include <QtMath>
+
+namespace
+{
+// 零拷贝图像释放时归还帧的引用
+void releaseFrame(void* frame)
+{
+  delete static_cast<ScreenshotFrame::Ptr*>(frame);
+}
+} // namespace
+
+// 构造空视图
+ScreenshotFrameView::ScreenshotFrameView()
+  : m_bits(nullptr), m_width(0), m_height(0), m_bytesPerLine(0), m_devicePixelRatio(1.0)
+{
+}
+
+// 构造指向指定像素区域的视图
+ScreenshotFrameView::ScreenshotFrameView(
+    const uchar* bits, int width, int height, qsizetype bytesPerLine, qreal devicePixelRatio)
+  : m_bits(bits),
+    m_width(width),
+    m_height(height),
+    m_bytesPerLine(bytesPerLine),
+    m_devicePixelRatio(devicePixelRatio)
+{
+}
+
+// 是否为空视图
+bool ScreenshotFrameView::isNull() const
+{
+  return !m_bits || m_width <= 0 || m_height <= 0;
+}
+
+// 获取宽度（物理像素）
+int ScreenshotFrameView::width() const
+{
+  return m_width;
+}
+
+// 获取高度（物理像素）
+int ScreenshotFrameView::height() const
+{
+  return m_height;
+}
+
+// 获取尺寸（物理像素）
+QSize ScreenshotFrameView::size() const
+{
+  return QSize(m_width, m_height);
+}
+
+// 获取行跨度
+qsizetype ScreenshotFrameView::bytesPerLine() const
+{
+  return m_bytesPerLine;
+}
+
+// 获取设备像素比
+qreal ScreenshotFrameView::devicePixelRatio() const
+{
+  return m_devicePixelRatio;
+}
+
+// 获取左上角像素指针
+const uchar* ScreenshotFrameView::constBits() const
+{
+  return m_bits;
+}
+
+// 获取指定行的起始指针
+const uchar* ScreenshotFrameView::constScanLine(int y) const
+{
+  return m_bits + y * m_bytesPerLine;
+}
+
+// 获取指定行的像素指针
+const QRgb* ScreenshotFrameView::row(int y) const
+{
+  return reinterpret_cast<const QRgb*>(constScanLine(y));
+}
+
+// 获取指定位置的像素（预乘格式）
+QRgb ScreenshotFrameView::pixel(int x, int y) const
+{
+  return row(y)[x];
+}
+
+// 获取子区域视图
+ScreenshotFrameView ScreenshotFrameView::subView(const QRect& rect) const
+{
+  QRect clipped = rect.intersected(QRect(0, 0, m_width, m_height));
+  if (isNull() || clipped.isEmpty())
+  {
+    return ScreenshotFrameView();
+  }
+
+  const uchar* bits = constScanLine(clipped.y()) + clipped.x() * sizeof(QRgb);
+  return ScreenshotFrameView(
+      bits, clipped.width(), clipped.height(), m_bytesPerLine, m_devicePixelRatio);
+}
+
+// 零拷贝包装为只读QImage
+QImage ScreenshotFrameView::toImage() const
+{
+  if (isNull())
+  {
+    return QImage();
+  }
+
+  // 使用const指针构造的QImage是只读的，任何写操作都会触发深拷贝，不会修改帧数据
+  QImage image(m_bits, m_width, m_height, m_bytesPerLine, FORMAT);
+  image.setDevicePixelRatio(m_devicePixelRatio);
+  return image;
+}
+
+// 深拷贝为独立的QImage
+QImage ScreenshotFrameView::copy() const
+{
+  return toImage().copy();
+}
+
+// 私有构造函数
+ScreenshotFrame::ScreenshotFrame(QImage image, qreal devicePixelRatio)
+  : m_image(std::move(image)), m_devicePixelRatio(devicePixelRatio)
+{
+}
+
+// 从截图像素图创建帧
+ScreenshotFrame::Ptr ScreenshotFrame::fromPixmap(QPixmap pixmap, qreal devicePixelRatio)
+{
+  if (pixmap.isNull())
+  {
+    return nullptr;
+  }
+
+  // 取出图像后立即释放像素图，使图像成为唯一持有者，后续格式转换可以原地完成
+  QImage image = pixmap.toImage();
+  pixmap = QPixmap();
+
+  return fromImage(std::move(image), devicePixelRatio);
+}
+
+// 从图像创建帧
+ScreenshotFrame::Ptr ScreenshotFrame::fromImage(QImage image, qreal devicePixelRatio)
+{
+  if (image.isNull())
+  {
+    return nullptr;
+  }
+
+  // 统一转换为预乘ARGB32，RGB32等兼容格式会原地转换
+  if (image.format() != ScreenshotFrameView::FORMAT)
+  {
+    image.convertTo(ScreenshotFrameView::FORMAT);
+  }
+
+  // 在图像被共享之前设置设备像素比，避免触发拷贝
+  image.setDevicePixelRatio(devicePixelRatio);
+
+  qDebug() << "截图帧已创建，尺寸:" << image.size() << "设备像素比:" << devicePixelRatio
+           << "内存:" << image.sizeInBytes() / 1024 << "KB";
+
+  return Ptr(new ScreenshotFrame(std::move(image), devicePixelRatio));
+}
+
+// 是否为空帧
+bool ScreenshotFrame::isNull() const
+{
+  return m_image.isNull();
+}
+
+// 获取宽度（物理像素）
+int ScreenshotFrame::width() const
+{
+  return m_image.width();
+}
+
+// 获取高度（物理像素）
+int ScreenshotFrame::height() const
+{
+  return m_image.height();
+}
+
+// 获取尺寸（物理像素）
+QSize ScreenshotFrame::size() const
+{
+  return m_image.size();
+}
+
+// 获取矩形（物理像素）
+QRect ScreenshotFrame::rect() const
+{
+  return m_image.rect();
+}
+
+// 获取逻辑尺寸（物理像素除以设备像素比）
+QSize ScreenshotFrame::logicalSize() const
+{
+  return (QSizeF(m_image.size()) / m_devicePixelRatio).toSize();
+}
+
+// 获取设备像素比
+qreal ScreenshotFrame::devicePixelRatio() const
+{
+  return m_devicePixelRatio;
+}
+
+// 获取像素数据占用的字节数
+qsizetype ScreenshotFrame::byteCount() const
+{
+  return m_image.sizeInBytes();
+}
+
+// 逻辑矩形换算为物理像素矩形
+QRect ScreenshotFrame::mapToDevice(const QRect& logicalRect, qreal devicePixelRatio)
+{
+  if (logicalRect.isNull())
+  {
+    return QRect();
+  }
+
+  // 分别对四条边取整，而不是对宽高截断：避免非整数缩放比例下裁剪结果少一个像素，
+  // 也保证两个相邻矩形换算后既不重叠也没有缝隙
+  const int left = qRound(logicalRect.x() * devicePixelRatio);
+  const int top = qRound(logicalRect.y() * devicePixelRatio);
+  const int right = qRound((logicalRect.x() + logicalRect.width()) * devicePixelRatio);
+  const int bottom = qRound((logicalRect.y() + logicalRect.height()) * devicePixelRatio);
+  return QRect(left, top, right - left, bottom - top);
+}
+
+// 使用帧的设备像素比换算逻辑矩形
+QRect ScreenshotFrame::mapToDevice(const QRect& logicalRect) const
+{
+  return mapToDevice(logicalRect, m_devicePixelRatio);
+}
+
+// 逻辑点所在的物理像素
+QPoint ScreenshotFrame::mapToDevice(const QPoint& logicalPos) const
+{
+  return QPoint(qFloor(logicalPos.x() * m_devicePixelRatio),
+                qFloor(logicalPos.y() * m_devicePixelRatio));
+}
+
+// 获取只读图像（与帧共享像素，不会拷贝）
+const QImage& ScreenshotFrame::image() const
+{
+  return m_image;
+}
+
+// 获取整帧视图
+ScreenshotFrameView ScreenshotFrame::view() const
+{
+  if (m_image.isNull())
+  {
+    return ScreenshotFrameView();
+  }
+
+  return ScreenshotFrameView(m_image.constBits(),
+                             m_image.width(),
+                             m_image.height(),
+                             m_image.bytesPerLine(),
+                             m_devicePixelRatio);
+}
+
+// 获取子区域视图
+ScreenshotFrameView ScreenshotFrame::view(const QRect& deviceRect) const
+{
+  return view().subView(deviceRect);
+}
+
+// 获取指定物理像素位置的像素（预乘格式）
+QRgb ScreenshotFrame::pixel(int x, int y) const
+{
+  return reinterpret_cast<const QRgb*>(m_image.constScanLine(y))[x];
+}
+
+// 零拷贝裁剪为持有帧引用的只读图像
+QImage ScreenshotFrame::share(const Ptr& frame, const QRect& deviceRect)
+{
+  const ScreenshotFrameView source = frame ? frame->view(deviceRect) : ScreenshotFrameView();
+  if (source.isNull())
+  {
+    return QImage();
+  }
+
+  // 使用const指针构造的QImage是只读的；帧的引用随图像数据一起释放
+  QImage image(source.constBits(),
+               source.width(),
+               source.height(),
+               source.bytesPerLine(),
+               ScreenshotFrameView::FORMAT,
+               releaseFrame,
+               new Ptr(frame));
+  image.setDevicePixelRatio(source.devicePixelRatio());
+  return image;
+}
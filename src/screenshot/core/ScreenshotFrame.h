@@ -0,0 +1,97 @@
+#ifndef SCREENSHOTFRAME_H
+#define SCREENSHOTFRAME_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <memory>
+
+// 截图帧只读视图 - 不持有像素，只指向帧内的一块矩形区域（物理像素）
+// 视图的生命周期不能超过其所属的帧
+class ScreenshotFrameView
+{
+public:
+  // 帧统一使用的像素格式（预乘ARGB32）
+  static constexpr QImage::Format FORMAT = QImage::Format_ARGB32_Premultiplied;
+
+  // 构造函数
+  ScreenshotFrameView();
+  ScreenshotFrameView(
+      const uchar* bits, int width, int height, qsizetype bytesPerLine, qreal devicePixelRatio);
+
+  // 基本信息
+  bool isNull() const;
+  int width() const;
+  int height() const;
+  QSize size() const;
+  qsizetype bytesPerLine() const;
+  qreal devicePixelRatio() const;
+
+  // 行指针访问
+  const uchar* constBits() const;
+  const uchar* constScanLine(int y) const;
+  const QRgb* row(int y) const;
+  QRgb pixel(int x, int y) const;
+
+  // 子区域视图（相对于当前视图的物理像素矩形，自动裁剪到边界）
+  ScreenshotFrameView subView(const QRect& rect) const;
+
+  // 零拷贝包装为QImage（只读，调用者须保证帧存活）
+  QImage toImage() const;
+  // 深拷贝为独立的QImage
+  QImage copy() const;
+
+private:
+  const uchar* m_bits;      // 左上角像素指针
+  int m_width;              // 宽度（物理像素）
+  int m_height;             // 高度（物理像素）
+  qsizetype m_bytesPerLine; // 行跨度（字节）
+  qreal m_devicePixelRatio; // 设备像素比
+};
+
+// 截图帧类 - 一次截图的唯一像素存储，创建后不可修改，通过引用计数在各组件间共享
+class ScreenshotFrame
+{
+public:
+  using Ptr = std::shared_ptr<const ScreenshotFrame>;
+
+  // 从截图像素图创建帧（一次性转换为固定格式，之后不再转换）
+  static Ptr fromPixmap(QPixmap pixmap, qreal devicePixelRatio);
+  // 从图像创建帧（格式一致且独占时不会拷贝像素）
+  static Ptr fromImage(QImage image, qreal devicePixelRatio);
+
+  // 基本信息
+  bool isNull() const;
+  int width() const;         // 物理像素宽度
+  int height() const;        // 物理像素高度
+  QSize size() const;        // 物理像素尺寸
+  QRect rect() const;        // 物理像素矩形
+  QSize logicalSize() const; // 逻辑尺寸
+  qreal devicePixelRatio() const;
+  qsizetype byteCount() const;
+
+  // 逻辑坐标换算为物理像素：按边取整，相邻矩形的共享边总是落在同一像素边界上
+  static QRect mapToDevice(const QRect& logicalRect, qreal devicePixelRatio);
+  QRect mapToDevice(const QRect& logicalRect) const;
+  QPoint mapToDevice(const QPoint& logicalPos) const; // 逻辑点所在的物理像素
+
+  // 只读访问
+  const QImage& image() const; // 已设置设备像素比，可直接用于QPainter绘制
+  ScreenshotFrameView view() const;
+  ScreenshotFrameView view(const QRect& deviceRect) const;
+  QRgb pixel(int x, int y) const;
+
+  // 零拷贝裁剪：返回的只读QImage直接指向帧的像素并持有帧的引用，
+  // 可以交给其他线程或在视图之外长期使用，写操作会先深拷贝，帧在最后一个图像释放后才销毁
+  static QImage share(const Ptr& frame, const QRect& deviceRect);
+
+private:
+  ScreenshotFrame(QImage image, qreal devicePixelRatio);
+
+  QImage m_image;           // 像素数据（预乘ARGB32）
+  qreal m_devicePixelRatio; // 设备像素比
+};
+
+#endif // SCREENSHOTFRAME_H
@@ -0,0 +1,164 @@
+#include "ScreenshotFrameSet.h"
+
+#include <QDebug>
+#include <QPainter>
+
+// 构造函数
+ScreenshotFrameSet::ScreenshotFrameSet(DisplayTopology::Ptr topology,
+                                       std::vector<ScreenshotFrame::Ptr> frames)
+  : m_topology(std::move(topology)), m_frames(std::move(frames))
+{
+}
+
+// 创建帧集合
+ScreenshotFrameSet::Ptr ScreenshotFrameSet::create(DisplayTopology::Ptr topology,
+                                                   std::vector<ScreenshotFrame::Ptr> frames)
+{
+  if (!topology || int(frames.size()) != topology->count())
+  {
+    qWarning() << "截图帧数量与显示器拓扑不一致";
+    return nullptr;
+  }
+  return Ptr(new ScreenshotFrameSet(std::move(topology), std::move(frames)));
+}
+
+// 是否所有屏幕都没有帧
+bool ScreenshotFrameSet::isNull() const
+{
+  for (const ScreenshotFrame::Ptr& frame : m_frames)
+  {
+    if (frame && !frame->isNull())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 帧数量（等于屏幕数量）
+int ScreenshotFrameSet::count() const
+{
+  return int(m_frames.size());
+}
+
+// 采集时的显示器拓扑
+const DisplayTopology::Ptr& ScreenshotFrameSet::topology() const
+{
+  return m_topology;
+}
+
+// 获取屏幕的帧
+const ScreenshotFrame::Ptr& ScreenshotFrameSet::frame(int index) const
+{
+  return m_frames[size_t(index)];
+}
+
+// 逻辑点所在屏幕的帧
+ScreenshotFrame::Ptr ScreenshotFrameSet::frameAt(const QPoint& logicalPos) const
+{
+  const int index = m_topology->indexAt(logicalPos);
+  return index >= 0 ? m_frames[size_t(index)] : nullptr;
+}
+
+// 所有帧占用的字节数
+qsizetype ScreenshotFrameSet::byteCount() const
+{
+  qsizetype total = 0;
+  for (const ScreenshotFrame::Ptr& frame : m_frames)
+  {
+    total += frame ? frame->byteCount() : 0;
+  }
+  return total;
+}
+
+// 复制虚拟桌面上的逻辑区域
+QImage ScreenshotFrameSet::copy(const QRect& logicalRect) const
+{
+  // 找出与区域相交的屏幕
+  const std::vector<int> indices = intersectingScreens(logicalRect);
+  if (indices.empty())
+  {
+    return QImage();
+  }
+
+  // 只在一个屏幕内：直接从该屏幕的帧中逐像素复制
+  if (indices.size() == 1)
+  {
+    return m_frames[size_t(indices.front())]->view(deviceRect(indices.front(), logicalRect)).copy();
+  }
+
+  // 涉及屏幕中最大的设备像素比
+  qreal devicePixelRatio = 0.0;
+  for (int index : indices)
+  {
+    devicePixelRatio = qMax(devicePixelRatio, m_frames[size_t(index)]->devicePixelRatio());
+  }
+
+  // 跨屏幕：按最大设备像素比拼接，没有屏幕覆盖的部分保持透明
+  const QRect resultRect =
+      ScreenshotFrame::mapToDevice(QRect(QPoint(0, 0), logicalRect.size()), devicePixelRatio);
+  QImage result(resultRect.size(), ScreenshotFrameView::FORMAT);
+  if (result.isNull())
+  {
+    qWarning() << "跨屏幕截图内存分配失败，尺寸:" << resultRect.size();
+    return result;
+  }
+  result.fill(Qt::transparent);
+
+  QPainter painter(&result);
+  painter.setCompositionMode(QPainter::CompositionMode_Source);
+  painter.setRenderHint(QPainter::SmoothPixmapTransform);
+  for (int index : indices)
+  {
+    const ScreenshotFrame::Ptr& screenFrame = m_frames[size_t(index)];
+    const QRect part = logicalRect.intersected(m_topology->screen(index).geometry);
+    const QRect source = m_topology->mapToDevice(index, part).intersected(screenFrame->rect());
+    const QRect target =
+        ScreenshotFrame::mapToDevice(part.translated(-logicalRect.topLeft()), devicePixelRatio);
+
+    // 设备像素比相同的屏幕尺寸一致，绘制退化为逐像素复制
+    painter.drawImage(target, screenFrame->view(source).toImage());
+  }
+  painter.end();
+
+  result.setDevicePixelRatio(devicePixelRatio);
+  return result;
+}
+
+// 裁剪虚拟桌面上的逻辑区域
+QImage ScreenshotFrameSet::crop(const QRect& logicalRect) const
+{
+  // 只在一个屏幕内：返回直接指向该屏幕帧像素的只读图像，不分配也不拷贝
+  const std::vector<int> indices = intersectingScreens(logicalRect);
+  if (indices.size() == 1)
+  {
+    const int index = indices.front();
+    return ScreenshotFrame::share(m_frames[size_t(index)], deviceRect(index, logicalRect));
+  }
+
+  // 跨屏幕只能拼接
+  return copy(logicalRect);
+}
+
+// 与逻辑区域相交且有帧的屏幕
+std::vector<int> ScreenshotFrameSet::intersectingScreens(const QRect& logicalRect) const
+{
+  std::vector<int> indices;
+  for (int i = 0; i < count(); ++i)
+  {
+    const ScreenshotFrame::Ptr& screenFrame = m_frames[size_t(i)];
+    if (screenFrame && !screenFrame->isNull() &&
+        m_topology->screen(i).geometry.intersects(logicalRect))
+    {
+      indices.push_back(i);
+    }
+  }
+  return indices;
+}
+
+// 逻辑区域在屏幕帧中的物理像素矩形（裁剪到屏幕和帧的边界）
+QRect ScreenshotFrameSet::deviceRect(int index, const QRect& logicalRect) const
+{
+  const QRect part = logicalRect.intersected(m_topology->screen(index).geometry);
+  return m_topology->mapToDevice(index, part).intersected(m_frames[size_t(index)]->rect());
+}
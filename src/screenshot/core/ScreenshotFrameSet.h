@@ -0,0 +1,46 @@
+#ifndef SCREENSHOTFRAMESET_H
+#define SCREENSHOTFRAMESET_H
+
+#include <QImage>
+#include <QRect>
+#include <memory>
+#include <vector>
+
+#include "DisplayTopology.h"
+#include "ScreenshotFrame.h"
+
+// 虚拟桌面截图帧集合 - 同一时刻每个屏幕各一帧（各自的设备像素比），与拓扑中的屏幕一一对应
+// 创建后不可修改，通过引用计数在覆盖层和导出之间共享
+class ScreenshotFrameSet
+{
+public:
+  using Ptr = std::shared_ptr<const ScreenshotFrameSet>;
+
+  // 创建帧集合：frames与topology的屏幕顺序一致，采集失败的屏幕为空指针
+  static Ptr create(DisplayTopology::Ptr topology, std::vector<ScreenshotFrame::Ptr> frames);
+
+  // 基本信息
+  bool isNull() const; // 所有屏幕都没有帧
+  int count() const;
+  const DisplayTopology::Ptr& topology() const;
+  const ScreenshotFrame::Ptr& frame(int index) const;
+  ScreenshotFrame::Ptr frameAt(const QPoint& logicalPos) const; // 逻辑点所在屏幕的帧
+  qsizetype byteCount() const;
+
+  // 复制虚拟桌面上的逻辑区域：只在一个屏幕内时按该屏幕的物理像素逐像素复制，
+  // 跨屏幕时按涉及屏幕中最大的设备像素比拼接，其余屏幕的内容按比例缩放
+  QImage copy(const QRect& logicalRect) const;
+  // 裁剪逻辑区域：只在一个屏幕内时零拷贝（图像指向帧的像素并持有帧的引用），跨屏幕时同copy
+  QImage crop(const QRect& logicalRect) const;
+
+private:
+  ScreenshotFrameSet(DisplayTopology::Ptr topology, std::vector<ScreenshotFrame::Ptr> frames);
+
+  std::vector<int> intersectingScreens(const QRect& logicalRect) const; // 与区域相交且有帧的屏幕
+  QRect deviceRect(int index, const QRect& logicalRect) const;          // 区域在屏幕帧中的物理像素
+
+  DisplayTopology::Ptr m_topology;           // 采集时的显示器拓扑
+  std::vector<ScreenshotFrame::Ptr> m_frames; // 每个屏幕的帧
+};
+
+#endif // SCREENSHOTFRAMESET_H
@@ -1,29 +1,32 @@
 #include "ScreenshotOverlay.h" // 包含截图覆盖层头文件
 
 // Qt核心头文件
-#include <QApplication> // 包含Qt应用程序框架
-#include <QClipboard>   // 包含Qt剪切板功能
-#include <QCursor>      // 包含Qt光标功能
-#include <QDateTime>    // 包含Qt日期时间功能
-#include <QDebug>       // 包含Qt调试输出功能
-#include <QEnterEvent>  // 包含Qt鼠标进入事件类
-#include <QPaintEvent>  // 包含Qt绘制事件定义
-#include <QPixmap>      // 包含Qt像素图类
-#include <QPoint>       // 包含Qt点坐标类
-#include <QRect>        // 包含Qt矩形类
-#include <QScreen>      // 包含Qt屏幕相关功能
-#include <QTimer>       // 包含Qt定时器功能
-#include <QWidget>      // 包含Qt窗口部件基类
-#include <QtGlobal>     // 包含Qt全局定义
+#include <QApplication>  // 包含Qt应用程序框架
+#include <QClipboard>    // 包含Qt剪切板功能
+#include <QCursor>       // 包含Qt光标功能
+#include <QDateTime>     // 包含Qt日期时间功能
+#include <QDebug>        // 包含Qt调试输出功能
+#include <QElapsedTimer> // 包含Qt高精度计时器
+#include <QRegion>       // 包含Qt区域类
+#include <QEnterEvent>   // 包含Qt鼠标进入事件类
+#include <QPaintEvent>   // 包含Qt绘制事件定义
+#include <QPixmap>       // 包含Qt像素图类
+#include <QPoint>        // 包含Qt点坐标类
+#include <QRect>         // 包含Qt矩形类
+#include <QScreen>       // 包含Qt屏幕相关功能
+#include <QTimer>        // 包含Qt定时器功能
+#include <QWidget>       // 包含Qt窗口部件基类
+#include <QtGlobal>      // 包含Qt全局定义
 
 // 项目头文件
+#include "../../utils/TraceRecorder.h"       // 包含跟踪记录器头文件
 #include "../managers/PerformanceManager.h"  // 包含性能管理器头文件
 #include "../managers/ScreenshotProcessor.h" // 包含截图处理器头文件
 #include "../managers/SelectionManager.h"    // 包含选择管理器头文件
-#include "../managers/UIManager.h"           // 包含UI管理器头文件
 #include "../managers/WindowLevelManager.h"  // 包含窗口层级管理器头文件
 #include "../ui/ScreenshotRenderer.h"        // 包含截图渲染器头文件
 #include "../ui/ScreenshotToolbar.h"         // 包含截图工具栏头文件
+#include "../ui/TileCompositor.h"            // 包含分块并行合成器头文件
 #include "managers/CursorManager.h"          // 包含光标管理器头文件
 #include "managers/EventHandler.h"           // 包含事件处理器头文件
 
@@ -34,66 +37,75 @@
 typedef quintptr WId; // 定义WId类型
 #endif
 
-// 截图覆盖层构造函数，接收截图和父窗口参数
-ScreenshotOverlay::ScreenshotOverlay(const QPixmap& screenshot, QWidget* parent)
-  : QWidget(parent),                                // 调用QWidget基类构造函数
-    m_screenshot(screenshot),                       // 保存传入的截图
-    m_renderer(new ScreenshotRenderer(screenshot)), // 创建渲染器对象
-    m_toolbar(nullptr),                             // 初始化工具栏为nullptr
-    m_selectionManager(nullptr),                    // 初始化选择管理器为nullptr
-    m_cursorManager(nullptr),                       // 初始化光标管理器为nullptr
-    m_screenshotProcessor(nullptr),                 // 初始化截图处理器为nullptr
-    m_performanceManager(nullptr),                  // 初始化性能管理器为nullptr
-    m_windowManager(nullptr),                       // 初始化窗口管理器为nullptr
-    m_uiManager(nullptr),                           // 初始化UI管理器为nullptr
-    m_eventHandler(nullptr),                        // 初始化事件处理器为nullptr
-    m_mousePos(QPoint(0, 0))                        // 初始化鼠标位置为(0,0)
+// 截图覆盖层构造函数，接收显示器拓扑、屏幕序号、共享的选择管理器和父窗口参数
+ScreenshotOverlay::ScreenshotOverlay(DisplayTopology::Ptr topology,
+                                     int screenIndex,
+                                     SelectionManager* selection,
+                                     QWidget* parent)
+  : QWidget(parent),                              // 调用QWidget基类构造函数
+    m_topology(std::move(topology)),              // 创建时的显示器拓扑
+    m_screenIndex(screenIndex),                   // 所在的屏幕序号
+    m_origin(QPoint(0, 0)),                       // 屏幕左上角（构造函数体内设置）
+    m_renderer(new ScreenshotRenderer(nullptr)),  // 创建渲染器（会话开始时设置帧）
+    m_compositor(new TileCompositor()),           // 创建分块并行合成器
+    m_toolbar(nullptr),                           // 初始化工具栏为nullptr
+    m_selectionManager(selection),                // 共享的选择管理器
+    m_ownsSelectionManager(selection == nullptr), // 未共享时自己创建
+    m_cursorManager(nullptr),                     // 初始化光标管理器为nullptr
+    m_screenshotProcessor(nullptr),               // 初始化截图处理器为nullptr
+    m_performanceManager(nullptr),                // 初始化性能管理器为nullptr
+    m_windowManager(nullptr),                     // 初始化窗口管理器为nullptr
+    m_eventHandler(nullptr),                      // 初始化事件处理器为nullptr
+    m_mousePos(QPoint(0, 0)),                     // 初始化鼠标位置为(0,0)
+    m_lastSelectionDecorations(0),                // 初始化选择框装饰状态
+    m_wheelDelta(0),                              // 初始化滚轮累计量
+    m_magnifierRefreshPending(false)              // 初始化放大镜重绘状态
 {
-  // 立即获取当前鼠标位置，避免从(0,0)闪烁
-  QPoint globalMousePos = QCursor::pos(); // 获取全局鼠标位置
-  m_mousePos = globalMousePos;            // 先用全局坐标，等窗口创建后再转换
+  TraceRecorder::Scope traceScope("overlay", "construct");
+
+  // 创建时刻，用于区分会话触发前已创建（复用）和随会话创建的覆盖层
+  m_lifetime.start();
+
+  // 本屏幕在虚拟桌面中的位置，选择区域在本地坐标和虚拟桌面坐标之间换算时使用
+  const DisplayTopology::Screen& screenInfo = m_topology->screen(m_screenIndex);
+  m_origin = screenInfo.geometry.topLeft();
 
   // 初始化所有管理器
   initializeManagers();
 
-  // 设置窗口管理器
+  // 设置窗口管理器：窗口只覆盖本屏幕
+  m_windowManager->setScreenGeometry(screenInfo.geometry);
   m_windowManager->setupWindow();
 
-  // 手动设置窗口几何覆盖整个屏幕，包括状态栏
-  QScreen* screen = QApplication::primaryScreen(); // 获取主屏幕
-  if (screen)                                      // 如果屏幕存在
+  // 窗口几何已由窗口管理器按显示器拓扑设置为覆盖整个屏幕，包括状态栏
+  if (!geometry().isEmpty()) // 如果窗口几何有效
   {
-    // 获取完整屏幕区域（包含状态栏），但要考虑设备像素比
-    QRect fullGeometry = screen->geometry();             // 获取屏幕完整几何信息
-    qreal devicePixelRatio = screen->devicePixelRatio(); // 获取设备像素比
-
-    qDebug() << "屏幕几何信息:";                           // 输出调试信息
-    qDebug() << "  - screen->geometry():" << fullGeometry; // 输出屏幕几何信息
-    qDebug() << "  - screen->availableGeometry():"
-             << screen->availableGeometry();                 // 输出可用屏幕区域
-    qDebug() << "  - devicePixelRatio:" << devicePixelRatio; // 输出设备像素比
-    qDebug() << "  - 截图尺寸:" << screenshot.size();        // 输出截图尺寸
-
-    // 窗口几何设置后，将全局鼠标坐标转换为本地坐标
-    QPoint globalMousePos = QCursor::pos();     // 再次获取全局鼠标位置
-    m_mousePos = mapFromGlobal(globalMousePos); // 转换为本地坐标
-    qDebug() << "初始鼠标位置:" << m_mousePos;  // 输出初始鼠标位置
+    qDebug() << "覆盖层几何信息:";                                      // 输出调试信息
+    qDebug() << "  - geometry:" << geometry();                          // 输出窗口几何信息
+    qDebug() << "  - devicePixelRatio:" << screenInfo.devicePixelRatio; // 输出设备像素比
+    qDebug() << "  - 截图尺寸:" << screenInfo.deviceSize;               // 输出截图尺寸
   }
 
   // 设置光标
   m_cursorManager->setDefaultCursor();
 
   // 创建UI组件
-  createInfoLabels();
   createToolbar();
 
   // 设置信号连接
   setupConnections();
 
-  // 启动窗口焦点监控
-  m_windowManager->startFocusMonitoring();
+  qDebug() << "截图覆盖窗口已创建，屏幕:" << screenInfo.name; // 输出创建成功信息
+}
 
-  qDebug() << "截图覆盖窗口已创建"; // 输出创建成功信息
+// 截图覆盖层构造函数，创建后立即开始一次会话
+ScreenshotOverlay::ScreenshotOverlay(ScreenshotFrameSet::Ptr frames,
+                                     int screenIndex,
+                                     SelectionManager* selection,
+                                     QWidget* parent)
+  : ScreenshotOverlay(frames->topology(), screenIndex, selection, parent)
+{
+  beginSession(std::move(frames));
 }
 
 // 析构函数，清理资源
@@ -103,7 +115,8 @@ ScreenshotOverlay::~ScreenshotOverlay()
   cleanupManagers();
 
   // 清理渲染器
-  delete m_renderer; // 删除渲染器对象
+  delete m_compositor; // 删除合成器对象
+  delete m_renderer;   // 删除渲染器对象
 
   qDebug() << "截图覆盖窗口已销毁"; // 输出销毁信息
 }
@@ -111,13 +124,15 @@ ScreenshotOverlay::~ScreenshotOverlay()
 // 初始化管理器
 void ScreenshotOverlay::initializeManagers()
 {
-  // 创建各个管理器
-  m_selectionManager = new SelectionManager();
+  // 创建各个管理器（多屏时选择管理器由所有覆盖层共享）
+  if (m_ownsSelectionManager)
+  {
+    m_selectionManager = new SelectionManager();
+  }
   m_cursorManager = new CursorManager(this);
-  m_screenshotProcessor = new ScreenshotProcessor(m_screenshot, this);
+  m_screenshotProcessor = new ScreenshotProcessor(m_frames, this);
   m_performanceManager = new PerformanceManager(this);
   m_windowManager = new WindowLevelManager(this, this);
-  m_uiManager = new UIManager(this);
   m_eventHandler = new EventHandler(this);
 
   // 设置事件处理器的截图处理器
@@ -152,6 +167,7 @@ void ScreenshotOverlay::setupConnections()
           this,
           [this]()
           {
+            // 虚拟桌面坐标，可以跨越多个屏幕
             QRect selectionRect = m_selectionManager->getSelectionRect();
             emit screenshotFinished(selectionRect);
           });
@@ -163,18 +179,29 @@ void ScreenshotOverlay::setupConnections()
           [this]()
           { QTimer::singleShot(0, this, [this]() { emit screenshotFinished(QRect()); }); });
 
+  // 每帧绘制前把这一帧内的场景变化转换为脏区域
+  m_performanceManager->setFrameCallback([this]() { collectSceneDamage(); });
+
   qDebug() << "信号连接已设置";
 }
 
 // 清理管理器
 void ScreenshotOverlay::cleanupManagers()
 {
-  delete m_selectionManager;
+  // 会话未结束就销毁时（例如应用退出）保存本次会话的帧指标
+  if (m_performanceManager && m_frames)
+  {
+    saveMetrics();
+  }
+
+  if (m_ownsSelectionManager)
+  {
+    delete m_selectionManager;
+  }
   delete m_cursorManager;
   delete m_screenshotProcessor;
   delete m_performanceManager;
   delete m_windowManager;
-  delete m_uiManager;
   delete m_eventHandler;
 
   // 设置为nullptr避免悬空指针
@@ -183,64 +210,213 @@ void ScreenshotOverlay::cleanupManagers()
   m_screenshotProcessor = nullptr;
   m_performanceManager = nullptr;
   m_windowManager = nullptr;
-  m_uiManager = nullptr;
   m_eventHandler = nullptr;
 }
 
+// 保存帧指标（设置了OPENCAP_METRICS_FILE时；主屏幕以外的覆盖层各自保存到带屏幕序号的文件）
+void ScreenshotOverlay::saveMetrics() const
+{
+  QString metricsPath = PerformanceManager::defaultMetricsPath();
+  if (metricsPath.isEmpty())
+  {
+    return;
+  }
+
+  if (m_screenIndex != m_topology->primaryIndex())
+  {
+    const int suffixPos = metricsPath.lastIndexOf('.');
+    metricsPath.insert(suffixPos < 0 ? metricsPath.size() : suffixPos,
+                       QString("-screen%1").arg(m_screenIndex));
+  }
+  m_performanceManager->dumpMetrics(metricsPath);
+}
+
 // 绘制事件处理函数
 void ScreenshotOverlay::paintEvent(QPaintEvent* event)
 {
-  Q_UNUSED(event) // 标记未使用的参数
+  TraceRecorder::Scope traceScope("overlay", "paint");
+  m_performanceManager->beginPaint();
+
+  // 重绘范围：Qt会把绘制裁剪到脏区域，这里额外跳过与脏区域不相交的元素
+  QRegion dirtyRegion = event->region();
+  const QRect dirtyRect = event->rect();
+
+  // 在GUI线程冻结本帧的场景状态，合成线程只读取快照，不会与事件处理冲突
+  m_renderer->prepareFrame();
+  SelectionManager::Snapshot selection = m_selectionManager->snapshot();
+  selection.rect.translate(-m_origin); // 换算为本覆盖层坐标
+  const int decorations = selectionDecorations();
+  const QRect decorationBounds = m_renderer->selectionBounds(selection.rect);
+
+  // 后台缓冲区重新分配后内容无效，需要完整合成
+  if (m_compositor->resize(size(), devicePixelRatioF()))
+  {
+    dirtyRegion = rect();
+  }
 
-  QPainter painter(this);                        // 创建绘制器对象
-  painter.setRenderHint(QPainter::Antialiasing); // 启用抗锯齿
+  // 背景、遮罩和选择框按分块并行合成到后台缓冲区
+  const ScreenshotRenderer* renderer = m_renderer;
+  PerformanceManager* metrics = m_performanceManager;
+  {
+    PerformanceManager::StageTimer compositeTimer(metrics, PerformanceManager::Stage::Composite);
+    m_compositor->compose(
+        dirtyRegion,
+        [&](QPainter& painter, QImage& pixels, const TileCompositor::Tile& tile)
+        {
+          // 背景直接按物理像素拷贝，变暗背景尚未生成时回退到QPainter绘制
+          {
+            PerformanceManager::StageTimer timer(metrics, PerformanceManager::Stage::Backdrop);
+            if (!renderer->blitBackdrop(
+                    pixels, tile.deviceRect, tile.clip, selection.rect, selection.hasSelection))
+            {
+              renderer->drawBackdrop(painter, selection.rect, selection.hasSelection);
+            }
+          }
 
-  // 绘制背景截图
-  m_renderer->drawBackground(painter); // 使用渲染器绘制背景
+          painter.setRenderHint(QPainter::Antialiasing);
+          if (decorations != 0 && decorationBounds.intersects(tile.rect))
+          {
+            PerformanceManager::StageTimer timer(metrics, PerformanceManager::Stage::Overlay);
+            renderer->drawSelectionBox(painter, selection.rect);
 
-  // 绘制半透明遮罩
-  QRect selectionRect = m_selectionManager->getSelectionRect();
-  m_renderer->drawOverlay(painter, selectionRect, m_selectionManager->hasSelection());
+            // 如果选择完成，绘制调整锚点
+            if (decorations & DecorationHandles)
+            {
+              renderer->drawResizeHandles(painter, selection.rect);
+            }
+          }
+        });
+  }
+
+  QPainter painter(this); // 创建绘制器对象
+
+  // GUI线程只把后台缓冲区呈现到窗口
+  {
+    PerformanceManager::StageTimer timer(metrics, PerformanceManager::Stage::Present);
+    m_compositor->present(painter);
+  }
+  painter.setRenderHint(QPainter::Antialiasing); // 启用抗锯齿
 
-  // 绘制选择框
-  if (m_selectionManager->hasSelection() && !m_toolbar->m_isEditing)
+  // 绘制顶部提示和尺寸标签
   {
-    m_renderer->drawSelectionBox(painter, selectionRect);
+    PerformanceManager::StageTimer timer(metrics, PerformanceManager::Stage::Hud);
+    drawInfo(painter, dirtyRect);
+  }
 
-    // 如果选择完成，绘制调整锚点
-    if (m_selectionManager->isSelectionFinished())
+  // 绘制放大镜（如果有有效的鼠标位置）
+  if (isMagnifierVisible() &&
+      m_renderer->magnifierBounds(m_mousePos, width(), height()).intersects(dirtyRect))
+  {
+    PerformanceManager::StageTimer timer(metrics, PerformanceManager::Stage::Magnifier);
+    m_renderer->drawMagnifier(painter, m_mousePos, width(), height());
+
+    // 缩小级别还在后台生成：放大镜暂时显示原始帧，稍后重绘直到生成完成
+    if (m_renderer->isMagnifierLevelPending() && !m_magnifierRefreshPending)
     {
-      m_renderer->drawResizeHandles(painter, selectionRect);
+      m_magnifierRefreshPending = true;
+      QTimer::singleShot(MAGNIFIER_REFRESH_INTERVAL,
+                         this,
+                         [this]()
+                         {
+                           m_magnifierRefreshPending = false;
+                           m_performanceManager->addDirtyRect(m_lastMagnifierBounds);
+                           m_performanceManager->requestFrame();
+                         });
     }
   }
 
-  // 绘制信息文字
-  drawInfo(painter);
+  // 调试HUD：显示上一帧为止的指标
+  if (m_performanceManager->isDebugHudEnabled() &&
+      m_performanceManager->debugHudBounds().intersects(dirtyRect))
+  {
+    m_performanceManager->drawDebugHud(painter);
+  }
 
-  // 绘制放大镜（如果有有效的鼠标位置）
-  if (m_mousePos.x() >= 0 && m_mousePos.y() >= 0 && !m_selectionManager->isSelectionFinished() &&
-      !m_toolbar->m_isEditing)
+  m_performanceManager->endPaint();
+}
+
+// 放大镜当前是否可见
+bool ScreenshotOverlay::isMagnifierVisible() const
+{
+  // 只在鼠标所在屏幕的覆盖层上显示
+  return rect().contains(m_mousePos) &&
+         !m_selectionManager->isSelectionFinished() && !m_toolbar->m_isEditing;
+}
+
+// 当前选择框的装饰状态（边框、锚点）
+int ScreenshotOverlay::selectionDecorations() const
+{
+  if (!m_selectionManager->hasSelection() || m_toolbar->m_isEditing)
   {
-    m_renderer->drawMagnifier(painter, m_mousePos, width(), height());
+    return 0;
+  }
+
+  if (m_selectionManager->isSelectionFinished())
+  {
+    return DecorationBorder | DecorationHandles;
   }
+
+  return DecorationBorder;
 }
 
-// 绘制信息文字
-void ScreenshotOverlay::drawInfo(QPainter& painter)
+// 场景发生变化，请求在下一帧重绘（同一帧内的多次变化只处理一次）
+void ScreenshotOverlay::scheduleSceneUpdate()
+{
+  m_performanceManager->requestFrame();
+}
+
+// 计算自上一帧以来场景变化产生的脏区域
+void ScreenshotOverlay::collectSceneDamage()
 {
-  Q_UNUSED(painter) // 标记未使用的参数，因为现在使用QLabel
+  QRegion damage;
 
-  // 更新坐标信息标签
-  if (m_selectionManager->hasSelection())
+  // 放大镜：旧位置和新位置都需要重绘
+  QRect magnifierBounds = isMagnifierVisible()
+                              ? m_renderer->magnifierBounds(m_mousePos, width(), height())
+                              : QRect();
+  if (magnifierBounds != m_lastMagnifierBounds)
   {
-    QRect selectionRect = m_selectionManager->getSelectionRect();
-    m_uiManager->updateCoordinateLabel(selectionRect, width());
-    m_uiManager->showCoordinateLabel();
+    damage += m_lastMagnifierBounds;
+    damage += magnifierBounds;
+    m_lastMagnifierBounds = magnifierBounds;
   }
-  else
+
+  // 选择框：旧的和新的边框、锚点以及遮罩变化的区域
+  QRect selectionRect = m_selectionManager->hasSelection() ? localSelectionRect() : QRect();
+  int decorations = selectionDecorations();
+  if (selectionRect != m_lastSelectionRect || decorations != m_lastSelectionDecorations)
   {
-    m_uiManager->hideCoordinateLabel();
+    QRegion changed(m_renderer->selectionBounds(m_lastSelectionRect));
+    changed += m_renderer->selectionBounds(selectionRect);
+
+    // 新旧选择框内部的公共区域不受边框和锚点影响，遮罩状态也没有变化
+    changed -= m_renderer->selectionInterior(m_lastSelectionRect)
+                   .intersected(m_renderer->selectionInterior(selectionRect));
+
+    damage += changed;
+    m_lastSelectionRect = selectionRect;
+    m_lastSelectionDecorations = decorations;
+
+    // 尺寸标签：位置和文字都随选择区域变化
+    QRect sizeBadgeBounds = m_renderer->sizeBadgeBounds(selectionRect, width());
+    damage += m_lastSizeBadgeBounds;
+    damage += sizeBadgeBounds;
+    m_lastSizeBadgeBounds = sizeBadgeBounds;
   }
+
+  // 选择区域可能在其他屏幕上，只保留本覆盖层内的部分
+  m_performanceManager->addDirtyRegion(damage.intersected(rect()));
+}
+
+// 绘制信息文字
+void ScreenshotOverlay::drawInfo(QPainter& painter, const QRect& dirtyRect)
+{
+  // HUD由渲染器直接绘制，文字排版和面板背景都已缓存
+  m_renderer->drawHud(painter,
+                      dirtyRect,
+                      localSelectionRect(),
+                      m_selectionManager->hasSelection(),
+                      width());
 }
 
 // 鼠标按下事件处理
@@ -248,6 +424,8 @@ void ScreenshotOverlay::mousePressEvent(QMouseEvent* event)
 {
   if (event->button() == Qt::LeftButton) // 如果是左键按下
   {
+    const QPoint globalPos = toGlobal(event->pos()); // 选择区域使用虚拟桌面坐标
+
     if (m_toolbar->m_isEditing)
     {
       return;
@@ -256,72 +434,72 @@ void ScreenshotOverlay::mousePressEvent(QMouseEvent* event)
     if (m_selectionManager->isSelectionFinished()) // 如果选择已完成
     {
       // 检查是否点击了锚点
-      SelectionManager::ResizeHandle handle = m_selectionManager->getResizeHandle(event->pos());
+      SelectionManager::ResizeHandle handle = m_selectionManager->getResizeHandle(globalPos);
       if (handle != SelectionManager::ResizeHandle::None) // 如果点击了锚点
       {
-        m_selectionManager->startResize(handle, event->pos());
+        m_selectionManager->startResize(handle, globalPos);
         hideToolbar(); // 调整开始时隐藏工具栏
+        notifySelectionChanged();
         return;
       }
-      else if (m_selectionManager->isInsideSelection(event->pos())) // 如果点击了选择框内部
+      else if (m_selectionManager->isInsideSelection(globalPos)) // 如果点击了选择框内部
       {
         // 开始移动选择框
-        m_selectionManager->startMove(event->pos());
+        m_selectionManager->startMove(globalPos);
         hideToolbar(); // 移动开始时隐藏工具栏
+        notifySelectionChanged();
         return;
       }
     }
     else
     {
       // 开始新的选择
-      m_selectionManager->startSelection(event->pos());
+      m_selectionManager->startSelection(globalPos);
     }
 
-    m_performanceManager->triggerOptimizedUpdate();
+    notifySelectionChanged();
   }
 }
 
 // 鼠标移动事件处理
 void ScreenshotOverlay::mouseMoveEvent(QMouseEvent* event)
 {
-  // 始终更新鼠标位置以便绘制放大镜
+  // 始终更新鼠标位置以便绘制放大镜，脏区域计算需要使用新位置
   QPoint newMousePos = event->pos();
+  bool mouseMoved = newMousePos != m_mousePos;
+  m_mousePos = newMousePos;
+
+  // 拖动跨越屏幕时事件仍然发给按下时的覆盖层，本地坐标会超出窗口范围
+  const QPoint globalPos = toGlobal(newMousePos);
+
   if (m_toolbar->m_isEditing)
   {
   }
   else if (m_selectionManager->isResizing()) // 如果正在调整大小
   {
-    m_selectionManager->updateResize(event->pos());
-    m_performanceManager->triggerOptimizedUpdate();
+    m_selectionManager->updateResize(globalPos);
+    notifySelectionChanged();
   }
   else if (m_selectionManager->isMoving()) // 如果正在移动选择框
   {
-    m_selectionManager->updateMove(event->pos(), width(), height());
-    m_performanceManager->triggerOptimizedUpdate();
+    m_selectionManager->updateMove(globalPos, m_topology->virtualGeometry());
+    notifySelectionChanged();
   }
   else if (m_selectionManager->isSelecting()) // 如果正在选择
   {
-    m_selectionManager->updateSelection(event->pos());
-    m_performanceManager->triggerOptimizedUpdate();
+    m_selectionManager->updateSelection(globalPos);
+    notifySelectionChanged();
   }
   else if (m_selectionManager->isSelectionFinished()) // 如果选择完成，更新光标
   {
-    m_cursorManager->updateCursor(event->pos(), m_selectionManager);
+    m_cursorManager->updateCursor(globalPos, m_selectionManager);
     // 对于光标更新，不需要重绘界面
   }
-  else
+  else if (mouseMoved)
   {
     // 只有鼠标位置真正变化时才更新放大镜区域
-    if (newMousePos != m_mousePos)
-    {
-      m_mousePos = newMousePos;
-      m_performanceManager->updateMagnifierRegion();
-      return;
-    }
+    scheduleSceneUpdate();
   }
-
-  // 更新鼠标位置
-  m_mousePos = newMousePos;
 }
 
 // 鼠标释放事件处理
@@ -329,6 +507,8 @@ void ScreenshotOverlay::mouseReleaseEvent(QMouseEvent* event)
 {
   if (event->button() == Qt::LeftButton) // 如果是左键释放
   {
+    const QPoint globalPos = toGlobal(event->pos()); // 选择区域使用虚拟桌面坐标
+
     if (m_selectionManager->isSelecting()) // 如果正在选择
     {
       m_selectionManager->finishSelection();
@@ -337,25 +517,24 @@ void ScreenshotOverlay::mouseReleaseEvent(QMouseEvent* event)
       {
         m_cursorManager->setArrowCursor();
         showToolbar();
-        m_performanceManager->invalidateMagnifierCache();
         qDebug() << "选择区域完成:" << m_selectionManager->getSelectionRect();
       }
 
-      m_performanceManager->triggerOptimizedUpdate();
+      notifySelectionChanged();
     }
     else if (m_selectionManager->isResizing()) // 如果正在调整大小
     {
       m_selectionManager->finishResize();
-      m_cursorManager->updateCursor(event->pos(), m_selectionManager);
+      m_cursorManager->updateCursor(globalPos, m_selectionManager);
       showToolbar(); // 调整完成后更新工具栏位置
-      m_performanceManager->triggerOptimizedUpdate();
+      notifySelectionChanged();
     }
     else if (m_selectionManager->isMoving()) // 如果正在移动选择框
     {
       m_selectionManager->finishMove();
-      m_cursorManager->updateCursor(event->pos(), m_selectionManager);
+      m_cursorManager->updateCursor(globalPos, m_selectionManager);
       showToolbar(); // 移动完成后更新工具栏位置
-      m_performanceManager->triggerOptimizedUpdate();
+      notifySelectionChanged();
     }
   }
 }
@@ -369,6 +548,12 @@ void ScreenshotOverlay::keyPressEvent(QKeyEvent* event)
     m_eventHandler->handleCancelButton();
     return;
   }
+  else if (event->key() == Qt::Key_F12) // 如果按下F12键
+  {
+    // 切换性能调试HUD
+    m_performanceManager->setDebugHudEnabled(!m_performanceManager->isDebugHudEnabled());
+    return;
+  }
   else if (event->key() == Qt::Key_C &&
            !m_selectionManager->isSelectionFinished()) // 如果按下C键且未完成选择
   {
@@ -386,6 +571,29 @@ void ScreenshotOverlay::keyPressEvent(QKeyEvent* event)
   QWidget::keyPressEvent(event); // 调用基类事件处理
 }
 
+// 鼠标滚轮事件处理：调整放大镜缩放级别
+void ScreenshotOverlay::wheelEvent(QWheelEvent* event)
+{
+  if (!isMagnifierVisible())
+  {
+    QWidget::wheelEvent(event); // 调用基类事件处理
+    return;
+  }
+
+  // 触控板会产生不足一格的增量，累计满一格（120）才切换一个级别
+  m_wheelDelta += event->angleDelta().y();
+  int steps = m_wheelDelta / QWheelEvent::DefaultDeltasPerStep;
+  m_wheelDelta -= steps * QWheelEvent::DefaultDeltasPerStep;
+
+  // 放大镜位置不变，只有内容变化
+  if (steps != 0 && m_renderer->stepMagnifierZoom(steps))
+  {
+    m_performanceManager->addDirtyRect(m_lastMagnifierBounds);
+    m_performanceManager->requestFrame();
+  }
+  event->accept();
+}
+
 // 鼠标进入事件处理
 void ScreenshotOverlay::enterEvent(QEnterEvent* event)
 {
@@ -396,24 +604,177 @@ void ScreenshotOverlay::enterEvent(QEnterEvent* event)
   if (newMousePos != m_mousePos)
   {
     m_mousePos = newMousePos;
-    m_performanceManager->updateMagnifierRegion();
+    scheduleSceneUpdate();
   }
 
+  // 多屏时由鼠标所在屏幕的覆盖层接收键盘输入
+  emit pointerEntered();
+
   QWidget::enterEvent(event); // 调用基类事件处理
 }
 
 // 鼠标离开事件处理
 void ScreenshotOverlay::leaveEvent(QEvent* event)
 {
-  // 鼠标离开窗口时保持最后的位置，不隐藏放大镜
+  // 移到其他屏幕后放大镜由那个屏幕的覆盖层绘制：更新为窗口外的位置，
+  // 放大镜不再可见，旧的放大镜区域被标记为脏区域并清除
+  const QPoint pos = mapFromGlobal(QCursor::pos());
+  if (!rect().contains(pos))
+  {
+    m_mousePos = pos;
+    scheduleSceneUpdate();
+  }
   QWidget::leaveEvent(event); // 调用基类事件处理
 }
 
-// 设置窗口层级
+// 设置窗口层级（层级变化不影响窗口内容，不需要重绘）
 void ScreenshotOverlay::setWindowLevel()
 {
   m_windowManager->setWindowLevel();
+}
+
+// 开始一次截图会话：更换截图帧并清除上一次会话的状态，之后由调用者显示窗口
+// trigger为触发截图的时刻，有效时记录从触发到第一帧绘制完成的启动延迟
+void ScreenshotOverlay::beginSession(ScreenshotFrameSet::Ptr frames, const QElapsedTimer& trigger)
+{
+  if (!frames || frames->topology() != m_topology)
+  {
+    qWarning() << "截图帧与覆盖层的显示器拓扑不一致，屏幕:" << m_screenIndex; // 输出警告信息
+    return;
+  }
+
+  TraceRecorder::Scope traceScope("overlay", "begin_session");
+  m_frames = std::move(frames);
+  m_frame = m_frames->frame(m_screenIndex);
+  m_renderer->reset(m_frame);
+  m_screenshotProcessor->setFrames(m_frames);
+
+  // 清除上一次会话的交互状态（共享的选择区域由每个覆盖层重复重置，结果相同）
+  m_selectionManager->reset();
+  m_toolbar->reset();
+  m_cursorManager->setDefaultCursor();
+  m_lastMagnifierBounds = QRect();
+  m_lastSelectionRect = QRect();
+  m_lastSizeBadgeBounds = QRect();
+  m_lastSelectionDecorations = 0;
+  m_wheelDelta = 0;
+
+  // 立即获取当前鼠标位置，避免从(0,0)闪烁
+  m_mousePos = mapFromGlobal(QCursor::pos());
+
+  // 后台缓冲区在上一次会话结束时已释放；窗口隐藏时只丢弃等待中的帧，显示时Qt会完整绘制一次
   m_performanceManager->forceFullRedraw();
+  if (trigger.isValid())
+  {
+    const bool warm = m_lifetime.nsecsElapsed() > trigger.nsecsElapsed();
+    m_performanceManager->markSessionStart(trigger, warm);
+  }
+
+  qDebug() << "截图会话开始，屏幕:" << m_screenIndex << "截图尺寸:"
+           << (m_frame ? m_frame->size() : QSize()); // 输出会话信息
+}
+
+// 结束截图会话：隐藏窗口并释放截图帧，覆盖层保留以便下一次会话复用
+void ScreenshotOverlay::endSession()
+{
+  m_windowManager->stopFocusMonitoring();
+  m_toolbar->reset();
+  hide();
+
+  if (m_frames)
+  {
+    saveMetrics();
+  }
+
+  m_renderer->reset(nullptr);
+  m_screenshotProcessor->setFrames(nullptr);
+  m_frame.reset();
+  m_frames.reset();
+
+  // 后台缓冲区与屏幕一样大且保留着这次截图的像素，空闲时释放；下一次会话完整绘制时重新分配
+  m_compositor->release();
+}
+
+// 创建时的显示器拓扑
+const DisplayTopology::Ptr& ScreenshotOverlay::topology() const
+{
+  return m_topology;
+}
+
+// 覆盖层所在的屏幕序号
+int ScreenshotOverlay::screenIndex() const
+{
+  return m_screenIndex;
+}
+
+// 设置是否由本覆盖层持有键盘焦点：只有持有者监控并恢复焦点，避免多个覆盖层互相抢夺
+void ScreenshotOverlay::setFocusOwner(bool owner)
+{
+  if (owner)
+  {
+    m_windowManager->ensureWindowActive();
+    m_windowManager->startFocusMonitoring();
+  }
+  else
+  {
+    m_windowManager->stopFocusMonitoring();
+  }
+}
+
+// 其他屏幕的覆盖层修改了共享的选择区域
+void ScreenshotOverlay::syncSelection()
+{
+  // 选择完成且不在拖动中时由选择区域所在的屏幕显示工具栏
+  const bool dragging = m_selectionManager->isSelecting() || m_selectionManager->isMoving() ||
+                        m_selectionManager->isResizing();
+  if (m_selectionManager->isValidSelection() && m_selectionManager->isSelectionFinished() &&
+      !dragging)
+  {
+    showToolbar();
+  }
+  else
+  {
+    hideToolbar();
+  }
+
+  // 脏区域按本屏幕的范围计算，选择区域不在本屏幕时不会重绘
+  scheduleSceneUpdate();
+}
+
+// 本地坐标换算为虚拟桌面坐标
+QPoint ScreenshotOverlay::toGlobal(const QPoint& localPos) const
+{
+  return localPos + m_origin;
+}
+
+// 选择区域（本覆盖层坐标）
+QRect ScreenshotOverlay::localSelectionRect() const
+{
+  return m_selectionManager->getSelectionRect().translated(-m_origin);
+}
+
+// 工具栏是否显示在本屏幕：选择区域底边中点所在的屏幕，不在任何屏幕内时使用中心点所在的屏幕
+bool ScreenshotOverlay::ownsToolbar() const
+{
+  const QRect selection = m_selectionManager->getSelectionRect();
+
+  int owner = m_topology->indexAt(QPoint(selection.center().x(), selection.bottom()));
+  if (owner < 0)
+  {
+    owner = m_topology->indexAt(selection.center());
+  }
+  if (owner < 0)
+  {
+    owner = m_topology->primaryIndex();
+  }
+  return owner == m_screenIndex;
+}
+
+// 共享的选择区域发生变化：重绘本覆盖层并通知其他屏幕的覆盖层
+void ScreenshotOverlay::notifySelectionChanged()
+{
+  scheduleSceneUpdate();
+  emit selectionChanged();
 }
 
 // 显示工具栏
@@ -422,7 +783,14 @@ void ScreenshotOverlay::showToolbar()
   if (!m_selectionManager->hasSelection() || !m_toolbar)
     return;
 
-  QRect selection = m_selectionManager->getSelectionRect();
+  // 跨屏的选择区域只在一个屏幕上显示工具栏
+  if (!ownsToolbar())
+  {
+    hideToolbar();
+    return;
+  }
+
+  QRect selection = localSelectionRect();
   int toolbarWidth = m_toolbar->width();
   int toolbarHeight = m_toolbar->height();
 
@@ -479,15 +847,6 @@ void ScreenshotOverlay::saveToFile()
   m_screenshotProcessor->saveToFile(selectionRect);
 }
 
-// 创建信息标签
-void ScreenshotOverlay::createInfoLabels()
-{
-  m_uiManager->createInfoLabels();
-
-  // 设置信息标签位置
-  m_uiManager->positionInfoLabel(width());
-}
-
 // 创建工具栏
 void ScreenshotOverlay::createToolbar()
 {
@@ -1,46 +1,74 @@
 #ifndef SCREENSHOTOVERLAY_H // 防止头文件重复包含的宏定义开始
 #define SCREENSHOTOVERLAY_H // 定义头文件标识符
 
-#include <QEnterEvent> // 包含Qt鼠标进入事件类
-#include <QKeyEvent>   // 包含Qt键盘事件类
-#include <QLabel>      // 包含Qt标签类
-#include <QMouseEvent> // 包含Qt鼠标事件类
-#include <QPainter>    // 包含Qt绘制器类
-#include <QPixmap>     // 包含Qt像素图类
-#include <QPoint>      // 包含Qt点坐标类
-#include <QRect>       // 包含Qt矩形类
-#include <QTimer>      // 包含Qt定时器类
-#include <QWidget>     // 包含Qt窗口部件基类
-
+#include <QElapsedTimer> // 包含Qt高精度计时器
+#include <QEnterEvent>   // 包含Qt鼠标进入事件类
+#include <QKeyEvent>     // 包含Qt键盘事件类
+#include <QMouseEvent>   // 包含Qt鼠标事件类
+#include <QPainter>      // 包含Qt绘制器类
+#include <QPixmap>       // 包含Qt像素图类
+#include <QPoint>        // 包含Qt点坐标类
+#include <QRect>         // 包含Qt矩形类
+#include <QTimer>        // 包含Qt定时器类
+#include <QWheelEvent>   // 包含Qt滚轮事件类
+#include <QWidget>       // 包含Qt窗口部件基类
+
+// 包含截图帧头文件以使用共享帧指针
+#include "ScreenshotFrame.h"
+#include "ScreenshotFrameSet.h"
 // 包含工具栏头文件以使用枚举类型
 #include "ScreenshotToolbar.h"
 
 // 前向声明
 class ScreenshotRenderer;
+class TileCompositor;
 class SelectionManager;
 class CursorManager;
 class ScreenshotProcessor;
 class PerformanceManager;
 class WindowLevelManager;
-class UIManager;
 class EventHandler;
 
 // 截图覆盖层类，继承自QWidget
+// 每个屏幕一个覆盖层，只绘制本屏幕的帧；所有覆盖层共享同一个选择区域管理器（虚拟桌面坐标）
 class ScreenshotOverlay : public QWidget
 {
 Q_OBJECT // Qt元对象系统宏，支持信号槽机制
 
     public :
-  // 构造函数：创建截图覆盖层，接收截图和父窗口参数
-  explicit ScreenshotOverlay(const QPixmap& screenshot, QWidget* parent = nullptr);
+  // 构造函数：为拓扑中的第screenIndex个屏幕预先创建隐藏的覆盖层，之后每次截图复用
+  // selection为空时使用覆盖层自己的选择区域管理器（单屏）
+  explicit ScreenshotOverlay(DisplayTopology::Ptr topology,
+                             int screenIndex,
+                             SelectionManager* selection = nullptr,
+                             QWidget* parent = nullptr);
+  // 构造函数：为帧集合中的第screenIndex个屏幕创建覆盖层，并立即开始会话
+  explicit ScreenshotOverlay(ScreenshotFrameSet::Ptr frames,
+                             int screenIndex,
+                             SelectionManager* selection = nullptr,
+                             QWidget* parent = nullptr);
   ~ScreenshotOverlay();  // 析构函数：清理资源
   void setWindowLevel(); // 设置窗口层级为最高
 
+  // 截图会话：开始时更换截图帧并清除上一次会话的状态（trigger有效时记录启动延迟），
+  // 结束时隐藏窗口并释放截图帧
+  void beginSession(ScreenshotFrameSet::Ptr frames, const QElapsedTimer& trigger = QElapsedTimer());
+  void endSession();
+
+  const DisplayTopology::Ptr& topology() const; // 创建时的显示器拓扑
+  int screenIndex() const;                      // 覆盖层所在的屏幕序号
+  void setFocusOwner(bool owner);               // 是否由本覆盖层持有键盘焦点
+  void syncSelection();                         // 其他屏幕的覆盖层修改了共享的选择区域
+
 signals:
-  // 信号：截图完成，传递选中的区域
+  // 信号：截图完成，传递选中的区域（虚拟桌面坐标）
   void screenshotFinished(const QRect& region);
   // 信号：截图取消
   void screenshotCancelled();
+  // 信号：本覆盖层修改了共享的选择区域
+  void selectionChanged();
+  // 信号：鼠标进入本覆盖层
+  void pointerEntered();
 
 private slots:
   // 工具栏信号处理槽函数
@@ -62,41 +90,78 @@ protected:
   void mouseMoveEvent(QMouseEvent* event) override;    // 鼠标移动事件处理
   void mouseReleaseEvent(QMouseEvent* event) override; // 鼠标释放事件处理
   void keyPressEvent(QKeyEvent* event) override;       // 键盘按键事件处理
+  void wheelEvent(QWheelEvent* event) override;        // 鼠标滚轮事件处理
   void enterEvent(QEnterEvent* event) override;        // 鼠标进入事件处理
   void leaveEvent(QEvent* event) override;             // 鼠标离开事件处理
 
 private:
   // 私有绘制函数
-  void drawInfo(QPainter& painter); // 绘制信息文字
+  void drawInfo(QPainter& painter, const QRect& dirtyRect); // 绘制顶部提示和尺寸标签
 
   // 私有工具函数
-  void createInfoLabels(); // 创建信息标签
-  void createToolbar();    // 创建工具栏
-  void showToolbar();      // 显示工具栏
-  void hideToolbar();      // 隐藏工具栏
+  void createToolbar(); // 创建工具栏
+  void showToolbar();   // 显示工具栏
+  void hideToolbar();   // 隐藏工具栏
+
+  // 选择框装饰标志
+  enum SelectionDecoration
+  {
+    DecorationBorder = 0x1, // 选择框边框
+    DecorationHandles = 0x2 // 调整锚点
+  };
+
+  // 共享选择区域
+  QPoint toGlobal(const QPoint& localPos) const; // 本地坐标换算为虚拟桌面坐标
+  QRect localSelectionRect() const;              // 选择区域（本覆盖层坐标）
+  bool ownsToolbar() const;                      // 工具栏是否显示在本屏幕
+  void notifySelectionChanged();                 // 重绘并通知其他屏幕的覆盖层
+
+  // 脏区域跟踪
+  void scheduleSceneUpdate();       // 请求在下一帧重绘场景
+  void collectSceneDamage();        // 计算场景变化产生的脏区域（每帧一次）
+  bool isMagnifierVisible() const;  // 放大镜当前是否可见
+  int selectionDecorations() const; // 当前选择框的装饰状态（边框、锚点）
 
   // 初始化相关
   void initializeManagers(); // 初始化管理器
   void setupConnections();   // 设置信号连接
   void cleanupManagers();    // 清理管理器
+  void saveMetrics() const;  // 保存帧指标
 
   // 私有成员变量
-  QPixmap m_screenshot;           // 存储全屏截图
-  ScreenshotRenderer* m_renderer; // 渲染器对象
-  ScreenshotToolbar* m_toolbar;   // 工具栏组件
+  DisplayTopology::Ptr m_topology;  // 创建时的显示器拓扑
+  ScreenshotFrameSet::Ptr m_frames; // 所有屏幕的截图帧（导出跨屏选择区域时使用，会话外为空）
+  int m_screenIndex;                // 所在的屏幕序号
+  QPoint m_origin;                  // 屏幕左上角的虚拟桌面坐标
+  ScreenshotFrame::Ptr m_frame;     // 本屏幕的截图帧（会话外为空）
+  ScreenshotRenderer* m_renderer;   // 渲染器对象
+  TileCompositor* m_compositor;     // 分块并行合成器
+  ScreenshotToolbar* m_toolbar;     // 工具栏组件
+  QElapsedTimer m_lifetime;         // 创建后经过的时间
 
   // 管理器对象
-  SelectionManager* m_selectionManager;       // 选择区域管理器
+  SelectionManager* m_selectionManager;       // 选择区域管理器（可能与其他覆盖层共享）
+  bool m_ownsSelectionManager;                // 是否由本覆盖层创建和释放选择区域管理器
   CursorManager* m_cursorManager;             // 光标管理器
   ScreenshotProcessor* m_screenshotProcessor; // 截图处理器
   PerformanceManager* m_performanceManager;   // 性能管理器
   WindowLevelManager* m_windowManager;        // 窗口层级管理器
-  UIManager* m_uiManager;                     // UI管理器
   EventHandler* m_eventHandler;               // 事件处理器
 
   // 当前鼠标位置（仍需要在主类中维护）
   QPoint m_mousePos; // 当前鼠标位置
 
+  // 上一次请求重绘时的场景几何，用于计算脏区域
+  QRect m_lastMagnifierBounds;    // 放大镜覆盖区域
+  QRect m_lastSelectionRect;      // 选择区域
+  QRect m_lastSizeBadgeBounds;    // 尺寸标签覆盖区域
+  int m_lastSelectionDecorations; // 选择框装饰状态
+
+  int m_wheelDelta;               // 未满一格的滚轮累计量（触控板）
+  bool m_magnifierRefreshPending; // 是否已安排等待帧金字塔生成完成的放大镜重绘
+
+  static constexpr int MAGNIFIER_REFRESH_INTERVAL = 16; // 等待帧金字塔时的重绘间隔（毫秒）
+
   // 常量定义（已移动到各个管理器中，此处保留为空或删除）
 };
 
@@ -0,0 +1,180 @@
+#include "ClipboardMimeData.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <chrono>
+
+#include "../../utils/ImageEncoder.h"
+#include "../../utils/QoiCodec.h"
+#include "../../utils/TraceRecorder.h"
+
+namespace
+{
+const QString QT_IMAGE_MIME = QStringLiteral("application/x-qt-image"); // Qt转换为平台原生位图格式
+const QString PNG_MIME = QStringLiteral("image/png");
+const QString BMP_MIME = QStringLiteral("image/bmp");
+const QString QOI_MIME = QStringLiteral("image/qoi"); // 直接提供压缩数据，不需要解码
+} // namespace
+
+// 构造函数
+ClipboardMimeData::ClipboardMimeData(ImageSource source) : m_state(std::make_shared<State>())
+{
+  m_state->source = std::move(source);
+
+  // 后台裁剪并压缩：QOI单遍编码，截图中的大片纯色和文字区域压缩率高
+  std::shared_ptr<State> state = m_state;
+  QThreadPool::globalInstance()->start(
+      [state]()
+      {
+        TraceRecorder::Scope traceScope("clipboard", "compress");
+        QElapsedTimer timer;
+        timer.start();
+
+        ImageSource source;
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          source = state->source;
+        }
+
+        const QImage image = source();
+        QByteArray compressed;
+        QBuffer buffer(&compressed);
+        buffer.open(QIODevice::WriteOnly);
+        QString errorMessage;
+        const bool ok = !image.isNull() && QoiEncoder::write(image, &buffer, &errorMessage);
+        if (ok)
+        {
+          qDebug() << "剪切板数据已压缩，尺寸:" << image.size() << "原始:" << image.sizeInBytes()
+                   << "压缩后:" << compressed.size()
+                   << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms";
+        }
+        else
+        {
+          qWarning() << "剪切板数据压缩失败，粘贴时直接裁剪:" << errorMessage;
+        }
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (ok)
+        {
+          state->compressed = compressed;
+          state->source = nullptr; // 只保留压缩数据，截图帧在最后一个引用释放时回收
+        }
+        state->finished = true;
+        state->ready.notify_all();
+      });
+}
+
+// 析构函数
+ClipboardMimeData::~ClipboardMimeData()
+{
+  qDebug() << "剪切板数据已释放，压缩数据:" << compressedSize() << "字节";
+}
+
+// 提供的格式
+QStringList ClipboardMimeData::formats() const
+{
+  return {QT_IMAGE_MIME, PNG_MIME, BMP_MIME, QOI_MIME};
+}
+
+// 是否提供指定格式
+bool ClipboardMimeData::hasFormat(const QString& mimeType) const
+{
+  return formats().contains(mimeType);
+}
+
+// 等待后台压缩完成
+bool ClipboardMimeData::waitForCompressed(int msecs) const
+{
+  std::unique_lock<std::mutex> lock(m_state->mutex);
+  if (msecs < 0)
+  {
+    m_state->ready.wait(lock, [this]() { return m_state->finished; });
+    return true;
+  }
+  return m_state->ready.wait_for(lock,
+                                 std::chrono::milliseconds(msecs),
+                                 [this]() { return m_state->finished; });
+}
+
+// 压缩数据的字节数
+qsizetype ClipboardMimeData::compressedSize() const
+{
+  std::lock_guard<std::mutex> lock(m_state->mutex);
+  return m_state->compressed.size();
+}
+
+// 按请求的格式生成数据（其他程序粘贴时在GUI线程调用）
+QVariant ClipboardMimeData::retrieveData(const QString& mimeType, QMetaType type) const
+{
+  TraceRecorder::Scope traceScope("clipboard", "retrieve");
+
+  if (mimeType == QOI_MIME)
+  {
+    waitForCompressed();
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (!m_state->compressed.isEmpty())
+    {
+      return m_state->compressed;
+    }
+  }
+
+  if (mimeType == QT_IMAGE_MIME)
+  {
+    return QVariant::fromValue(image());
+  }
+
+  if (mimeType == PNG_MIME || mimeType == BMP_MIME || mimeType == QOI_MIME)
+  {
+    // 粘贴时编码要尽快完成，PNG使用最快的等级
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QString errorMessage;
+    if (!ImageEncoder::write(image(),
+                             &buffer,
+                             mimeType.mid(mimeType.indexOf('/') + 1).toLatin1(),
+                             ImageEncoder::Level::Fast,
+                             -1,
+                             &errorMessage))
+    {
+      qWarning() << "剪切板数据编码失败:" << mimeType << errorMessage;
+      return QVariant();
+    }
+    qDebug() << "剪切板数据已按需编码:" << mimeType << "字节数:" << data.size();
+    return data;
+  }
+
+  return QMimeData::retrieveData(mimeType, type);
+}
+
+// 解码出帧格式的图像
+QImage ClipboardMimeData::image() const
+{
+  waitForCompressed();
+
+  QByteArray compressed;
+  ImageSource source;
+  {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    compressed = m_state->compressed; // 隐式共享，不拷贝数据
+    source = m_state->source;
+  }
+
+  // 压缩失败时保留了图像来源，直接裁剪
+  if (compressed.isEmpty())
+  {
+    return source ? source() : QImage();
+  }
+
+  QBuffer buffer(&compressed);
+  buffer.open(QIODevice::ReadOnly);
+  QString errorMessage;
+  QImage image = QoiDecoder::read(&buffer, &errorMessage);
+  if (image.isNull())
+  {
+    qWarning() << "剪切板数据解码失败:" << errorMessage;
+  }
+  return image;
+}
@@ -0,0 +1,55 @@
+#ifndef CLIPBOARDMIMEDATA_H
+#define CLIPBOARDMIMEDATA_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMimeData>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// 剪切板数据类 - 按需生成各种格式的截图数据
+// 放入剪切板时不裁剪也不编码：后台线程裁剪后立即压缩为QOI并释放截图帧，之后只保留压缩数据；
+// 其他程序粘贴时才解码并编码成请求的格式（PNG、BMP、QOI或QImage），结果不缓存
+class ClipboardMimeData : public QMimeData
+{
+  Q_OBJECT
+
+public:
+  // 生成剪切板图像（在工作线程中调用，通常是从截图帧中裁剪选择区域）
+  using ImageSource = std::function<QImage()>;
+
+  // 构造后立即在后台开始裁剪和压缩
+  explicit ClipboardMimeData(ImageSource source);
+  ~ClipboardMimeData();
+
+  QStringList formats() const override;
+  bool hasFormat(const QString& mimeType) const override;
+
+  bool waitForCompressed(int msecs = -1) const; // 等待后台压缩完成（msecs为-1时一直等待）
+  qsizetype compressedSize() const;             // 压缩数据的字节数（压缩完成前为0）
+
+protected:
+  QVariant retrieveData(const QString& mimeType, QMetaType type) const override;
+
+private:
+  // 后台压缩与剪切板共享的状态（剪切板数据可能先于后台任务销毁）
+  struct State
+  {
+    std::mutex mutex;
+    std::condition_variable ready; // 压缩完成
+    ImageSource source;            // 图像来源（压缩完成后释放，截图帧随之释放）
+    QByteArray compressed;         // QOI压缩数据
+    bool finished = false;         // 压缩是否已完成（失败时compressed为空）
+  };
+
+  QImage image() const; // 解码出帧格式的图像
+
+  std::shared_ptr<State> m_state; // 共享状态
+};
+
+#endif // CLIPBOARDMIMEDATA_H
@@ -0,0 +1,282 @@
+#include "ExportManager.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QThread>
+
+#include "../../utils/TraceRecorder.h"
+
+namespace
+{
+// 写入目标文件的设备：任务取消后写入失败，编码器随之中止
+// 定位转发给目标文件，需要回写文件头的编码器（例如TIFF）也能正确写入
+class CancellableDevice : public QIODevice
+{
+public:
+  CancellableDevice(QIODevice* target, const std::atomic<bool>& cancelled)
+    : m_target(target), m_cancelled(cancelled)
+  {
+  }
+
+  bool isSequential() const override
+  {
+    return m_target->isSequential();
+  }
+
+  bool seek(qint64 pos) override
+  {
+    return QIODevice::seek(pos) && m_target->seek(pos);
+  }
+
+  qint64 size() const override
+  {
+    return m_target->size();
+  }
+
+protected:
+  qint64 readData(char*, qint64) override
+  {
+    return -1;
+  }
+
+  qint64 writeData(const char* data, qint64 size) override
+  {
+    if (m_cancelled.load(std::memory_order_relaxed))
+    {
+      return -1;
+    }
+    return m_target->write(data, size);
+  }
+
+private:
+  QIODevice* m_target;                  // 目标文件
+  const std::atomic<bool>& m_cancelled; // 任务是否已取消
+};
+} // namespace
+
+// 应用共享的导出管理器（随应用对象销毁）
+ExportManager& ExportManager::shared()
+{
+  static ExportManager* manager = new ExportManager(QCoreApplication::instance());
+  return *manager;
+}
+
+// 构造函数
+ExportManager::ExportManager(QObject* parent)
+  : QObject(parent), m_nextJobId(1), m_encodeLevel(ImageEncoder::defaultLevel())
+{
+  // 保留一个核心给GUI线程，编码再慢也不影响界面和下一次截图
+  m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+// 析构函数：已提交的截图仍然写入文件
+ExportManager::~ExportManager()
+{
+  if (!m_jobs.empty())
+  {
+    qDebug() << "等待剩余的导出任务完成，数量:" << m_jobs.size();
+  }
+  m_pool.waitForDone();
+}
+
+// 提交导出任务
+int ExportManager::submit(ImageSource source,
+                          const QString& filePath,
+                          const QByteArray& format,
+                          int quality)
+{
+  auto job = std::make_shared<Job>();
+  job->id = m_nextJobId++;
+  job->source = std::move(source);
+  job->filePath = filePath;
+  job->format = format.isEmpty() ? QFileInfo(filePath).suffix().toLower().toLatin1() : format;
+  job->quality = quality;
+  job->level = m_encodeLevel;
+  if (job->format.isEmpty())
+  {
+    job->format = "png";
+  }
+
+  m_jobs[job->id] = job;
+  m_pool.start([this, job]() { run(job); });
+
+  qDebug() << "导出任务已提交:" << job->id << filePath << "排队:" << m_jobs.size();
+  return job->id;
+}
+
+// 取消任务
+void ExportManager::cancel(int jobId)
+{
+  auto it = m_jobs.find(jobId);
+  if (it != m_jobs.end())
+  {
+    it->second->cancelled.store(true, std::memory_order_relaxed);
+  }
+}
+
+// 取消所有任务
+void ExportManager::cancelAll()
+{
+  for (auto& entry : m_jobs)
+  {
+    entry.second->cancelled.store(true, std::memory_order_relaxed);
+  }
+}
+
+// 设置编码等级
+void ExportManager::setEncodeLevel(ImageEncoder::Level level)
+{
+  m_encodeLevel = level;
+}
+
+// 编码等级
+ImageEncoder::Level ExportManager::encodeLevel() const
+{
+  return m_encodeLevel;
+}
+
+// 尚未结束的任务数
+int ExportManager::pendingCount() const
+{
+  return int(m_jobs.size());
+}
+
+// 等待所有任务结束，并立即发出排队中的结果信号
+bool ExportManager::waitForDone(int msecs)
+{
+  const bool done = m_pool.waitForDone(msecs);
+  QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+  return done;
+}
+
+// 在工作线程中执行任务：裁剪、编码、写入
+void ExportManager::run(const std::shared_ptr<Job>& job)
+{
+  TraceRecorder::Scope traceScope("export", "job");
+  if (job->cancelled.load(std::memory_order_relaxed))
+  {
+    postResult(job->id, Result::Cancelled, QString());
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  postProgress(job->id, 0);
+
+  // 裁剪
+  QImage image;
+  {
+    TraceRecorder::Scope cropScope("export", "crop");
+    image = job->source();
+  }
+  job->source = nullptr; // 单屏裁剪结果引用截图帧，帧在编码完成、图像释放后才回收
+  if (image.isNull())
+  {
+    postResult(job->id, Result::Failed, "裁剪截图失败");
+    return;
+  }
+  if (job->cancelled.load(std::memory_order_relaxed))
+  {
+    postResult(job->id, Result::Cancelled, QString());
+    return;
+  }
+  postProgress(job->id, 30);
+
+  // 编码并写入临时文件，全部成功后才替换目标文件
+  QSaveFile file(job->filePath);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    postResult(job->id, Result::Failed, file.errorString());
+    return;
+  }
+
+  CancellableDevice device(&file, job->cancelled);
+  device.open(QIODevice::WriteOnly);
+
+  // 大尺寸截图的PNG/JPEG在编码线程池中按条带并行压缩；编码进度换算为30~90，
+  // 进度回调可能在多个编码线程中乱序到达，只发送增大的进度
+  std::atomic<int> reported(30);
+  auto encodeProgress = [this, job, &reported](int percent)
+  {
+    const int value = 30 + percent * 60 / 100;
+    int previous = reported.load(std::memory_order_relaxed);
+    while (value > previous && !reported.compare_exchange_weak(previous, value))
+    {
+    }
+    if (value > previous)
+    {
+      postProgress(job->id, value);
+    }
+  };
+
+  bool written = false;
+  QString errorMessage;
+  {
+    TraceRecorder::Scope encodeScope("export", "encode");
+    written = ImageEncoder::write(image, &device, job->format, job->level, job->quality,
+                                  &errorMessage, encodeProgress);
+  }
+  if (job->cancelled.load(std::memory_order_relaxed))
+  {
+    file.cancelWriting();
+    postResult(job->id, Result::Cancelled, QString());
+    return;
+  }
+  if (!written)
+  {
+    file.cancelWriting();
+    postResult(job->id, Result::Failed, errorMessage);
+    return;
+  }
+  postProgress(job->id, 90);
+
+  if (!file.commit())
+  {
+    postResult(job->id, Result::Failed, file.errorString());
+    return;
+  }
+
+  qDebug() << "导出完成:" << job->filePath << "尺寸:" << image.size()
+           << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms";
+  postProgress(job->id, 100);
+  postResult(job->id, Result::Finished, job->filePath);
+}
+
+// 把进度发送到GUI线程
+void ExportManager::postProgress(int jobId, int percent)
+{
+  QMetaObject::invokeMethod(
+      this,
+      [this, jobId, percent]() { emit progressChanged(jobId, percent); },
+      Qt::QueuedConnection);
+}
+
+// 把结果发送到GUI线程，任务随之结束
+void ExportManager::postResult(int jobId, Result result, const QString& message)
+{
+  QMetaObject::invokeMethod(
+      this,
+      [this, jobId, result, message]()
+      {
+        m_jobs.erase(jobId);
+        switch (result)
+        {
+          case Result::Finished:
+            emit exportFinished(jobId, message);
+            break;
+          case Result::Failed:
+            qWarning() << "导出失败:" << jobId << message;
+            emit exportFailed(jobId, message);
+            break;
+          case Result::Cancelled:
+            qDebug() << "导出已取消:" << jobId;
+            emit exportCancelled(jobId);
+            break;
+        }
+      },
+      Qt::QueuedConnection);
+}
@@ -0,0 +1,85 @@
+#ifndef EXPORTMANAGER_H
+#define EXPORTMANAGER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "../../utils/ImageEncoder.h"
+
+// 导出管理器类 - 负责在线程池中裁剪、编码并写入截图文件（PNG/JPEG使用并行编码器）
+// 导出任务持有截图帧的共享指针，覆盖层可以立即关闭，导出期间也可以开始下一次截图
+// 所有信号都在GUI线程中发出；文件通过QSaveFile写入，失败或取消时不会留下不完整的文件
+class ExportManager : public QObject
+{
+  Q_OBJECT
+
+public:
+  // 生成要导出的图像（在工作线程中调用，通常是从截图帧中裁剪选择区域）
+  using ImageSource = std::function<QImage()>;
+
+  // 应用共享的导出管理器（只能在GUI线程调用），应用对象销毁时等待剩余的导出完成
+  static ExportManager& shared();
+
+  explicit ExportManager(QObject* parent = nullptr);
+  ~ExportManager(); // 等待进行中的导出完成
+
+  // 提交导出任务，返回任务编号；format为空时根据文件扩展名选择格式，quality为-1时使用默认质量
+  int submit(ImageSource source,
+             const QString& filePath,
+             const QByteArray& format = QByteArray(),
+             int quality = -1);
+  void cancel(int jobId); // 取消任务（排队中的任务不再执行，编码中的任务在下一次写入时中止）
+  void cancelAll();       // 取消所有任务
+
+  int pendingCount() const;         // 尚未结束的任务数
+  bool waitForDone(int msecs = -1); // 等待所有任务结束（msecs为-1时一直等待）
+
+  // 编码的速度/体积等级（默认由环境变量 OPENCAP_ENCODE_LEVEL 决定），对之后提交的任务生效
+  void setEncodeLevel(ImageEncoder::Level level);
+  ImageEncoder::Level encodeLevel() const;
+
+signals:
+  void progressChanged(int jobId, int percent);              // 导出进度（0~100）
+  void exportFinished(int jobId, const QString& filePath);   // 导出完成
+  void exportFailed(int jobId, const QString& errorMessage); // 导出失败
+  void exportCancelled(int jobId);                           // 导出已取消
+
+private:
+  // 导出任务
+  struct Job
+  {
+    int id = 0;                                                // 任务编号
+    ImageSource source;                                        // 图像来源
+    QString filePath;                                          // 目标文件
+    QByteArray format;                                         // 图像格式
+    int quality = -1;                                          // 编码质量
+    ImageEncoder::Level level = ImageEncoder::Level::Balanced; // 编码等级
+    std::atomic<bool> cancelled{false};                        // 是否已取消
+  };
+
+  // 任务结果
+  enum class Result
+  {
+    Finished,
+    Failed,
+    Cancelled
+  };
+
+  void run(const std::shared_ptr<Job>& job);                         // 在工作线程中执行任务
+  void postProgress(int jobId, int percent);                         // 把进度发送到GUI线程
+  void postResult(int jobId, Result result, const QString& message); // 把结果发送到GUI线程
+
+  QThreadPool m_pool;                         // 导出线程池
+  std::map<int, std::shared_ptr<Job>> m_jobs; // 尚未结束的任务（只在GUI线程访问）
+  int m_nextJobId;                            // 下一个任务编号
+  ImageEncoder::Level m_encodeLevel;          // 编码等级
+};
+
+#endif // EXPORTMANAGER_H
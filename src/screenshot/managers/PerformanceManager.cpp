@@ -1,133 +1,504 @@
 #include "PerformanceManager.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPainter>
+#include <QScreen>
 #include <QWidget>
+#include <QtMath>
+
+#include "../../utils/TraceRecorder.h"
 
 // 构造函数
 PerformanceManager::PerformanceManager(QWidget* widget)
-  : m_widget(widget),
-    m_lastUpdateTime(0),
-    m_throttleTime(DEFAULT_THROTTLE_MS),
+  : QObject(widget),
+    m_widget(widget),
+    m_lastFrameTime(0),
+    m_frameRequestTime(0),
+    m_framePending(false),
+    m_vsyncDriven(isVsyncDrivenPlatform()),
     m_needsFullRedraw(true),
-    m_cachedMagnifierPixmap(),
-    m_cachedMagnifierPos(QPoint(-1, -1))
+    m_paintStartTime(-1),
+    m_lastInputTime(-1),
+    m_pendingInputTime(-1),
+    m_frameCount(0),
+    m_coalescedRequests(0),
+    m_droppedFrames(0),
+    m_debugHudEnabled(qEnvironmentVariableIntValue("OPENCAP_PERF_HUD") != 0),
+    m_sessionWarm(false)
 {
   if (!m_widget)
   {
     qWarning() << "PerformanceManager: widget不能为空";
   }
 
+  for (auto& accumulator : m_stageAccumulators)
+  {
+    accumulator.store(0, std::memory_order_relaxed);
+  }
+
   // 启动高精度计时器
-  m_updateTimer.start();
+  m_frameTimer.start();
+
+  // 节拍定时器到期时直接绘制一帧
+  m_paceTimer.setSingleShot(true);
+  m_paceTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_paceTimer, &QTimer::timeout, this, &PerformanceManager::renderFrame);
 }
 
 // 析构函数
-PerformanceManager::~PerformanceManager() {}
+PerformanceManager::~PerformanceManager()
+{
+  if (m_window)
+  {
+    m_window->removeEventFilter(this);
+  }
+}
 
-// 检查是否应该更新（节流控制）
-bool PerformanceManager::shouldUpdate()
+// 设置每帧绘制前的回调
+void PerformanceManager::setFrameCallback(std::function<void()> callback)
 {
-  // 使用高精度计时器，性能更优且不受系统时间影响
-  qint64 elapsed = m_updateTimer.elapsed();
+  m_frameCallback = std::move(callback);
+}
 
-  // 检查自上次更新以来是否已过足够时间
-  if (elapsed - m_lastUpdateTime < m_throttleTime)
+// 请求在下一帧重绘
+void PerformanceManager::requestFrame()
+{
+  if (!m_widget)
+    return;
+
+  // 触发本次请求的输入事件计入这一帧的输入延迟，同一帧只记录最早的一个
+  if (m_lastInputTime >= 0)
   {
-    return false;
+    if (m_pendingInputTime < 0)
+    {
+      m_pendingInputTime = m_lastInputTime;
+    }
+    m_lastInputTime = -1;
   }
 
-  m_lastUpdateTime = elapsed;
-  return true;
+  // 已有等待中的帧时直接合并；窗口被遮挡等情况下帧事件可能迟迟不来，超时后重新请求
+  qint64 now = m_frameTimer.elapsed();
+  if (m_framePending && now - m_frameRequestTime < FRAME_STALL_MS)
+  {
+    ++m_coalescedRequests;
+    return;
+  }
+
+  QWindow* window = attachWindow();
+  if (!window || !m_widget->isVisible())
+  {
+    // 窗口尚未显示，显示时Qt会完整绘制一次
+    m_framePending = false;
+    m_pendingInputTime = -1;
+    m_needsFullRedraw = false;
+    m_dirtyRegion = QRegion();
+    return;
+  }
+
+  m_framePending = true;
+  m_frameRequestTime = now;
+
+  if (m_vsyncDriven)
+  {
+    // 由显示器刷新信号驱动，帧事件在下一次垂直同步时到达
+    window->requestUpdate();
+    return;
+  }
+
+  // 其他平台的requestUpdate只是固定的短定时器，这里按屏幕实际刷新率安排下一帧
+  qint64 nextFrameTime = m_lastFrameTime + qCeil(refreshInterval());
+  m_paceTimer.start(int(qMax<qint64>(0, nextFrameTime - now)));
+}
+
+// 下一帧完整重绘
+void PerformanceManager::forceFullRedraw()
+{
+  m_needsFullRedraw = true;
+  requestFrame();
+}
+
+// 是否有尚未绘制的帧
+bool PerformanceManager::isFramePending() const
+{
+  return m_framePending;
 }
 
-// 触发优化的更新
-void PerformanceManager::triggerOptimizedUpdate()
+// 当前屏幕的刷新间隔（毫秒），高刷新率屏幕上会相应缩短
+qreal PerformanceManager::refreshInterval() const
 {
+  qreal refreshRate = DEFAULT_REFRESH_RATE;
+  if (m_widget && m_widget->screen() && m_widget->screen()->refreshRate() > 1.0)
+  {
+    refreshRate = m_widget->screen()->refreshRate();
+  }
+  return 1000.0 / refreshRate;
+}
+
+// 拦截窗口的帧更新事件
+bool PerformanceManager::eventFilter(QObject* watched, QEvent* event)
+{
+  if (watched != m_window)
+  {
+    return QObject::eventFilter(watched, event);
+  }
+
+  if (event->type() == QEvent::UpdateRequest && m_framePending)
+  {
+    // 窗口默认会整体重绘，这里只重绘本帧的脏区域
+    renderFrame();
+    return true;
+  }
+
+  // 输入事件先经过窗口再分发到部件，在这里记录到达时间；由它触发的帧请求会认领这个时间
+  if (isInputEvent(event->type()))
+  {
+    m_lastInputTime = m_frameTimer.nsecsElapsed();
+  }
+
+  return QObject::eventFilter(watched, event);
+}
+
+// 执行一帧：收集本帧的脏区域并同步重绘
+void PerformanceManager::renderFrame()
+{
+  m_framePending = false;
+  m_lastFrameTime = m_frameTimer.elapsed();
+  ++m_frameCount;
+
+  // 帧应在请求后的一个刷新周期内到达，每多等待一个周期就错过了一次刷新
+  const qreal interval = refreshInterval();
+  const qreal delay = qreal(m_lastFrameTime - m_frameRequestTime);
+  m_droppedFrames += quint64(qMax(0, qFloor(delay / interval - DROP_TOLERANCE)));
+
+  const qint64 inputTime = m_pendingInputTime;
+  m_pendingInputTime = -1;
+  m_lastInputTime = -1;
+
   if (!m_widget)
     return;
 
-  // 检查是否应该更新
-  if (!shouldUpdate())
+  // 由使用者把这一帧内累计的状态变化转换为脏区域
+  if (m_frameCallback)
+  {
+    m_frameCallback();
+  }
+
+  // 调试HUD随每一帧刷新
+  if (m_debugHudEnabled && !m_dirtyRegion.isEmpty())
+  {
+    m_dirtyRegion += debugHudBounds();
+  }
+
+  // 需要完整重绘时刷新整个窗口，否则只刷新累积的脏区域
+  if (m_needsFullRedraw)
+  {
+    m_needsFullRedraw = false;
+    m_dirtyRegion = QRegion();
+    m_widget->repaint();
+  }
+  else if (!m_dirtyRegion.isEmpty())
+  {
+    QRegion region = m_dirtyRegion;
+    m_dirtyRegion = QRegion();
+    m_widget->repaint(region);
+  }
+  else
   {
     return;
   }
 
-  // 触发重绘
-  m_widget->update();
+  // repaint返回时窗口内容已经提交，输入延迟到此为止
+  if (inputTime >= 0)
+  {
+    m_inputLatency.record(m_frameTimer.nsecsElapsed() - inputTime);
+  }
+}
+
+// 获取并监听窗口的帧更新事件（窗口在部件首次显示时才创建）
+QWindow* PerformanceManager::attachWindow()
+{
+  QWindow* window = m_widget->windowHandle();
+  if (window != m_window)
+  {
+    if (m_window)
+    {
+      m_window->removeEventFilter(this);
+    }
+
+    m_window = window;
+    if (m_window)
+    {
+      m_window->installEventFilter(this);
+      qDebug() << "帧调度已启动，刷新间隔:" << refreshInterval() << "ms"
+               << (m_vsyncDriven ? "（刷新信号驱动）" : "（定时器节拍）");
+    }
+  }
+
+  return m_window;
 }
 
-// 更新放大镜区域
-void PerformanceManager::updateMagnifierRegion()
+// requestUpdate是否由显示器刷新信号驱动（其余平台使用固定的短定时器）
+bool PerformanceManager::isVsyncDrivenPlatform()
 {
-  // 使用优化的更新函数，它包含节流机制
-  triggerOptimizedUpdate();
+  const QString platform = QGuiApplication::platformName();
+  return platform == "cocoa" || platform == "ios" || platform == "android" ||
+         platform.startsWith("wayland");
 }
 
-// 强制完整重绘
-void PerformanceManager::forceFullRedraw()
+// 是否为计入输入延迟的输入事件
+bool PerformanceManager::isInputEvent(QEvent::Type type)
 {
-  m_needsFullRedraw = true;
+  switch (type)
+  {
+    case QEvent::MouseMove:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::Wheel:
+    case QEvent::KeyPress:
+      return true;
+    default:
+      return false;
+  }
+}
 
-  if (m_widget)
+// 阶段名称
+const char* PerformanceManager::stageName(Stage stage)
+{
+  switch (stage)
   {
-    m_widget->update();
+    case Stage::Composite:
+      return "composite";
+    case Stage::Backdrop:
+      return "backdrop";
+    case Stage::Overlay:
+      return "overlay";
+    case Stage::Present:
+      return "present";
+    case Stage::Hud:
+      return "hud";
+    case Stage::Magnifier:
+      return "magnifier";
+    default:
+      return "unknown";
   }
 }
 
-// 清除放大镜缓存
-void PerformanceManager::invalidateMagnifierCache()
+// 阶段计时器
+PerformanceManager::StageTimer::StageTimer(PerformanceManager* manager, Stage stage)
+  : m_manager(manager),
+    m_stage(stage)
 {
-  m_cachedMagnifierPixmap = QPixmap();
-  m_cachedMagnifierPos = QPoint(-1, -1);
+  m_timer.start();
+}
 
-  qDebug() << "放大镜缓存已清除";
+// 阶段计时结束，计入当前帧
+PerformanceManager::StageTimer::~StageTimer()
+{
+  if (m_manager)
+  {
+    m_manager->addStageTime(m_stage, m_timer.nsecsElapsed());
+  }
 }
 
-// 清除所有缓存
-void PerformanceManager::clearAllCaches()
+// 绘制开始
+void PerformanceManager::beginPaint()
 {
-  invalidateMagnifierCache();
-  m_needsFullRedraw = true;
+  m_paintStartTime = m_frameTimer.nsecsElapsed();
+}
 
-  qDebug() << "所有缓存已清除";
+// 绘制结束：记录绘制耗时，并把各阶段的累计耗时提交为一个样本
+void PerformanceManager::endPaint()
+{
+  if (m_paintStartTime < 0)
+  {
+    return;
+  }
+
+  m_paintTime.record(m_frameTimer.nsecsElapsed() - m_paintStartTime);
+  m_paintStartTime = -1;
+
+  // 会话的第一帧：绘制结束后Qt立即把后台存储刷新到屏幕，以此作为首帧可见的时刻
+  if (m_sessionTrigger.isValid())
+  {
+    const qint64 latency = m_sessionTrigger.nsecsElapsed();
+    (m_sessionWarm ? m_warmStartLatency : m_coldStartLatency).record(latency);
+    TraceRecorder::instance().complete("session",
+                                       m_sessionWarm ? "hotkey_to_first_frame_warm"
+                                                     : "hotkey_to_first_frame_cold",
+                                       TraceRecorder::now() - latency,
+                                       latency);
+    qDebug() << "截图启动延迟:" << latency / 1000000.0 << "ms"
+             << (m_sessionWarm ? "（复用覆盖层）" : "（新建覆盖层）");
+    m_sessionTrigger.invalidate();
+  }
+
+  for (int i = 0; i < int(Stage::Count); ++i)
+  {
+    const qint64 elapsed = m_stageAccumulators[i].exchange(0, std::memory_order_relaxed);
+    if (elapsed > 0)
+    {
+      m_stageTimes[i].record(elapsed);
+    }
+  }
 }
 
-// 检查放大镜缓存是否有效
-bool PerformanceManager::isMagnifierCacheValid(const QPoint& mousePos) const
+// 标记会话开始，下一次绘制结束时记录启动延迟
+void PerformanceManager::markSessionStart(const QElapsedTimer& trigger, bool warm)
 {
-  // 如果鼠标位置没有变化，且缓存的像素图有效，则可以重用
-  return !m_cachedMagnifierPixmap.isNull() && m_cachedMagnifierPos == mousePos;
+  m_sessionTrigger = trigger;
+  m_sessionWarm = warm;
 }
 
-// 获取缓存的放大镜像素图
-QPixmap PerformanceManager::getCachedMagnifierPixmap() const
+// 累加阶段耗时（合成线程中各分块的耗时会累加到同一帧）
+void PerformanceManager::addStageTime(Stage stage, qint64 nanoseconds)
 {
-  return m_cachedMagnifierPixmap;
+  m_stageAccumulators[int(stage)].fetch_add(nanoseconds, std::memory_order_relaxed);
 }
 
-// 设置缓存的放大镜像素图
-void PerformanceManager::setCachedMagnifierPixmap(const QPixmap& pixmap, const QPoint& pos)
+// 导出全部指标
+QJsonObject PerformanceManager::metricsToJson() const
 {
-  m_cachedMagnifierPixmap = pixmap;
-  m_cachedMagnifierPos = pos;
+  QJsonObject stages;
+  for (int i = 0; i < int(Stage::Count); ++i)
+  {
+    stages[stageName(Stage(i))] = m_stageTimes[i].toJson();
+  }
+
+  QJsonObject json;
+  json["platform"] = QGuiApplication::platformName();
+  json["refresh_interval_ms"] = refreshInterval();
+  json["device_pixel_ratio"] = m_widget ? m_widget->devicePixelRatioF() : 1.0;
+  json["frames"] = double(m_frameCount);
+  json["coalesced_requests"] = double(m_coalescedRequests);
+  json["dropped_frames"] = double(m_droppedFrames);
+  json["paint"] = m_paintTime.toJson();
+  json["input_latency"] = m_inputLatency.toJson();
+  json["session_start_cold"] = m_coldStartLatency.toJson();
+  json["session_start_warm"] = m_warmStartLatency.toJson();
+  json["stages"] = stages;
+  return json;
 }
 
-// 设置节流时间
-void PerformanceManager::setThrottleTime(int milliseconds)
+// 保存为JSON文件（未绘制过任何帧或没有指定路径时不保存）
+bool PerformanceManager::dumpMetrics(const QString& filePath) const
 {
-  if (milliseconds > 0)
+  const QString path = filePath.isEmpty() ? defaultMetricsPath() : filePath;
+  if (m_paintTime.count() == 0 || path.isEmpty())
   {
-    m_throttleTime = milliseconds;
-    qDebug() << "节流时间已设置为:" << milliseconds << "ms";
+    return false;
   }
-  else
+
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
   {
-    qWarning() << "无效的节流时间:" << milliseconds;
+    qWarning() << "帧指标保存失败:" << path << file.errorString();
+    return false;
   }
+
+  file.write(QJsonDocument(metricsToJson()).toJson(QJsonDocument::Indented));
+  qDebug() << "帧指标已保存:" << path;
+  return true;
 }
 
-// 获取节流时间
-int PerformanceManager::getThrottleTime() const
+// 默认的指标文件路径：OPENCAP_METRICS_FILE指定的路径，未设置时为空（普通截图不写指标文件）
+QString PerformanceManager::defaultMetricsPath()
 {
-  return m_throttleTime;
-}
\ No newline at end of file
+  return qEnvironmentVariable("OPENCAP_METRICS_FILE");
+}
+
+// 设置是否显示调试HUD
+void PerformanceManager::setDebugHudEnabled(bool enabled)
+{
+  if (m_debugHudEnabled == enabled)
+  {
+    return;
+  }
+
+  m_debugHudEnabled = enabled;
+  addDirtyRect(debugHudBounds());
+  requestFrame();
+}
+
+// 是否显示调试HUD
+bool PerformanceManager::isDebugHudEnabled() const
+{
+  return m_debugHudEnabled;
+}
+
+// 调试HUD覆盖的区域
+QRect PerformanceManager::debugHudBounds() const
+{
+  return QRect(10, 10, 330, 10 + (4 + int(Stage::Count)) * 15);
+}
+
+// 绘制调试HUD
+void PerformanceManager::drawDebugHud(QPainter& painter) const
+{
+  auto toMs = [](qint64 nanoseconds) { return QString::number(nanoseconds / 1.0e6, 'f', 2); };
+  auto summary = [&](const char* name, const MetricSeries& series)
+  {
+    return QString("%1 p50 %2  p95 %3  p99 %4")
+        .arg(QString(name), -10)
+        .arg(toMs(series.percentile(0.50)), 6)
+        .arg(toMs(series.percentile(0.95)), 6)
+        .arg(toMs(series.percentile(0.99)), 6);
+  };
+
+  QStringList lines;
+  lines << QString("frames %1  coalesced %2  dropped %3")
+               .arg(m_frameCount)
+               .arg(m_coalescedRequests)
+               .arg(m_droppedFrames);
+  lines << QString("refresh %1 ms (ms below)").arg(refreshInterval(), 0, 'f', 2);
+  lines << summary("paint", m_paintTime);
+  lines << summary("latency", m_inputLatency);
+  for (int i = 0; i < int(Stage::Count); ++i)
+  {
+    lines << summary(stageName(Stage(i)), m_stageTimes[i]);
+  }
+
+  const QRect bounds = debugHudBounds();
+  painter.save();
+  painter.fillRect(bounds, QColor(0, 0, 0, 180));
+  painter.setPen(QColor(0, 255, 128));
+
+  QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+  font.setPixelSize(11);
+  painter.setFont(font);
+  for (int i = 0; i < lines.size(); ++i)
+  {
+    painter.drawText(bounds.left() + 6, bounds.top() + 16 + i * 15, lines[i]);
+  }
+  painter.restore();
+}
+
+// 添加脏矩形
+void PerformanceManager::addDirtyRect(const QRect& rect)
+{
+  if (rect.isValid())
+  {
+    m_dirtyRegion += rect;
+  }
+}
+
+// 添加脏区域
+void PerformanceManager::addDirtyRegion(const QRegion& region)
+{
+  m_dirtyRegion += region;
+}
+
+// 获取待重绘的脏区域
+QRegion PerformanceManager::dirtyRegion() const
+{
+  return m_dirtyRegion;
+}
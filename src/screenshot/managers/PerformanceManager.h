@@ -2,54 +2,133 @@
 #define PERFORMANCEMANAGER_H
 
 #include <QElapsedTimer>
-#include <QPixmap>
-#include <QPoint>
+#include <QObject>
+#include <QPointer>
+#include <QRegion>
+#include <QTimer>
 #include <QWidget>
+#include <QWindow>
+#include <atomic>
+#include <functional>
 
-// 性能管理器类 - 负责性能优化和缓存管理
-class PerformanceManager
+#include "../../utils/MetricSeries.h"
+
+class QPainter;
+
+// 性能管理器类 - 负责帧调度、脏区域、缓存管理和帧指标
+// 所有状态变化只请求一帧，同一帧内的多次请求合并为一次重绘，且最后的状态一定会被绘制
+class PerformanceManager : public QObject
 {
+  Q_OBJECT
+
 public:
+  // 绘制阶段
+  enum class Stage
+  {
+    Composite, // 分块合成（墙钟时间）
+    Backdrop,  // 背景和遮罩（各分块耗时之和）
+    Overlay,   // 选择框和锚点（各分块耗时之和）
+    Present,   // 后台缓冲区呈现到窗口
+    Hud,       // 提示和尺寸标签
+    Magnifier, // 放大镜
+    Count
+  };
+
+  // 阶段计时器：析构时把经过的时间计入当前帧的对应阶段，可在合成线程中使用
+  class StageTimer
+  {
+  public:
+    StageTimer(PerformanceManager* manager, Stage stage);
+    ~StageTimer();
+
+  private:
+    PerformanceManager* m_manager;
+    Stage m_stage;
+    QElapsedTimer m_timer;
+  };
+
   // 构造函数和析构函数
   explicit PerformanceManager(QWidget* widget);
   ~PerformanceManager();
 
-  // 更新控制方法
-  bool shouldUpdate();           // 检查是否应该更新（节流控制）
-  void triggerOptimizedUpdate(); // 触发优化的更新
-  void updateMagnifierRegion();  // 更新放大镜区域
-  void forceFullRedraw();        // 强制完整重绘
+  // 帧调度（与显示器刷新对齐）
+  void setFrameCallback(std::function<void()> callback); // 每帧绘制前调用，用于收集本帧脏区域
+  void requestFrame();                                   // 请求在下一帧重绘
+  void forceFullRedraw();                                // 下一帧完整重绘
+  bool isFramePending() const;                           // 是否有尚未绘制的帧
+  qreal refreshInterval() const;                         // 当前屏幕的刷新间隔（毫秒）
+
+  // 脏区域管理（只重绘发生变化的区域）
+  void addDirtyRect(const QRect& rect);       // 添加脏矩形
+  void addDirtyRegion(const QRegion& region); // 添加脏区域
+  QRegion dirtyRegion() const;                // 获取待重绘的脏区域
+
+  // 帧指标
+  void beginPaint();                                  // 绘制开始（在paintEvent开头调用）
+  void endPaint();                                    // 绘制结束，提交本次绘制的各阶段耗时
+  void addStageTime(Stage stage, qint64 nanoseconds); // 累加阶段耗时，无锁，可在任意线程调用
+  QJsonObject metricsToJson() const;                  // 导出全部指标
 
-  // 缓存管理
-  void invalidateMagnifierCache(); // 清除放大镜缓存
-  void clearAllCaches();           // 清除所有缓存
+  // 会话启动延迟：从触发截图（快捷键）到覆盖层绘制完第一帧，warm表示覆盖层在触发前已创建
+  void markSessionStart(const QElapsedTimer& trigger, bool warm);
+  static QString defaultMetricsPath();                // 默认的指标文件路径（未启用时为空）
 
-  // 缓存状态检查
-  bool isMagnifierCacheValid(const QPoint& mousePos) const;
+  // 保存为JSON文件（路径为空时使用默认路径，默认路径也为空时不保存）
+  bool dumpMetrics(const QString& filePath = QString()) const;
 
-  // 缓存访问
-  QPixmap getCachedMagnifierPixmap() const;
-  void setCachedMagnifierPixmap(const QPixmap& pixmap, const QPoint& pos);
+  // 调试HUD（屏幕左上角显示实时指标）
+  void setDebugHudEnabled(bool enabled);
+  bool isDebugHudEnabled() const;
+  QRect debugHudBounds() const;
+  void drawDebugHud(QPainter& painter) const;
 
-  // 性能配置
-  void setThrottleTime(int milliseconds); // 设置节流时间
-  int getThrottleTime() const;            // 获取节流时间
+protected:
+  bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
+  void renderFrame();                          // 执行一帧：收集脏区域并同步重绘
+  QWindow* attachWindow();                     // 获取并监听窗口的帧更新事件
+  static bool isVsyncDrivenPlatform();         // requestUpdate是否由显示器刷新信号驱动
+  static bool isInputEvent(QEvent::Type type); // 是否为计入输入延迟的输入事件
+  static const char* stageName(Stage stage);   // 阶段名称（用于导出）
+
   QWidget* m_widget; // 关联的窗口部件
 
-  // 性能优化相关
-  QElapsedTimer m_updateTimer; // 高性能更新计时器
-  qint64 m_lastUpdateTime;     // 上次更新时间
-  int m_throttleTime;          // 更新节流时间
-  bool m_needsFullRedraw;      // 是否需要完整重绘
+  // 帧调度
+  QPointer<QWindow> m_window;            // 监听帧更新事件的窗口
+  QTimer m_paceTimer;                    // 无刷新信号的平台上按刷新率节拍的定时器
+  QElapsedTimer m_frameTimer;            // 帧计时器
+  qint64 m_lastFrameTime;                // 上一帧的绘制时间
+  qint64 m_frameRequestTime;             // 当前帧的请求时间
+  bool m_framePending;                   // 是否已请求帧但尚未绘制
+  bool m_vsyncDriven;                    // 是否使用刷新信号驱动的requestUpdate
+  std::function<void()> m_frameCallback; // 每帧绘制前的回调
+  bool m_needsFullRedraw;                // 是否需要完整重绘
+  QRegion m_dirtyRegion;                 // 待重绘的脏区域
+
+  // 帧指标（时间均为m_frameTimer的纳秒读数）
+  MetricSeries m_paintTime;                     // 每次绘制的耗时
+  MetricSeries m_inputLatency;                  // 输入事件到帧呈现的延迟
+  MetricSeries m_stageTimes[int(Stage::Count)]; // 各阶段每帧耗时
+  std::atomic<qint64> m_stageAccumulators[int(Stage::Count)]; // 当前帧各阶段的累计耗时
+  qint64 m_paintStartTime;     // 当前绘制的开始时间
+  qint64 m_lastInputTime;      // 最近一个尚未触发帧请求的输入事件时间
+  qint64 m_pendingInputTime;   // 等待中的帧对应的最早输入事件时间
+  quint64 m_frameCount;        // 已调度的帧数
+  quint64 m_coalescedRequests; // 被合并到等待中的帧的请求数
+  quint64 m_droppedFrames;     // 帧晚于预期到达而错过的刷新周期数
+  bool m_debugHudEnabled;      // 是否显示调试HUD
 
-  // 缓存管理
-  QPixmap m_cachedMagnifierPixmap; // 缓存的放大镜像素图
-  QPoint m_cachedMagnifierPos;     // 缓存的放大镜位置
+  // 会话启动延迟
+  QElapsedTimer m_sessionTrigger;  // 等待第一帧的会话的触发时刻（第一帧绘制后失效）
+  bool m_sessionWarm;              // 该会话是否复用了预先创建的覆盖层
+  MetricSeries m_coldStartLatency; // 覆盖层随会话创建时的启动延迟
+  MetricSeries m_warmStartLatency; // 复用预先创建的覆盖层时的启动延迟
 
   // 常量定义
-  static constexpr int DEFAULT_THROTTLE_MS = 16; // 默认节流时间（约60FPS）
+  static constexpr qreal DEFAULT_REFRESH_RATE = 60.0; // 无法获取屏幕刷新率时使用
+  static constexpr int FRAME_STALL_MS = 100;          // 帧请求超过该时间未响应时重新请求
+  static constexpr qreal DROP_TOLERANCE = 0.25;       // 帧延迟超过刷新周期的该比例才计为丢帧
 };
 
 #endif // PERFORMANCEMANAGER_H
\ No newline at end of file
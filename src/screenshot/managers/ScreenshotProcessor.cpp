@@ -5,12 +5,20 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QDir>
-#include <QScreen>
 #include <QStandardPaths>
 
+#include "ClipboardMimeData.h"
+#include "ExportManager.h"
+
 // 构造函数
-ScreenshotProcessor::ScreenshotProcessor(const QPixmap& screenshot, QObject* parent)
-  : QObject(parent), m_screenshot(screenshot)
+ScreenshotProcessor::ScreenshotProcessor(ScreenshotFrame::Ptr frame, QObject* parent)
+  : QObject(parent), m_frame(std::move(frame))
+{
+}
+
+// 构造函数（虚拟桌面）
+ScreenshotProcessor::ScreenshotProcessor(ScreenshotFrameSet::Ptr frames, QObject* parent)
+  : QObject(parent), m_frames(std::move(frames))
 {
 }
 
@@ -29,22 +37,13 @@ void ScreenshotProcessor::copyToClipboard(const QRect& selectionRect)
     return;
   }
 
-  if (m_screenshot.isNull())
+  if (!hasFrame())
   {
     qWarning() << "截图数据为空，无法复制到剪切板";
     emit processingError("截图数据为空");
     return;
   }
 
-  // 裁剪截图
-  QPixmap croppedPixmap = cropScreenshot(selectionRect);
-  if (croppedPixmap.isNull())
-  {
-    qWarning() << "裁剪截图失败";
-    emit processingError("裁剪截图失败");
-    return;
-  }
-
   // 获取系统剪切板
   QClipboard* clipboard = QApplication::clipboard();
   if (!clipboard)
@@ -54,10 +53,10 @@ void ScreenshotProcessor::copyToClipboard(const QRect& selectionRect)
     return;
   }
 
-  // 将裁剪后的图片保存到剪切板
-  clipboard->setPixmap(croppedPixmap);
+  // 不在这里裁剪和编码：剪切板数据在后台裁剪并压缩，其他程序粘贴时才生成请求的格式
+  clipboard->setMimeData(new ClipboardMimeData(cropSource(selectionRect)));
 
-  qDebug() << "截图已保存到剪切板，最终尺寸:" << croppedPixmap.size();
+  qDebug() << "截图已放入剪切板，逻辑区域:" << selectionRect;
   emit processingFinished();
 }
 
@@ -73,22 +72,13 @@ void ScreenshotProcessor::saveToFile(const QRect& selectionRect)
     return;
   }
 
-  if (m_screenshot.isNull())
+  if (!hasFrame())
   {
     qWarning() << "截图数据为空，无法保存文件";
     emit processingError("截图数据为空");
     return;
   }
 
-  // 裁剪截图
-  QPixmap croppedPixmap = cropScreenshot(selectionRect);
-  if (croppedPixmap.isNull())
-  {
-    qWarning() << "裁剪截图失败";
-    emit processingError("裁剪截图失败");
-    return;
-  }
-
   // 生成文件名
   QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
   QString fileName = QString("screenshot_%1.png").arg(timestamp);
@@ -97,62 +87,83 @@ void ScreenshotProcessor::saveToFile(const QRect& selectionRect)
   QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
   QString filePath = QDir(desktopPath).absoluteFilePath(fileName);
 
-  // 保存截图
-  if (croppedPixmap.save(filePath, "PNG"))
-  {
-    qDebug() << "截图已保存到:" << filePath;
-    emit processingFinished();
-  }
-  else
-  {
-    qWarning() << "保存截图失败:" << filePath;
-    emit processingError(QString("保存文件失败: %1").arg(filePath));
-  }
+  // 裁剪和编码交给导出线程池：任务持有截图帧，覆盖层可以立即关闭
+  ExportManager::shared().submit(cropSource(selectionRect), filePath, "png");
+
+  qDebug() << "截图已加入导出队列:" << filePath;
+  emit processingFinished();
 }
 
-// 设置截图数据
-void ScreenshotProcessor::setScreenshot(const QPixmap& screenshot)
+// 设置截图帧
+void ScreenshotProcessor::setFrame(ScreenshotFrame::Ptr frame)
 {
-  m_screenshot = screenshot;
+  m_frame = std::move(frame);
+  m_frames.reset();
+}
+
+// 设置虚拟桌面截图帧集合
+void ScreenshotProcessor::setFrames(ScreenshotFrameSet::Ptr frames)
+{
+  m_frames = std::move(frames);
+  m_frame.reset();
+}
+
+// 是否有可裁剪的截图数据
+bool ScreenshotProcessor::hasFrame() const
+{
+  return m_frames ? !m_frames->isNull() : m_frame && !m_frame->isNull();
 }
 
 // 裁剪截图
-QPixmap ScreenshotProcessor::cropScreenshot(const QRect& selectionRect) const
+QImage ScreenshotProcessor::cropScreenshot(const QRect& selectionRect) const
 {
+  // 虚拟桌面：按选择区域所在屏幕各自的设备像素比裁剪，跨屏幕时自动拼接
+  if (m_frames)
+  {
+    return m_frames->crop(selectionRect);
+  }
+
   // 调整区域坐标到实际像素
   QRect actualRect = adjustRectForDevicePixelRatio(selectionRect);
 
   qDebug() << "调整后的物理像素区域:" << actualRect;
 
   // 确保裁剪区域不超出截图边界
-  QRect screenshotRect = m_screenshot.rect();
+  QRect screenshotRect = m_frame->rect();
   actualRect = actualRect.intersected(screenshotRect);
 
   qDebug() << "最终裁剪区域:" << actualRect;
 
-  // 从原始截图中裁剪选择区域
-  return m_screenshot.copy(actualRect);
+  // 从帧中裁剪选择区域（零拷贝）
+  return ScreenshotFrame::share(m_frame, actualRect);
+}
+
+// 在工作线程中裁剪选择区域的图像来源
+std::function<QImage()> ScreenshotProcessor::cropSource(const QRect& selectionRect) const
+{
+  // 来源持有截图帧：覆盖层关闭、处理器销毁后仍然可以裁剪；
+  // 裁剪结果直接引用帧的像素，编码器逐行读取，不再复制整个选择区域
+  const ScreenshotFrameSet::Ptr frames = m_frames;
+  const ScreenshotFrame::Ptr frame = m_frame;
+  return [frames, frame, selectionRect]()
+  {
+    if (frames)
+    {
+      return frames->crop(selectionRect);
+    }
+    return ScreenshotFrame::share(frame, frame->mapToDevice(selectionRect));
+  };
 }
 
 // 调整区域坐标到实际像素
 QRect ScreenshotProcessor::adjustRectForDevicePixelRatio(const QRect& logicalRect) const
 {
-  // 获取设备像素比
-  QScreen* screen = QApplication::primaryScreen();
-  qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
+  // 获取帧的设备像素比
+  qreal devicePixelRatio = m_frame->devicePixelRatio();
 
   qDebug() << "设备像素比:" << devicePixelRatio;
-  qDebug() << "原始截图尺寸:" << m_screenshot.size();
-
-  // 如果设备像素比不是1，需要调整选择区域坐标
-  if (devicePixelRatio != 1.0)
-  {
-    // 将逻辑坐标转换为物理像素坐标
-    return QRect(static_cast<int>(logicalRect.x() * devicePixelRatio),
-                 static_cast<int>(logicalRect.y() * devicePixelRatio),
-                 static_cast<int>(logicalRect.width() * devicePixelRatio),
-                 static_cast<int>(logicalRect.height() * devicePixelRatio));
-  }
+  qDebug() << "原始截图尺寸:" << m_frame->size();
 
-  return logicalRect;
+  // 将逻辑坐标转换为物理像素坐标，与覆盖层显示的选择区域逐像素一致
+  return m_frame->mapToDevice(logicalRect);
 }
\ No newline at end of file
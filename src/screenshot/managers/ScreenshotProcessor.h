@@ -1,9 +1,13 @@
 #ifndef SCREENSHOTPROCESSOR_H
 #define SCREENSHOTPROCESSOR_H
 
+#include <QImage>
 #include <QObject>
-#include <QPixmap>
 #include <QRect>
+#include <functional>
+
+#include "../core/ScreenshotFrame.h"
+#include "../core/ScreenshotFrameSet.h"
 
 // 截图处理器类 - 负责截图的保存和剪切板操作
 class ScreenshotProcessor : public QObject
@@ -12,15 +16,21 @@ class ScreenshotProcessor : public QObject
 
 public:
   // 构造函数和析构函数
-  explicit ScreenshotProcessor(const QPixmap& screenshot, QObject* parent = nullptr);
+  explicit ScreenshotProcessor(ScreenshotFrame::Ptr frame, QObject* parent = nullptr);
+  // 处理整个虚拟桌面：选择区域使用虚拟桌面坐标，可以跨越多个屏幕
+  explicit ScreenshotProcessor(ScreenshotFrameSet::Ptr frames, QObject* parent = nullptr);
   ~ScreenshotProcessor();
 
   // 截图处理方法
   void copyToClipboard(const QRect& selectionRect);
-  void saveToFile(const QRect& selectionRect);
+  void saveToFile(const QRect& selectionRect); // 加入导出队列后立即返回，在工作线程中裁剪和编码
+
+  // 设置截图帧
+  void setFrame(ScreenshotFrame::Ptr frame);
+  void setFrames(ScreenshotFrameSet::Ptr frames); // 设置虚拟桌面截图帧集合
 
-  // 设置截图数据
-  void setScreenshot(const QPixmap& screenshot);
+  // 裁剪选择区域（逻辑坐标），返回物理像素的只读图像（单屏时零拷贝引用截图帧）
+  QImage cropScreenshot(const QRect& selectionRect) const;
 
 signals:
   // 处理完成信号
@@ -29,10 +39,13 @@ signals:
 
 private:
   // 私有辅助方法
-  QPixmap cropScreenshot(const QRect& selectionRect) const;
+  bool hasFrame() const; // 是否有可裁剪的截图数据
+  // 在工作线程中裁剪选择区域的图像来源（持有截图帧，供剪切板和导出使用）
+  std::function<QImage()> cropSource(const QRect& selectionRect) const;
   QRect adjustRectForDevicePixelRatio(const QRect& logicalRect) const;
 
-  QPixmap m_screenshot; // 原始截图数据
+  ScreenshotFrame::Ptr m_frame;     // 共享的截图帧（只读）
+  ScreenshotFrameSet::Ptr m_frames; // 共享的虚拟桌面截图帧集合（设置后优先使用）
 };
 
 #endif // SCREENSHOTPROCESSOR_H
\ No newline at end of file
@@ -117,6 +117,17 @@ bool SelectionManager::isSelecting() const
   return m_isSelecting;
 }
 
+// 获取当前选择状态的快照
+SelectionManager::Snapshot SelectionManager::snapshot() const
+{
+  Snapshot snapshot;
+  snapshot.rect = getSelectionRect();
+  snapshot.hasSelection = m_hasSelection;
+  snapshot.isFinished = m_isSelectionFinished;
+  snapshot.isSelecting = m_isSelecting;
+  return snapshot;
+}
+
 // 开始调整大小
 void SelectionManager::startResize(ResizeHandle handle, const QPoint& startPos)
 {
@@ -276,7 +287,7 @@ void SelectionManager::startMove(const QPoint& startPos)
 }
 
 // 更新移动选择框
-void SelectionManager::updateMove(const QPoint& currentPos, int screenWidth, int screenHeight)
+void SelectionManager::updateMove(const QPoint& currentPos, const QRect& bounds)
 {
   if (!m_isMoving)
     return;
@@ -285,15 +296,15 @@ void SelectionManager::updateMove(const QPoint& currentPos, int screenWidth, int
   QRect newRect = m_moveStartRect;
   newRect.translate(delta);
 
-  // 确保选择区域不会超出屏幕边界
-  if (newRect.left() < 0)
-    newRect.moveLeft(0);
-  if (newRect.top() < 0)
-    newRect.moveTop(0);
-  if (newRect.right() >= screenWidth)
-    newRect.moveRight(screenWidth - 1);
-  if (newRect.bottom() >= screenHeight)
-    newRect.moveBottom(screenHeight - 1);
+  // 确保选择区域不会超出屏幕边界（多屏时为整个虚拟桌面）
+  if (newRect.left() < bounds.left())
+    newRect.moveLeft(bounds.left());
+  if (newRect.top() < bounds.top())
+    newRect.moveTop(bounds.top());
+  if (newRect.right() > bounds.right())
+    newRect.moveRight(bounds.right());
+  if (newRect.bottom() > bounds.bottom())
+    newRect.moveBottom(bounds.bottom());
 
   m_startPoint = newRect.topLeft();
   m_currentPoint = newRect.bottomRight();
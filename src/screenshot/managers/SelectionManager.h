@@ -5,6 +5,7 @@
 #include <QRect>
 
 // 选择区域管理器类 - 负责管理截图选择区域的所有逻辑
+// 多屏时由所有屏幕的覆盖层共享，坐标统一使用虚拟桌面的逻辑坐标
 class SelectionManager
 {
 public:
@@ -22,6 +23,15 @@ public:
     BottomRight
   };
 
+  // 选择状态快照（每帧在GUI线程中生成，供绘制线程只读使用）
+  struct Snapshot
+  {
+    QRect rect;                // 选择区域
+    bool hasSelection = false; // 是否已有选择区域
+    bool isFinished = false;   // 是否完成选择
+    bool isSelecting = false;  // 是否正在选择
+  };
+
   // 构造函数和析构函数
   explicit SelectionManager();
   ~SelectionManager();
@@ -37,6 +47,7 @@ public:
   bool hasSelection() const;
   bool isSelectionFinished() const;
   bool isSelecting() const;
+  Snapshot snapshot() const;
 
   // 调整大小相关
   void startResize(ResizeHandle handle, const QPoint& startPos);
@@ -48,7 +59,7 @@ public:
 
   // 移动选择框相关
   void startMove(const QPoint& startPos);
-  void updateMove(const QPoint& currentPos, int screenWidth, int screenHeight);
+  void updateMove(const QPoint& currentPos, const QRect& bounds); // 移动时不超出bounds
   void finishMove();
   bool isMoving() const;
   bool isInsideSelection(const QPoint& pos) const;
@@ -3,7 +3,8 @@
 #include <QApplication>
 #include <QCursor>
 #include <QDebug>
-#include <QScreen>
+
+#include "../core/DisplayTopology.h"
 
 #ifdef Q_OS_MACOS
   #include <QWindow>
@@ -133,6 +134,12 @@ void WindowLevelManager::setupWindow()
   setGeometryToFullScreen();
 }
 
+// 设置窗口覆盖的屏幕
+void WindowLevelManager::setScreenGeometry(const QRect& geometry)
+{
+  m_screenGeometry = geometry;
+}
+
 // 开始焦点监控
 void WindowLevelManager::startFocusMonitoring()
 {
@@ -202,7 +209,6 @@ void WindowLevelManager::setupWindowAttributes()
   if (!m_widget)
     return;
 
-  m_widget->setAttribute(Qt::WA_DeleteOnClose);      // 关闭时自动删除
   m_widget->setAttribute(Qt::WA_NoSystemBackground); // 不使用系统背景
   m_widget->setAttribute(Qt::WA_OpaquePaintEvent);   // 不透明绘制事件
   m_widget->setAttribute(Qt::WA_AlwaysShowToolTips); // 始终显示工具提示
@@ -221,18 +227,25 @@ void WindowLevelManager::setGeometryToFullScreen()
   if (!m_widget)
     return;
 
-  // 手动设置窗口几何覆盖整个屏幕，包括状态栏
-  QScreen* screen = QApplication::primaryScreen();
-  if (screen)
+  // 指定了屏幕时直接覆盖该屏幕
+  if (m_screenGeometry.isValid())
+  {
+    m_widget->setGeometry(m_screenGeometry);
+    qDebug() << "设置窗口几何:" << m_screenGeometry;
+    return;
+  }
+
+  // 手动设置窗口几何覆盖整个主屏幕，包括状态栏（几何信息来自缓存的显示器拓扑）
+  DisplayTopology::Ptr topology = DisplayTopology::current();
+  if (!topology->isEmpty())
   {
-    // 获取完整屏幕区域（包含状态栏），但要考虑设备像素比
-    QRect fullGeometry = screen->geometry();
-    qreal devicePixelRatio = screen->devicePixelRatio();
+    const DisplayTopology::Screen& screen = topology->screen(topology->primaryIndex());
+    QRect fullGeometry = screen.geometry;
 
     qDebug() << "屏幕几何信息:";
-    qDebug() << "  - screen->geometry():" << fullGeometry;
-    qDebug() << "  - screen->availableGeometry():" << screen->availableGeometry();
-    qDebug() << "  - devicePixelRatio:" << devicePixelRatio;
+    qDebug() << "  - 屏幕:" << screen.name;
+    qDebug() << "  - geometry:" << fullGeometry;
+    qDebug() << "  - devicePixelRatio:" << screen.devicePixelRatio;
 
     // 设置窗口覆盖完整屏幕，从(0,0)开始
     m_widget->setGeometry(fullGeometry);
@@ -1,6 +1,7 @@
 #ifndef WINDOWLEVELMANAGER_H
 #define WINDOWLEVELMANAGER_H
 
+#include <QRect>
 #include <QTimer>
 #include <QWidget>
 
@@ -19,6 +20,9 @@ public:
   void ensureWindowActive(); // 确保窗口保持活跃状态
   void setupWindow();        // 设置窗口属性和层级
 
+  // 窗口覆盖的屏幕（逻辑几何），未设置时覆盖主屏幕
+  void setScreenGeometry(const QRect& geometry);
+
   // 焦点管理
   void startFocusMonitoring();                  // 开始焦点监控
   void stopFocusMonitoring();                   // 停止焦点监控
@@ -31,6 +35,7 @@ private:
   QWidget* m_widget;        // 关联的窗口部件
   QTimer* m_focusTimer;     // 焦点检查定时器
   int m_focusCheckInterval; // 焦点检查间隔
+  QRect m_screenGeometry;   // 窗口覆盖的屏幕
 
   // 私有辅助方法
   void setupWindowFlags();        // 设置窗口标志
@@ -0,0 +1,205 @@
+#include "HudLayer.h"
+
+#include <QFontMetrics>
+
+#include "../core/ScreenshotFrame.h"
+
+// 构造函数
+HudLayer::HudLayer() : m_zoomTextWidth(0), m_hexColor(0), m_readoutValid(false)
+{
+  // 顶部提示：灰色半透明圆角背景
+  m_hint.font.setFamily("Arial");
+  m_hint.font.setPixelSize(14);
+  m_hint.background = QColor(125, 125, 125, 180);
+  m_hint.radius = 4;
+  m_hint.bakeText = true;
+  setPanelText(m_hint, "拖拽选择截图区域，按 ESC 键取消");
+
+  // 尺寸标签：深色圆角背景
+  m_sizeBadge.font.setFamily("Arial");
+  m_sizeBadge.font.setPixelSize(10);
+  m_sizeBadge.background = QColor(0x29, 0x2c, 0x33);
+  m_sizeBadge.radius = 6;
+
+  // 放大镜信息
+  m_magnifierFont.setFamily("Arial");
+  m_magnifierFont.setPixelSize(11);
+  m_magnifierAscent = QFontMetrics(m_magnifierFont).ascent();
+  setupStaticText(m_coordText);
+  setupStaticText(m_hexText);
+  setupStaticText(m_copyHint);
+  setupStaticText(m_zoomText);
+  m_copyHint.setText("按c复制色值");
+}
+
+// 设置顶部提示文字
+void HudLayer::setHintText(const QString& text)
+{
+  setPanelText(m_hint, text);
+}
+
+// 顶部提示覆盖的区域（屏幕顶部居中）
+QRect HudLayer::hintBounds(int widgetWidth) const
+{
+  return QRect(QPoint((widgetWidth - m_hint.size.width()) / 2, HINT_TOP), m_hint.size);
+}
+
+// 绘制顶部提示
+void HudLayer::drawHint(QPainter& painter, int widgetWidth)
+{
+  drawPanel(painter, m_hint, hintBounds(widgetWidth).topLeft());
+}
+
+// 尺寸标签覆盖的区域
+QRect HudLayer::sizeBadgeBounds(const QRect& selectionRect, int widgetWidth)
+{
+  if (!selectionRect.isValid())
+    return QRect();
+
+  updateSizeBadge(selectionRect.size());
+  const QSize size = m_sizeBadge.size;
+
+  // 默认显示在选择框左上角的上方
+  int x = selectionRect.x();
+  int y = selectionRect.y() - BADGE_MARGIN - size.height();
+
+  // 如果标签会超出屏幕上边界，则显示在选择框内部左上角
+  if (y < SCREEN_MARGIN)
+  {
+    y = selectionRect.y();
+  }
+
+  // 确保标签不会超出屏幕右边界
+  if (x + size.width() > widgetWidth)
+  {
+    x = widgetWidth - size.width() - SCREEN_MARGIN;
+  }
+
+  return QRect(QPoint(x, y), size);
+}
+
+// 绘制尺寸标签
+void HudLayer::drawSizeBadge(QPainter& painter, const QRect& selectionRect, int widgetWidth)
+{
+  QRect bounds = sizeBadgeBounds(selectionRect, widgetWidth);
+  if (!bounds.isEmpty())
+  {
+    drawPanel(painter, m_sizeBadge, bounds.topLeft());
+  }
+}
+
+// 设置缩放倍数文字
+void HudLayer::setZoomText(const QString& text)
+{
+  m_zoomText.setText(text);
+  m_zoomTextWidth = QFontMetrics(m_magnifierFont).horizontalAdvance(text);
+}
+
+// 绘制放大镜信息
+void HudLayer::drawMagnifierInfo(QPainter& painter,
+                                 const QRect& infoRect,
+                                 const QPoint& pos,
+                                 QRgb color)
+{
+  // 坐标和色值只在变化时重新生成文字
+  if (!m_readoutValid || pos != m_coordPos)
+  {
+    m_coordText.setText(QString("坐标: (%1, %2)").arg(pos.x()).arg(pos.y()));
+    m_coordPos = pos;
+  }
+  if (!m_readoutValid || color != m_hexColor)
+  {
+    m_hexText.setText(QString("色值: #%1").arg(color & 0xFFFFFF, 6, 16, QChar('0')).toUpper());
+    m_hexColor = color;
+  }
+  m_readoutValid = true;
+
+  painter.fillRect(infoRect, QColor(0, 0, 0, 200));
+  painter.setFont(m_magnifierFont);
+  painter.setPen(QColor(160, 160, 160));
+
+  // 三行文字的基线位于信息区域顶部下方13、28、43像素处
+  const int left = infoRect.x() + INFO_PADDING;
+  const int top = infoRect.y() + 13 - m_magnifierAscent;
+  painter.drawStaticText(left, top, m_coordText);
+  painter.drawStaticText(left, top + INFO_LINE_HEIGHT, m_hexText);
+  painter.drawStaticText(left, top + INFO_LINE_HEIGHT * 2, m_copyHint);
+
+  // 缩放倍数显示在最后一行右侧
+  const int zoomLeft = infoRect.right() + 1 - INFO_PADDING - m_zoomTextWidth;
+  painter.drawStaticText(zoomLeft, top + INFO_LINE_HEIGHT * 2, m_zoomText);
+}
+
+// 更新面板文字，并按文字尺寸加上内边距计算面板尺寸
+void HudLayer::setPanelText(Panel& panel, const QString& text)
+{
+  setupStaticText(panel.text);
+  panel.text.setText(text);
+  panel.text.prepare(QTransform(), panel.font);
+
+  QFontMetrics metrics(panel.font);
+  panel.size = QSize(metrics.horizontalAdvance(text) + PANEL_PADDING_X * 2,
+                     metrics.height() + PANEL_PADDING_Y * 2);
+
+  // 文字烘焙在背景中的面板需要重新栅格化
+  if (panel.bakeText)
+  {
+    panel.sprite = QImage();
+  }
+}
+
+// 绘制面板：背景图像只在尺寸或设备像素比变化时重新栅格化
+void HudLayer::drawPanel(QPainter& painter, Panel& panel, const QPoint& topLeft)
+{
+  const qreal devicePixelRatio = painter.device()->devicePixelRatioF();
+  if (panel.sprite.isNull() || panel.spriteSize != panel.size ||
+      panel.spriteRatio != devicePixelRatio)
+  {
+    QSize deviceSize = (QSizeF(panel.size) * devicePixelRatio).toSize();
+    panel.sprite = QImage(deviceSize, ScreenshotFrameView::FORMAT);
+    panel.sprite.setDevicePixelRatio(devicePixelRatio);
+    panel.sprite.fill(Qt::transparent);
+    panel.spriteSize = panel.size;
+    panel.spriteRatio = devicePixelRatio;
+
+    QPainter spritePainter(&panel.sprite);
+    spritePainter.setRenderHint(QPainter::Antialiasing);
+    spritePainter.setPen(Qt::NoPen);
+    spritePainter.setBrush(panel.background);
+    spritePainter.drawRoundedRect(QRect(QPoint(0, 0), panel.size), panel.radius, panel.radius);
+
+    if (panel.bakeText)
+    {
+      spritePainter.setFont(panel.font);
+      spritePainter.setPen(Qt::white);
+      spritePainter.drawStaticText(PANEL_PADDING_X, PANEL_PADDING_Y, panel.text);
+    }
+  }
+
+  painter.drawImage(topLeft, panel.sprite);
+
+  if (!panel.bakeText)
+  {
+    painter.setFont(panel.font);
+    painter.setPen(Qt::white);
+    painter.drawStaticText(topLeft + QPoint(PANEL_PADDING_X, PANEL_PADDING_Y), panel.text);
+  }
+}
+
+// 设置静态文字的排版选项
+void HudLayer::setupStaticText(QStaticText& text)
+{
+  text.setTextFormat(Qt::PlainText);
+  text.setPerformanceHint(QStaticText::AggressiveCaching);
+}
+
+// 选择区域尺寸变化时更新标签文字
+void HudLayer::updateSizeBadge(const QSize& selectionSize)
+{
+  if (selectionSize == m_badgeSelection && !m_sizeBadge.size.isEmpty())
+    return;
+
+  m_badgeSelection = selectionSize;
+  setPanelText(m_sizeBadge,
+               QString("%1 × %2").arg(selectionSize.width()).arg(selectionSize.height()));
+}
@@ -0,0 +1,82 @@
+#ifndef HUDLAYER_H
+#define HUDLAYER_H
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QPainter>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+
+// HUD层 - 由渲染器直接绘制的顶部提示、选择区域尺寸标签和放大镜信息
+// 文字使用QStaticText缓存排版结果，面板背景预先栅格化为图像，内容不变时每帧只需贴图
+class HudLayer
+{
+public:
+  HudLayer();
+
+  // 顶部提示
+  void setHintText(const QString& text);
+  QRect hintBounds(int widgetWidth) const;
+  void drawHint(QPainter& painter, int widgetWidth);
+
+  // 选择区域尺寸标签（显示在选择框左上角）
+  QRect sizeBadgeBounds(const QRect& selectionRect, int widgetWidth);
+  void drawSizeBadge(QPainter& painter, const QRect& selectionRect, int widgetWidth);
+
+  // 放大镜下方的坐标、色值和缩放信息
+  void setZoomText(const QString& text);
+  void drawMagnifierInfo(QPainter& painter, const QRect& infoRect, const QPoint& pos, QRgb color);
+
+private:
+  // 带圆角背景的文字面板
+  struct Panel
+  {
+    QFont font;            // 文字字体
+    QStaticText text;      // 面板文字
+    QSize size;            // 面板尺寸（逻辑像素）
+    QColor background;     // 背景颜色
+    int radius = 0;        // 圆角半径
+    bool bakeText = false; // 文字是否烘焙进背景图像（内容固定的面板）
+
+    QImage sprite;           // 预先栅格化的背景
+    QSize spriteSize;        // 背景图像对应的面板尺寸
+    qreal spriteRatio = 0.0; // 背景图像对应的设备像素比
+  };
+
+  // 私有辅助函数
+  static void setPanelText(Panel& panel, const QString& text);
+  static void drawPanel(QPainter& painter, Panel& panel, const QPoint& topLeft);
+  static void setupStaticText(QStaticText& text);
+  void updateSizeBadge(const QSize& selectionSize);
+
+  Panel m_hint;           // 顶部提示面板（文字固定，直接烘焙进背景）
+  Panel m_sizeBadge;      // 尺寸标签面板
+  QSize m_badgeSelection; // 尺寸标签当前对应的选择区域尺寸
+
+  // 放大镜信息文字，只在内容变化时重新排版
+  QFont m_magnifierFont;   // 放大镜信息字体（只创建一次）
+  int m_magnifierAscent;   // 字体上升高度，用于从基线换算文字顶部
+  QStaticText m_coordText; // 坐标
+  QStaticText m_hexText;   // 色值
+  QStaticText m_copyHint;  // 复制提示
+  QStaticText m_zoomText;  // 缩放倍数
+  int m_zoomTextWidth;     // 缩放倍数文字宽度（右对齐用）
+  QPoint m_coordPos;       // 坐标文字对应的位置
+  QRgb m_hexColor;         // 色值文字对应的颜色
+  bool m_readoutValid;     // 坐标和色值文字是否已生成
+
+  // 常量定义
+  static constexpr int PANEL_PADDING_X = 20;  // 面板水平内边距
+  static constexpr int PANEL_PADDING_Y = 8;   // 面板垂直内边距
+  static constexpr int HINT_TOP = 40;         // 顶部提示的纵坐标
+  static constexpr int BADGE_MARGIN = 8;      // 尺寸标签与选择框的间距
+  static constexpr int SCREEN_MARGIN = 4;     // 与屏幕边缘的最小间距
+  static constexpr int INFO_PADDING = 5;      // 放大镜信息文字的左右内边距
+  static constexpr int INFO_LINE_HEIGHT = 15; // 放大镜信息文字行高
+};
+
+#endif // HUDLAYER_H
@@ -0,0 +1,364 @@
+#include "IconAtlas.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QPixmap>
+#include <QResource>
+#include <QSaveFile>
+#include <QScreen>
+#include <QStandardPaths>
+#include <QSvgRenderer>
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+constexpr quint32 ATLAS_MAGIC = 0x4149434F; // "OCIA"，同时用于识别字节序
+constexpr quint32 ATLAS_VERSION = 1;        // 文件格式或栅格化方式变化时加一
+constexpr int PIXEL_ALIGNMENT = 64;         // 像素数据在文件中的对齐字节数
+constexpr int NAME_LENGTH = 48;             // 图标文件名的最大长度（含结尾的0）
+constexpr QImage::Format ATLAS_FORMAT = QImage::Format_ARGB32_Premultiplied; // 与截图帧格式一致
+
+// 缓存文件头（按本机字节序写入，其他机器生成的缓存会因魔数不一致而重新生成）
+struct FileHeader
+{
+  quint32 magic;
+  quint32 version;
+  char key[20];        // 资源内容和像素尺寸的SHA-1摘要
+  qint32 width;        // 图集宽度
+  qint32 height;       // 图集高度
+  qint32 bytesPerLine; // 每行字节数
+  qint32 entryCount;   // 图标条目数
+  quint32 pixelOffset; // 像素数据在文件中的偏移
+};
+
+// 图标条目
+struct FileEntry
+{
+  char name[NAME_LENGTH];
+  qint32 x;
+  qint32 y;
+  qint32 size;
+};
+
+static_assert(sizeof(FileHeader) == 48, "FileHeader必须没有填充字节");
+static_assert(sizeof(FileEntry) == NAME_LENGTH + 12, "FileEntry必须没有填充字节");
+} // namespace
+
+// 应用共享的图集
+IconAtlas& IconAtlas::shared()
+{
+  // 有意不释放：工具栏的图标在程序退出前一直引用图集的内存
+  static IconAtlas* atlas = new IconAtlas(defaultCachePath(), defaultPixelSizes());
+  return *atlas;
+}
+
+// 构造函数：优先映射磁盘缓存，不可用时重新生成
+IconAtlas::IconAtlas(const QString& cachePath, const QList<int>& pixelSizes)
+  : m_cachePath(cachePath),
+    m_pixelSizes(pixelSizes),
+    m_mapped(nullptr),
+    m_loadedFromCache(false)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  const QByteArray key = cacheKey();
+  m_loadedFromCache = load(key);
+  if (!m_loadedFromCache)
+  {
+    build(key);
+  }
+
+  qDebug() << "图标图集" << (m_loadedFromCache ? "已映射" : "已生成") << "图标数:"
+           << m_entries.size() << "尺寸:" << m_image.size()
+           << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms";
+}
+
+// 析构函数
+IconAtlas::~IconAtlas()
+{
+  // 先释放引用映射内存的图标和图像，再解除映射
+  m_icons.clear();
+  m_image = QImage();
+  if (m_mapped)
+  {
+    m_file.unmap(m_mapped);
+  }
+}
+
+// 图集是否可用
+bool IconAtlas::isValid() const
+{
+  return !m_image.isNull() && !m_entries.empty();
+}
+
+// 是否直接映射了磁盘缓存
+bool IconAtlas::isLoadedFromCache() const
+{
+  return m_loadedFromCache;
+}
+
+// 图集中的图标
+QIcon IconAtlas::icon(const QString& iconFileName)
+{
+  auto cached = m_icons.constFind(iconFileName);
+  if (cached != m_icons.constEnd())
+  {
+    return cached.value();
+  }
+
+  // 图集区域先包装为图像（引用图集内存），转换为像素图时拷贝一次；省掉的是SVG的解析和绘制
+  QIcon result;
+  for (const Entry& entry : m_entries)
+  {
+    if (entry.name != iconFileName)
+    {
+      continue;
+    }
+
+    const QImage tile(m_image.constBits() + qsizetype(entry.rect.y()) * m_image.bytesPerLine() +
+                          entry.rect.x() * 4,
+                      entry.rect.width(),
+                      entry.rect.height(),
+                      m_image.bytesPerLine(),
+                      m_image.format());
+    result.addPixmap(QPixmap::fromImage(tile));
+  }
+
+  m_icons.insert(iconFileName, result);
+  return result;
+}
+
+// 资源中的全部SVG图标
+QStringList IconAtlas::iconNames()
+{
+  return QDir(":/icons").entryList({"*.svg"}, QDir::Files, QDir::Name);
+}
+
+// 默认的缓存文件路径
+QString IconAtlas::defaultCachePath()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/icon-atlas.bin";
+}
+
+// 默认的像素尺寸：原有的16/24/32/48，加上各屏幕缩放比例下工具栏图标的物理像素尺寸
+QList<int> IconAtlas::defaultPixelSizes()
+{
+  QList<int> sizes = {16, 24, 32, 48};
+  for (QScreen* screen : QGuiApplication::screens())
+  {
+    const int size = qCeil(TOOLBAR_ICON_SIZE * screen->devicePixelRatio());
+    if (!sizes.contains(size))
+    {
+      sizes.append(size);
+    }
+  }
+  std::sort(sizes.begin(), sizes.end());
+  return sizes;
+}
+
+// 资源内容和像素尺寸的摘要（直接读取资源的原始数据，不解压）
+QByteArray IconAtlas::cacheKey() const
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(ATLAS_VERSION));
+  for (int size : m_pixelSizes)
+  {
+    hash.addData(QByteArray::number(size) + ',');
+  }
+  for (const QString& name : iconNames())
+  {
+    QResource resource(":/icons/" + name);
+    hash.addData(name.toUtf8());
+    hash.addData(QByteArray::number(int(resource.compressionAlgorithm())));
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(resource.data()), resource.size()));
+  }
+  return hash.result();
+}
+
+// 映射磁盘缓存
+bool IconAtlas::load(const QByteArray& key)
+{
+  m_file.setFileName(m_cachePath);
+  if (!m_file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  const qint64 fileSize = m_file.size();
+  if (fileSize < qint64(sizeof(FileHeader)))
+  {
+    m_file.close();
+    return false;
+  }
+
+  uchar* data = m_file.map(0, fileSize);
+  if (!data)
+  {
+    qWarning() << "图标图集缓存映射失败:" << m_cachePath << m_file.errorString();
+    m_file.close();
+    return false;
+  }
+
+  // 校验文件头和各部分的范围，任何不一致都视为缓存过期
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  const qint64 entriesEnd =
+      qint64(sizeof(FileHeader)) + qint64(header.entryCount) * qint64(sizeof(FileEntry));
+  const bool valid =
+      header.magic == ATLAS_MAGIC && header.version == ATLAS_VERSION &&
+      QByteArray(header.key, sizeof(header.key)) == key && header.width > 0 && header.height > 0 &&
+      header.bytesPerLine >= header.width * 4 && header.entryCount > 0 &&
+      header.pixelOffset % PIXEL_ALIGNMENT == 0 && entriesEnd <= header.pixelOffset &&
+      qint64(header.pixelOffset) + qint64(header.height) * header.bytesPerLine <= fileSize;
+  if (!valid)
+  {
+    m_file.unmap(data);
+    m_file.close();
+    return false;
+  }
+
+  const QRect bounds(0, 0, header.width, header.height);
+  std::vector<Entry> entries;
+  entries.reserve(size_t(header.entryCount));
+  for (int i = 0; i < header.entryCount; ++i)
+  {
+    FileEntry fileEntry;
+    std::memcpy(&fileEntry, data + sizeof(FileHeader) + size_t(i) * sizeof(FileEntry),
+                sizeof(fileEntry));
+    fileEntry.name[NAME_LENGTH - 1] = '\0';
+
+    Entry entry;
+    entry.name = QString::fromUtf8(fileEntry.name);
+    entry.rect = QRect(fileEntry.x, fileEntry.y, fileEntry.size, fileEntry.size);
+    if (!bounds.contains(entry.rect))
+    {
+      m_file.unmap(data);
+      m_file.close();
+      return false;
+    }
+    entries.push_back(entry);
+  }
+
+  // 图像直接引用映射的内存（只读映射，使用const构造函数，写入时会先拷贝）
+  m_mapped = data;
+  m_entries = std::move(entries);
+  m_image = QImage(static_cast<const uchar*>(data) + header.pixelOffset,
+                   header.width,
+                   header.height,
+                   header.bytesPerLine,
+                   ATLAS_FORMAT);
+  return true;
+}
+
+// 栅格化所有SVG并写入磁盘缓存
+void IconAtlas::build(const QByteArray& key)
+{
+  const QStringList names = iconNames();
+
+  // 按尺寸从大到小逐行排列，每行高度等于该行第一个图标的尺寸
+  QList<int> sizes = m_pixelSizes;
+  std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+  std::vector<Entry> entries;
+  int x = 0;
+  int y = 0;
+  int rowHeight = 0;
+  for (int size : sizes)
+  {
+    for (const QString& name : names)
+    {
+      if (x + size > ATLAS_WIDTH)
+      {
+        x = 0;
+        y += rowHeight;
+        rowHeight = 0;
+      }
+      entries.push_back({name, QRect(x, y, size, size)});
+      x += size;
+      rowHeight = qMax(rowHeight, size);
+    }
+  }
+
+  QImage image(ATLAS_WIDTH, qMax(1, y + rowHeight), ATLAS_FORMAT);
+  if (image.isNull() || names.isEmpty())
+  {
+    qWarning() << "图标图集生成失败，图标数:" << names.size();
+    return;
+  }
+  image.fill(Qt::transparent);
+
+  // 每个SVG只解析一次，按所有尺寸绘制后着色为白色，保持形状不变
+  QPainter painter(&image);
+  painter.setRenderHint(QPainter::Antialiasing);
+  for (const QString& name : names)
+  {
+    QSvgRenderer svgRenderer(":/icons/" + name);
+    if (!svgRenderer.isValid())
+    {
+      qWarning() << "无法解析图标:" << name;
+      continue;
+    }
+
+    for (const Entry& entry : entries)
+    {
+      if (entry.name != name)
+      {
+        continue;
+      }
+      painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+      svgRenderer.render(&painter, QRectF(entry.rect));
+      painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+      painter.fillRect(entry.rect, Qt::white);
+    }
+  }
+  painter.end();
+
+  m_image = image;
+  m_entries = std::move(entries);
+
+  // 写入缓存：文件头、条目、按对齐填充后的像素数据
+  FileHeader header = {};
+  header.magic = ATLAS_MAGIC;
+  header.version = ATLAS_VERSION;
+  std::memcpy(header.key, key.constData(), qMin(size_t(key.size()), sizeof(header.key)));
+  header.width = image.width();
+  header.height = image.height();
+  header.bytesPerLine = int(image.bytesPerLine());
+  header.entryCount = int(m_entries.size());
+  const qint64 entriesEnd =
+      qint64(sizeof(FileHeader)) + qint64(header.entryCount) * qint64(sizeof(FileEntry));
+  header.pixelOffset =
+      quint32((entriesEnd + PIXEL_ALIGNMENT - 1) / PIXEL_ALIGNMENT * PIXEL_ALIGNMENT);
+
+  QByteArray data;
+  data.reserve(qsizetype(header.pixelOffset) + image.sizeInBytes());
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const Entry& entry : m_entries)
+  {
+    FileEntry fileEntry = {};
+    const QByteArray name = entry.name.toUtf8();
+    std::memcpy(fileEntry.name, name.constData(), size_t(qMin(name.size(), NAME_LENGTH - 1)));
+    fileEntry.x = entry.rect.x();
+    fileEntry.y = entry.rect.y();
+    fileEntry.size = entry.rect.width();
+    data.append(reinterpret_cast<const char*>(&fileEntry), sizeof(fileEntry));
+  }
+  data.append(qsizetype(header.pixelOffset) - data.size(), '\0');
+  data.append(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes());
+
+  // 先写临时文件再替换，其他进程不会映射到写了一半的缓存
+  QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+  QSaveFile file(m_cachePath);
+  if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+  {
+    qWarning() << "无法写入图标图集缓存:" << m_cachePath << file.errorString();
+  }
+}
@@ -0,0 +1,68 @@
+#ifndef ICONATLAS_H
+#define ICONATLAS_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+// 图标图集 - 所有工具栏图标预先着色为白色并按多个像素尺寸栅格化到一张图像中
+// 图集缓存在磁盘上，之后启动时直接内存映射，创建工具栏时不再解析和绘制SVG
+// 缓存以SVG资源内容和像素尺寸为键，图标或屏幕缩放比例变化后自动重新生成
+class IconAtlas
+{
+public:
+  // 应用共享的图集（只能在GUI线程调用），第一次访问时加载或生成
+  static IconAtlas& shared();
+
+  // 加载cachePath处的图集，缓存不存在或已过期时重新生成并写入缓存
+  IconAtlas(const QString& cachePath, const QList<int>& pixelSizes);
+  ~IconAtlas();
+
+  IconAtlas(const IconAtlas&) = delete;
+  IconAtlas& operator=(const IconAtlas&) = delete;
+
+  bool isValid() const;           // 图集是否可用
+  bool isLoadedFromCache() const; // 是否直接映射了磁盘缓存
+
+  // 图集中的图标（:/icons/下的文件名），不存在时返回空图标
+  // 每个尺寸的像素图从图集区域拷贝生成，不解析SVG，创建后不再引用图集内存
+  QIcon icon(const QString& iconFileName);
+
+  static QStringList iconNames();        // 资源中的全部SVG图标
+  static QString defaultCachePath();     // 默认的缓存文件路径
+  static QList<int> defaultPixelSizes(); // 默认的像素尺寸（含各屏幕的工具栏图标尺寸）
+
+private:
+  // 图集中的一个图标
+  struct Entry
+  {
+    QString name; // 图标文件名
+    QRect rect;   // 在图集中的位置（物理像素）
+  };
+
+  bool load(const QByteArray& key);  // 映射磁盘缓存，键不一致时返回false
+  void build(const QByteArray& key); // 栅格化所有SVG并写入磁盘缓存
+  QByteArray cacheKey() const;       // 资源内容和像素尺寸的摘要
+
+  QString m_cachePath;           // 缓存文件路径
+  QList<int> m_pixelSizes;       // 每个图标栅格化的像素尺寸
+  QFile m_file;                  // 映射的缓存文件
+  uchar* m_mapped;               // 映射的内存（没有映射时为空）
+  QImage m_image;                // 图集像素（引用映射的内存或自己持有）
+  std::vector<Entry> m_entries;  // 图标位置
+  QHash<QString, QIcon> m_icons; // 已创建的图标
+  bool m_loadedFromCache;        // 是否直接映射了磁盘缓存
+
+  // 常量定义
+  static constexpr int ATLAS_WIDTH = 512;      // 图集宽度（物理像素）
+  static constexpr int TOOLBAR_ICON_SIZE = 16; // 工具栏按钮图标的逻辑尺寸（QPushButton默认）
+};
+
+#endif // ICONATLAS_H
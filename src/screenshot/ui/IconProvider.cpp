@@ -7,17 +7,21 @@
 #include <QPainter>
 #include <QSvgRenderer>
 
-// 创建工具图标
+#include "IconAtlas.h"
+
+// 创建工具图标：优先使用预先栅格化的图标图集，不再逐次解析和绘制SVG
 QIcon IconProvider::createToolIcon(const QString& iconFileName)
 {
-  qDebug() << "尝试加载图标:" << iconFileName;
-  QString resourcePath = QString(":/icons/%1").arg(iconFileName);
-  QIcon icon = createWhiteSvgIcon(resourcePath);
-  if (icon.isNull())
+  QIcon icon = IconAtlas::shared().icon(iconFileName);
+  if (!icon.isNull())
   {
-    return QIcon();
+    return icon;
   }
-  return icon;
+
+  // 图集不可用（例如缓存目录不可写且生成失败）时退回直接绘制SVG
+  qDebug() << "图标图集中没有图标，直接绘制SVG:" << iconFileName;
+  QString resourcePath = QString(":/icons/%1").arg(iconFileName);
+  return createWhiteSvgIcon(resourcePath);
 }
 
 // 创建白色SVG图标
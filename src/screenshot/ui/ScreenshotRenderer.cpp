@@ -1,39 +1,232 @@
 #include "ScreenshotRenderer.h"
 
-#include <QApplication>
-#include <QFont>
-#include <QScreen>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstring>
+
+#include "../../utils/PixelKernels.h"
+
+namespace
+{
+// 放大镜缩放级别：先用帧金字塔缩小，再按物理像素放大
+struct MagnifierLevel
+{
+  int pyramidLevel; // 帧金字塔级别（每级缩小一半）
+  int zoom;         // 放大倍数
+};
+
+constexpr MagnifierLevel MAGNIFIER_LEVELS[] = {
+    {3, 1}, {2, 1}, {1, 1}, {0, 1}, {0, 2}, {0, 3}, {0, 4},
+    {0, 6}, {0, 8}, {0, 12}, {0, 16}, {0, 24}, {0, 32},
+};
+constexpr int MAGNIFIER_LEVEL_COUNT = int(sizeof(MAGNIFIER_LEVELS) / sizeof(MAGNIFIER_LEVELS[0]));
+constexpr int DEFAULT_MAGNIFIER_LEVEL = 5; // 默认3倍
+
+// 拷贝一行中 [begin, end) 范围内的像素
+inline void copyPixels(QRgb* dst, const QRgb* src, int begin, int end)
+{
+  if (end > begin)
+  {
+    std::memcpy(dst + begin, src + begin, size_t(end - begin) * sizeof(QRgb));
+  }
+}
+} // namespace
 
 // 构造函数
-ScreenshotRenderer::ScreenshotRenderer(const QPixmap& screenshot)
-  : m_screenshot(screenshot),
-    m_imageCacheValid(false),
-    m_cachedMagnifierPos(QPoint(-1, -1)),
+ScreenshotRenderer::ScreenshotRenderer(ScreenshotFrame::Ptr frame)
+  : m_frame(std::move(frame)),
+    m_magnifierGridEnabled(true),
+    m_magnifierLevel(DEFAULT_MAGNIFIER_LEVEL),
+    m_pyramid(m_frame),
     m_cachedColorPos(QPoint(-1, -1))
 {
+  m_hud.setZoomText(magnifierZoomText());
+
+  // 在后台线程预合成变暗背景，绘制时直接贴图，不再逐帧叠加半透明遮罩
+  if (m_frame && !m_frame->isNull())
+  {
+    m_dimmedFuture =
+        std::async(std::launch::async, &ScreenshotRenderer::buildDimmedBackdrop, m_frame);
+  }
+}
+
+// 更换截图帧并恢复初始状态：放大镜缓冲区尺寸不变时继续复用
+void ScreenshotRenderer::reset(ScreenshotFrame::Ptr frame)
+{
+  // 上一次会话的后台任务早已完成，等待只是回收结果
+  if (m_dimmedFuture.valid())
+  {
+    m_dimmedFuture.wait();
+  }
+  m_dimmedFuture = std::future<QImage>();
+  m_dimmedBackdrop = QImage();
+
+  m_frame = std::move(frame);
+  m_pyramid = FramePyramid(m_frame);
+  m_magnifierLevel = DEFAULT_MAGNIFIER_LEVEL;
+  m_hud.setZoomText(magnifierZoomText());
+  clearCache();
+
+  if (m_frame && !m_frame->isNull())
+  {
+    m_dimmedFuture =
+        std::async(std::launch::async, &ScreenshotRenderer::buildDimmedBackdrop, m_frame);
+  }
 }
 
 // 析构函数
 ScreenshotRenderer::~ScreenshotRenderer()
 {
-  // Qt会自动清理QPixmap和QImage对象
+  // 帧由共享指针管理，最后一个持有者释放时自动回收
+}
+
+// 收取后台任务的结果（只在GUI线程中调用）
+void ScreenshotRenderer::prepareFrame()
+{
+  if (m_dimmedBackdrop.isNull() && m_dimmedFuture.valid() &&
+      m_dimmedFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+  {
+    m_dimmedBackdrop = m_dimmedFuture.get();
+  }
+}
+
+// 预合成的变暗背景是否已经可用
+bool ScreenshotRenderer::isBackdropReady() const
+{
+  return !m_dimmedBackdrop.isNull();
+}
+
+// 绘制背景和遮罩
+void ScreenshotRenderer::drawBackdrop(QPainter& painter,
+                                      const QRect& selectionRect,
+                                      bool hasSelection) const
+{
+  const QImage& dimmed = m_dimmedBackdrop;
+  if (dimmed.isNull())
+  {
+    // 变暗背景尚未生成完成，回退到逐帧叠加遮罩
+    drawBackground(painter);
+    drawOverlay(painter, selectionRect, hasSelection);
+    return;
+  }
+
+  // 背景完全不透明，直接拷贝像素，无需逐帧进行alpha混合
+  painter.save();
+  painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+  QRect frameRect(QPoint(0, 0), m_frame->logicalSize());
+  QRect clearRect;
+  if (hasSelection && selectionRect.isValid())
+  {
+    clearRect = selectionRect.intersected(frameRect);
+  }
+
+  if (clearRect.isEmpty())
+  {
+    painter.drawImage(QPointF(0, 0), dimmed);
+  }
+  else
+  {
+    // 选择区域四周的四个矩形使用变暗背景
+    const int right = clearRect.right() + 1;
+    const int bottom = clearRect.bottom() + 1;
+    const QRect dimmedRects[] = {
+        QRect(0, 0, frameRect.width(), clearRect.top()),                             // 上
+        QRect(0, bottom, frameRect.width(), frameRect.height() - bottom),            // 下
+        QRect(0, clearRect.top(), clearRect.left(), clearRect.height()),             // 左
+        QRect(right, clearRect.top(), frameRect.width() - right, clearRect.height()) // 右
+    };
+
+    for (const QRect& rect : dimmedRects)
+    {
+      if (!rect.isEmpty())
+      {
+        painter.drawImage(rect, dimmed, toDeviceRect(rect));
+      }
+    }
+
+    // 选择区域使用原始帧
+    painter.drawImage(clearRect, m_frame->image(), toDeviceRect(clearRect));
+  }
+
+  painter.restore();
+}
+
+// 按物理像素直接拷贝背景和遮罩
+bool ScreenshotRenderer::blitBackdrop(QImage& pixels,
+                                      const QRect& deviceRect,
+                                      const QRegion& clip,
+                                      const QRect& selectionRect,
+                                      bool hasSelection) const
+{
+  const QImage& dimmed = m_dimmedBackdrop;
+  if (dimmed.isNull())
+  {
+    return false;
+  }
+
+  // 选择区域使用原始帧，其余部分使用变暗背景
+  QRect clearRect;
+  if (hasSelection && selectionRect.isValid())
+  {
+    clearRect = m_frame->mapToDevice(selectionRect).intersected(m_frame->rect());
+  }
+
+  const ScreenshotFrameView frame = m_frame->view();
+  const QRect bounds = deviceRect.intersected(m_frame->rect());
+  for (const QRect& logicalRect : clip)
+  {
+    const QRect rect = m_frame->mapToDevice(logicalRect).intersected(bounds);
+    if (rect.isEmpty())
+    {
+      continue;
+    }
+
+    // 每行最多分为三段：选择区域左侧、选择区域、选择区域右侧
+    int clearLeft = rect.left();
+    int clearRight = rect.left();
+    if (!clearRect.isEmpty())
+    {
+      clearLeft = qBound(rect.left(), clearRect.left(), rect.right() + 1);
+      clearRight = qBound(clearLeft, clearRect.right() + 1, rect.right() + 1);
+    }
+
+    for (int y = rect.top(); y <= rect.bottom(); ++y)
+    {
+      QRgb* dst = reinterpret_cast<QRgb*>(pixels.scanLine(y - deviceRect.y())) - deviceRect.x();
+      const QRgb* dimmedRow = reinterpret_cast<const QRgb*>(dimmed.constScanLine(y));
+
+      if (y < clearRect.top() || y > clearRect.bottom() || clearLeft == clearRight)
+      {
+        copyPixels(dst, dimmedRow, rect.left(), rect.right() + 1);
+        continue;
+      }
+
+      copyPixels(dst, dimmedRow, rect.left(), clearLeft);
+      copyPixels(dst, frame.row(y), clearLeft, clearRight);
+      copyPixels(dst, dimmedRow, clearRight, rect.right() + 1);
+    }
+  }
+
+  return true;
 }
 
 // 绘制背景截图
-void ScreenshotRenderer::drawBackground(QPainter& painter)
+void ScreenshotRenderer::drawBackground(QPainter& painter) const
 {
-  // 绘制原始截图作为背景，截图已经设置了正确的设备像素比
+  // 绘制原始截图作为背景，帧图像已经设置了正确的设备像素比
   // Qt会自动处理Retina屏幕的缩放，确保显示比例正确
-  painter.drawPixmap(0, 0, m_screenshot);
+  painter.drawImage(QPointF(0, 0), m_frame->image());
 }
 
 // 绘制半透明遮罩
 void ScreenshotRenderer::drawOverlay(QPainter& painter,
                                      const QRect& selectionRect,
-                                     bool hasSelection)
+                                     bool hasSelection) const
 {
   // 绘制半透明黑色遮罩，覆盖整个截图区域
-  painter.fillRect(m_screenshot.rect(), QColor(0, 0, 0, 127));
+  painter.fillRect(QRect(QPoint(0, 0), m_frame->logicalSize()), QColor(0, 0, 0, 127));
 
   // 如果有选择区域，清除选择区域的遮罩
   if (hasSelection && selectionRect.isValid())
@@ -42,22 +235,13 @@ void ScreenshotRenderer::drawOverlay(QPainter& painter,
     painter.fillRect(selectionRect, Qt::transparent);
     painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
 
-    // 在选择区域重新绘制原始截图，使用正确的设备像素比
-    QScreen* screen = QApplication::primaryScreen();
-    qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
-
-    // 计算源区域，考虑设备像素比
-    QRect sourceRect(selectionRect.x() * devicePixelRatio,
-                     selectionRect.y() * devicePixelRatio,
-                     selectionRect.width() * devicePixelRatio,
-                     selectionRect.height() * devicePixelRatio);
-
-    painter.drawPixmap(selectionRect, m_screenshot, sourceRect);
+    // 在选择区域重新绘制原始截图，源区域使用帧自带的设备像素比换算
+    painter.drawImage(selectionRect, m_frame->image(), toDeviceRect(selectionRect));
   }
 }
 
 // 绘制选择框
-void ScreenshotRenderer::drawSelectionBox(QPainter& painter, const QRect& selectionRect)
+void ScreenshotRenderer::drawSelectionBox(QPainter& painter, const QRect& selectionRect) const
 {
   if (!selectionRect.isValid())
     return;
@@ -75,61 +259,33 @@ void ScreenshotRenderer::drawMagnifier(QPainter& painter,
                                        int widgetWidth,
                                        int widgetHeight)
 {
-  // 获取设备像素比
-  QScreen* screen = QApplication::primaryScreen();
-  qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
-
   // 计算放大镜位置，避免超出屏幕边界
-  int magnifierX = mousePos.x() + MAGNIFIER_OFFSET_X;
-  int magnifierY = mousePos.y() + MAGNIFIER_OFFSET_Y;
-
-  // 如果放大镜会超出右边界，放到鼠标左边
-  if (magnifierX + MAGNIFIER_SIZE > widgetWidth)
-  {
-    magnifierX = mousePos.x() - MAGNIFIER_SIZE - MAGNIFIER_OFFSET_X;
-  }
-
-  // 如果放大镜会超出下边界，放到鼠标上方
-  if (magnifierY + MAGNIFIER_SIZE + 60 > widgetHeight) // 60是下方文字区域的高度
-  {
-    magnifierY = mousePos.y() - MAGNIFIER_SIZE - 60 - MAGNIFIER_OFFSET_Y;
-  }
-
-  // 确保放大镜完全在屏幕内
-  magnifierX = qMax(5, qMin(magnifierX, widgetWidth - MAGNIFIER_SIZE - 5));
-  magnifierY = qMax(5, qMin(magnifierY, widgetHeight - MAGNIFIER_SIZE - 60 - 5));
-
-  QRect magnifierRect(magnifierX, magnifierY, MAGNIFIER_SIZE, MAGNIFIER_SIZE);
+  QRect magnifierRect = magnifierLensRect(mousePos, widgetWidth, widgetHeight);
+  int magnifierX = magnifierRect.x();
+  int magnifierY = magnifierRect.y();
 
   // 保存painter状态
   painter.save();
 
-  // 绘制放大镜背景
-  painter.fillRect(magnifierRect, QColor(255, 255, 255, 240));
-
   // 绘制放大镜边框
   QPen borderPen(QColor(0, 0, 0, 200), 2);
   painter.setPen(borderPen);
   painter.drawRect(magnifierRect);
 
-  // 检查是否可以使用缓存的放大镜内容
-  QPixmap magnifiedPixmap;
-  if (isMagnifierCacheValid(mousePos))
-  {
-    magnifiedPixmap = m_cachedMagnifierSource;
-  }
-  else
-  {
-    // 重新生成放大镜内容
-    magnifiedPixmap = getMagnifierSourcePixmap(mousePos);
+  // 光标所在的物理像素作为放大中心，直接从帧扫描线生成放大图像
+  const QImage& magnifiedImage = renderMagnifier(m_frame->mapToDevice(mousePos));
 
-    // 更新缓存
-    m_cachedMagnifierSource = magnifiedPixmap;
-    m_cachedMagnifierPos = mousePos;
+  // 缓冲区与放大镜的物理像素一一对应：在物理像素坐标系中绘制，非整数缩放比例下也不做任何插值
+  const qreal devicePixelRatio = m_frame->devicePixelRatio();
+  painter.save();
+  painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+  if (devicePixelRatio != 1.0)
+  {
+    painter.setWorldTransform(
+        QTransform::fromScale(1.0 / devicePixelRatio, 1.0 / devicePixelRatio), true);
   }
-
-  // 绘制放大的图像
-  painter.drawPixmap(magnifierRect, magnifiedPixmap);
+  painter.drawImage(m_frame->mapToDevice(magnifierRect).topLeft(), magnifiedImage);
+  painter.restore();
 
   // 绘制中心十字线
   QPen crossPen(QColor(255, 0, 0), 1);
@@ -145,33 +301,34 @@ void ScreenshotRenderer::drawMagnifier(QPainter& painter,
   // 获取当前像素颜色（使用缓存）
   QColor pixelColor = getPixelColor(mousePos);
 
-  // 绘制信息文字背景
-  QRect textRect(magnifierX, magnifierY + MAGNIFIER_SIZE + 2, MAGNIFIER_SIZE, 55);
-  painter.fillRect(textRect, QColor(0, 0, 0, 200));
-
-  // 设置文字样式
-  QFont font;
-  font.setFamily("Arial");
-  font.setPixelSize(11);
-  painter.setFont(font);
-  painter.setPen(QColor(160, 160, 160));
-
-  // 绘制颜色信息文字
-  QString coordText = QString("坐标: (%1, %2)").arg(mousePos.x()).arg(mousePos.y());
-  QString hexText = QString("色值: %1").arg(colorToHex(pixelColor));
-  QString copyHintText = QString("按c复制色值");
-
-  // 绘制文字信息
-  painter.drawText(magnifierX + 5, magnifierY + MAGNIFIER_SIZE + 15, coordText);
-  painter.drawText(magnifierX + 5, magnifierY + MAGNIFIER_SIZE + 30, hexText);
-  painter.drawText(magnifierX + 5, magnifierY + MAGNIFIER_SIZE + 45, copyHintText);
+  // 绘制坐标、色值和缩放信息（文字排版由HUD层缓存）
+  QRect textRect(magnifierX, magnifierY + MAGNIFIER_SIZE + 2, MAGNIFIER_SIZE, INFO_HEIGHT);
+  m_hud.drawMagnifierInfo(painter, textRect, mousePos, pixelColor.rgb());
 
   // 恢复painter状态
   painter.restore();
 }
 
+// 绘制HUD（顶部提示和选择区域尺寸标签）
+void ScreenshotRenderer::drawHud(QPainter& painter,
+                                 const QRect& dirtyRect,
+                                 const QRect& selectionRect,
+                                 bool showSizeBadge,
+                                 int widgetWidth)
+{
+  if (m_hud.hintBounds(widgetWidth).intersects(dirtyRect))
+  {
+    m_hud.drawHint(painter, widgetWidth);
+  }
+
+  if (showSizeBadge && m_hud.sizeBadgeBounds(selectionRect, widgetWidth).intersects(dirtyRect))
+  {
+    m_hud.drawSizeBadge(painter, selectionRect, widgetWidth);
+  }
+}
+
 // 绘制调整锚点
-void ScreenshotRenderer::drawResizeHandles(QPainter& painter, const QRect& selectionRect)
+void ScreenshotRenderer::drawResizeHandles(QPainter& painter, const QRect& selectionRect) const
 {
   if (!selectionRect.isValid())
     return;
@@ -204,6 +361,69 @@ void ScreenshotRenderer::drawResizeHandles(QPainter& painter, const QRect& selec
   painter.restore();
 }
 
+// 计算放大镜方框位置，避免超出屏幕边界
+QRect ScreenshotRenderer::magnifierLensRect(const QPoint& mousePos,
+                                            int widgetWidth,
+                                            int widgetHeight) const
+{
+  int magnifierX = mousePos.x() + MAGNIFIER_OFFSET_X;
+  int magnifierY = mousePos.y() + MAGNIFIER_OFFSET_Y;
+
+  // 如果放大镜会超出右边界，放到鼠标左边
+  if (magnifierX + MAGNIFIER_SIZE > widgetWidth)
+  {
+    magnifierX = mousePos.x() - MAGNIFIER_SIZE - MAGNIFIER_OFFSET_X;
+  }
+
+  // 如果放大镜会超出下边界，放到鼠标上方
+  if (magnifierY + MAGNIFIER_SIZE + 60 > widgetHeight) // 60是下方文字区域的高度
+  {
+    magnifierY = mousePos.y() - MAGNIFIER_SIZE - 60 - MAGNIFIER_OFFSET_Y;
+  }
+
+  // 确保放大镜完全在屏幕内
+  magnifierX = qMax(5, qMin(magnifierX, widgetWidth - MAGNIFIER_SIZE - 5));
+  magnifierY = qMax(5, qMin(magnifierY, widgetHeight - MAGNIFIER_SIZE - 60 - 5));
+
+  return QRect(magnifierX, magnifierY, MAGNIFIER_SIZE, MAGNIFIER_SIZE);
+}
+
+// 计算放大镜（含下方信息区域和边框）覆盖的区域
+QRect ScreenshotRenderer::magnifierBounds(const QPoint& mousePos,
+                                          int widgetWidth,
+                                          int widgetHeight) const
+{
+  QRect rect = magnifierLensRect(mousePos, widgetWidth, widgetHeight);
+  rect.setHeight(MAGNIFIER_SIZE + 2 + INFO_HEIGHT);
+  return rect.adjusted(-BORDER_MARGIN, -BORDER_MARGIN, BORDER_MARGIN, BORDER_MARGIN);
+}
+
+// 计算尺寸标签覆盖的区域
+QRect ScreenshotRenderer::sizeBadgeBounds(const QRect& selectionRect, int widgetWidth)
+{
+  return m_hud.sizeBadgeBounds(selectionRect, widgetWidth);
+}
+
+// 计算选择框、边框和锚点覆盖的区域
+QRect ScreenshotRenderer::selectionBounds(const QRect& selectionRect) const
+{
+  if (!selectionRect.isValid())
+    return QRect();
+
+  const int margin = HANDLE_SIZE / 2 + BORDER_MARGIN;
+  return selectionRect.adjusted(-margin, -margin, margin, margin);
+}
+
+// 计算选择框内部不受边框和锚点影响的区域
+QRect ScreenshotRenderer::selectionInterior(const QRect& selectionRect) const
+{
+  if (!selectionRect.isValid())
+    return QRect();
+
+  const int margin = HANDLE_SIZE / 2 + BORDER_MARGIN;
+  return selectionRect.adjusted(margin, margin, -margin, -margin);
+}
+
 // 获取指定位置的像素颜色
 QColor ScreenshotRenderer::getPixelColor(const QPoint& pos) const
 {
@@ -213,26 +433,20 @@ QColor ScreenshotRenderer::getPixelColor(const QPoint& pos) const
     return m_cachedPixelColor;
   }
 
-  // 获取设备像素比
-  QScreen* screen = QApplication::primaryScreen();
-  qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
-
   // 计算在原始截图中的像素位置
-  int pixelX = pos.x() * devicePixelRatio;
-  int pixelY = pos.y() * devicePixelRatio;
-
-  // 确保坐标在截图范围内
-  pixelX = qMax(0, qMin(pixelX, m_screenshot.width() - 1));
-  pixelY = qMax(0, qMin(pixelY, m_screenshot.height() - 1));
-
-  // 确保Image缓存有效
-  ensureImageCache();
+  QPoint pixelPos = m_frame->mapToDevice(pos);
+  int pixelX = pixelPos.x();
+  int pixelY = pixelPos.y();
 
   QColor color(0, 0, 0); // 默认黑色
-  if (!m_cachedScreenshotImage.isNull() && pixelX < m_cachedScreenshotImage.width() &&
-      pixelY < m_cachedScreenshotImage.height())
+  if (!m_frame->isNull())
   {
-    color = QColor(m_cachedScreenshotImage.pixel(pixelX, pixelY));
+    // 确保坐标在截图范围内
+    pixelX = qMax(0, qMin(pixelX, m_frame->width() - 1));
+    pixelY = qMax(0, qMin(pixelY, m_frame->height() - 1));
+
+    // 直接读取帧的扫描线，帧为预乘格式，需要还原为非预乘颜色
+    color = QColor::fromRgba(qUnpremultiply(m_frame->pixel(pixelX, pixelY)));
   }
 
   // 更新缓存
@@ -252,69 +466,175 @@ QString ScreenshotRenderer::colorToHex(const QColor& color) const
       .toUpper();
 }
 
-// 性能优化：清除所有缓存
-void ScreenshotRenderer::clearCache()
+// 按级别调整放大镜缩放，正数放大，负数缩小
+bool ScreenshotRenderer::stepMagnifierZoom(int steps)
 {
-  m_cachedScreenshotImage = QImage();
-  m_imageCacheValid = false;
-  m_cachedMagnifierSource = QPixmap();
-  m_cachedMagnifierPos = QPoint(-1, -1);
-  m_cachedPixelColor = QColor();
-  m_cachedColorPos = QPoint(-1, -1);
-}
+  int level = qBound(0, m_magnifierLevel + steps, MAGNIFIER_LEVEL_COUNT - 1);
+  if (level == m_magnifierLevel)
+  {
+    return false;
+  }
 
-// 性能优化：检查放大镜缓存是否有效
-bool ScreenshotRenderer::isMagnifierCacheValid(const QPoint& mousePos) const
-{
-  // 如果鼠标位置没有变化，且缓存的像素图有效，则可以重用
-  return !m_cachedMagnifierSource.isNull() && m_cachedMagnifierPos == mousePos;
+  m_magnifierLevel = level;
+  m_hud.setZoomText(magnifierZoomText());
+  return true;
 }
 
-// 性能优化：确保Image缓存有效
-void ScreenshotRenderer::ensureImageCache() const
+// 当前缩放倍数的显示文字
+QString ScreenshotRenderer::magnifierZoomText() const
 {
-  if (!m_imageCacheValid || m_cachedScreenshotImage.isNull())
+  const MagnifierLevel& level = MAGNIFIER_LEVELS[m_magnifierLevel];
+  if (level.pyramidLevel > 0)
   {
-    m_cachedScreenshotImage = m_screenshot.toImage();
-    m_imageCacheValid = true;
+    return QString("1/%1x").arg(1 << level.pyramidLevel);
   }
+  return QString("%1x").arg(level.zoom);
 }
 
-// 性能优化：获取放大镜源像素图
-QPixmap ScreenshotRenderer::getMagnifierSourcePixmap(const QPoint& mousePos) const
+// 设置是否绘制放大镜像素网格
+void ScreenshotRenderer::setMagnifierGridEnabled(bool enabled)
 {
-  QScreen* screen = QApplication::primaryScreen();
-  qreal devicePixelRatio = screen ? screen->devicePixelRatio() : 1.0;
+  m_magnifierGridEnabled = enabled;
+}
 
-  // 计算要放大的源区域，以鼠标位置为中心
-  int sourceSize = MAGNIFIER_SIZE / MAGNIFIER_ZOOM;
+// 是否绘制放大镜像素网格
+bool ScreenshotRenderer::isMagnifierGridEnabled() const
+{
+  return m_magnifierGridEnabled;
+}
 
-  // 计算在屏幕坐标系中的源区域中心
-  int sourceCenterX = mousePos.x() * devicePixelRatio;
-  int sourceCenterY = mousePos.y() * devicePixelRatio;
+// 放大镜需要的缩小级别是否还在后台生成
+bool ScreenshotRenderer::isMagnifierLevelPending() const
+{
+  return MAGNIFIER_LEVELS[m_magnifierLevel].pyramidLevel > 0 && m_pyramid.isBuilding();
+}
 
-  // 计算源区域的左上角坐标，以中心点为基准
-  int sourceX = sourceCenterX - (sourceSize * devicePixelRatio) / 2;
-  int sourceY = sourceCenterY - (sourceSize * devicePixelRatio) / 2;
+// 性能优化：清除所有缓存
+void ScreenshotRenderer::clearCache()
+{
+  m_cachedPixelColor = QColor();
+  m_cachedColorPos = QPoint(-1, -1);
+}
+
+// 最近邻放大：将以centerPixel为中心的源像素直接写入放大镜缓冲区
+const QImage& ScreenshotRenderer::renderMagnifier(const QPoint& centerPixel)
+{
+  // 缓冲区按放大镜覆盖的物理像素分配，只有设备像素比变化时才重新分配
+  const int side = m_frame->mapToDevice(QRect(0, 0, MAGNIFIER_SIZE, MAGNIFIER_SIZE)).width();
+  if (m_magnifierBuffer.width() != side)
+  {
+    m_magnifierBuffer = QImage(side, side, ScreenshotFrameView::FORMAT);
+  }
+
+  // 缩小级别从帧金字塔读取，任何级别每次只处理放大镜覆盖的像素，耗时恒定；
+  // 金字塔在后台生成完成前暂时使用原始帧
+  const MagnifierLevel& level = MAGNIFIER_LEVELS[m_magnifierLevel];
+  int pyramidLevel = 0;
+  const ScreenshotFrameView source = m_pyramid.level(level.pyramidLevel, &pyramidLevel);
+  const QPoint center(centerPixel.x() >> pyramidLevel, centerPixel.y() >> pyramidLevel);
+  const int zoom = level.zoom;
+  const bool grid = m_magnifierGridEnabled && zoom >= MAGNIFIER_GRID_MIN_ZOOM;
+
+  // 光标像素的放大格子位于缓冲区正中，由此得到缓冲区第0行/列对应的源像素，
+  // 以及该像素在格子内被裁掉的部分（phase）
+  const int cellStart = side / 2 - zoom / 2;
+  const int firstOffset = -((cellStart + zoom - 1) / zoom);
+  const int phase = firstOffset * -zoom - cellStart;
+  const int firstX = center.x() + firstOffset;
+  const int firstY = center.y() + firstOffset;
+
+  // 水平方向：帧左侧之外、帧内、帧右侧之外三段，对所有行都相同
+  const int leftFill = firstX < 0 ? qMin(side, -firstX * zoom - phase) : 0;
+  const int sourceX = qMax(firstX, 0);
+  const int sourcePhase = firstX < 0 ? 0 : phase;
+  int sourceCount = 0;
+  if (sourceX < source.width())
+  {
+    sourceCount = qMin(side - leftFill, (source.width() - sourceX) * zoom - sourcePhase);
+  }
+  const int rightFill = side - leftFill - sourceCount;
 
-  // 调整源区域尺寸以匹配设备像素比
-  int adjustedSourceSize = sourceSize * devicePixelRatio;
+  int y = 0;
+  int sourceY = firstY;
+  int cellRows = zoom - phase;
+  while (y < side)
+  {
+    QRgb* line = reinterpret_cast<QRgb*>(m_magnifierBuffer.scanLine(y));
+    const int rows = qMin(cellRows, side - y);
+
+    // 每个源像素行只放大一次
+    if (sourceY < 0 || sourceY >= source.height())
+    {
+      PixelKernels::fillRow(line, MAGNIFIER_OUTSIDE_COLOR, side);
+    }
+    else
+    {
+      PixelKernels::fillRow(line, MAGNIFIER_OUTSIDE_COLOR, leftFill);
+      PixelKernels::zoomRow(
+          source.row(sourceY) + sourceX, line + leftFill, sourceCount, zoom, sourcePhase);
+      PixelKernels::fillRow(line + leftFill + sourceCount, MAGNIFIER_OUTSIDE_COLOR, rightFill);
+    }
+
+    // 网格竖线：每个格子的最后一列颜色减半
+    if (grid)
+    {
+      for (int x = zoom - 1 - phase; x < side; x += zoom)
+      {
+        line[x] = ((line[x] >> 1) & 0x7F7F7F7F) | 0xFF000000;
+      }
+    }
+
+    // 同一格子的其余行直接复制
+    for (int i = 1; i < rows; ++i)
+    {
+      std::memcpy(m_magnifierBuffer.scanLine(y + i), line, size_t(side) * sizeof(QRgb));
+    }
+
+    // 网格横线：完整格子的最后一行颜色减半
+    if (grid && rows == cellRows)
+    {
+      QRgb* last = reinterpret_cast<QRgb*>(m_magnifierBuffer.scanLine(y + rows - 1));
+      for (int x = 0; x < side; ++x)
+      {
+        last[x] = ((last[x] >> 1) & 0x7F7F7F7F) | 0xFF000000;
+      }
+    }
+
+    y += rows;
+    ++sourceY;
+    cellRows = zoom;
+  }
 
-  // 确保源区域在截图范围内
-  sourceX = qMax(0, qMin(sourceX, m_screenshot.width() - adjustedSourceSize));
-  sourceY = qMax(0, qMin(sourceY, m_screenshot.height() - adjustedSourceSize));
+  return m_magnifierBuffer;
+}
 
-  QRect sourceRect(sourceX, sourceY, adjustedSourceSize, adjustedSourceSize);
+// 生成变暗背景（在后台线程执行）
+QImage ScreenshotRenderer::buildDimmedBackdrop(ScreenshotFrame::Ptr frame)
+{
+  QElapsedTimer timer;
+  timer.start();
 
-  // 拷贝并缩放图像
-  QPixmap sourcePixmap = m_screenshot.copy(sourceRect);
-  return sourcePixmap.scaled(
-      MAGNIFIER_SIZE, MAGNIFIER_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  ScreenshotFrameView source = frame->view();
+  QImage dimmed(source.size(), ScreenshotFrameView::FORMAT);
+  if (dimmed.isNull())
+  {
+    qWarning() << "变暗背景内存分配失败";
+    return QImage();
+  }
+
+  for (int y = 0; y < source.height(); ++y)
+  {
+    PixelKernels::dimRow(
+        source.row(y), reinterpret_cast<QRgb*>(dimmed.scanLine(y)), source.width());
+  }
+  dimmed.setDevicePixelRatio(source.devicePixelRatio());
+
+  qDebug() << "变暗背景已生成，尺寸:" << dimmed.size() << "耗时:" << timer.elapsed() << "ms";
+  return dimmed;
 }
 
-// 性能优化：更新背景缓存
-void ScreenshotRenderer::updateBackgroundCache()
+// 逻辑坐标转换为物理像素（按边取整，与分块和裁剪使用相同的换算）
+QRect ScreenshotRenderer::toDeviceRect(const QRect& logicalRect) const
 {
-  // 预先转换为Image以提高getPixelColor性能
-  ensureImageCache();
-}
\ No newline at end of file
+  return m_frame->mapToDevice(logicalRect);
+}
@@ -3,32 +3,68 @@
 
 #include <QColor>
 #include <QPainter>
-#include <QPixmap>
+#include <QImage>
 #include <QPoint>
 #include <QRect>
+#include <future>
+
+#include "../core/FramePyramid.h"
+#include "../core/ScreenshotFrame.h"
+#include "HudLayer.h"
 
 // 截图渲染器类，负责处理所有绘制功能
 class ScreenshotRenderer
 {
 public:
   // 构造函数
-  explicit ScreenshotRenderer(const QPixmap& screenshot);
+  explicit ScreenshotRenderer(ScreenshotFrame::Ptr frame);
   ~ScreenshotRenderer(); // 析构函数
 
+  // 更换截图帧并恢复初始状态（覆盖层复用时每次会话开始调用，帧为空时只释放旧帧）
+  void reset(ScreenshotFrame::Ptr frame);
+
+  // 每帧绘制前在GUI线程调用：收取后台任务的结果，之后的const绘制函数可以在工作线程中并行调用
+  void prepareFrame();
+  bool isBackdropReady() const; // 预合成的变暗背景是否已经可用
+
+  // 绘制背景和遮罩（优先使用预合成的变暗背景，选择区域显示原图）
+  void drawBackdrop(QPainter& painter, const QRect& selectionRect, bool hasSelection) const;
+
+  // 按物理像素直接拷贝背景和遮罩，不经过QPainter的缩放（变暗背景未就绪时返回false）
+  // pixels：目标像素，左上角对应deviceRect的左上角；clip：需要写入的区域（逻辑坐标）
+  bool blitBackdrop(QImage& pixels,
+                    const QRect& deviceRect,
+                    const QRegion& clip,
+                    const QRect& selectionRect,
+                    bool hasSelection) const;
+
   // 绘制背景截图
-  void drawBackground(QPainter& painter);
+  void drawBackground(QPainter& painter) const;
 
   // 绘制半透明遮罩
-  void drawOverlay(QPainter& painter, const QRect& selectionRect, bool hasSelection);
+  void drawOverlay(QPainter& painter, const QRect& selectionRect, bool hasSelection) const;
 
   // 绘制选择框
-  void drawSelectionBox(QPainter& painter, const QRect& selectionRect);
+  void drawSelectionBox(QPainter& painter, const QRect& selectionRect) const;
 
   // 绘制放大镜（优化版本）
   void drawMagnifier(QPainter& painter, const QPoint& mousePos, int widgetWidth, int widgetHeight);
 
+  // 绘制HUD（顶部提示和选择区域尺寸标签），只绘制与脏区域相交的元素
+  void drawHud(QPainter& painter,
+               const QRect& dirtyRect,
+               const QRect& selectionRect,
+               bool showSizeBadge,
+               int widgetWidth);
+
   // 绘制调整锚点
-  void drawResizeHandles(QPainter& painter, const QRect& selectionRect);
+  void drawResizeHandles(QPainter& painter, const QRect& selectionRect) const;
+
+  // 重绘区域计算（用于脏区域跟踪）
+  QRect magnifierBounds(const QPoint& mousePos, int widgetWidth, int widgetHeight) const;
+  QRect sizeBadgeBounds(const QRect& selectionRect, int widgetWidth); // 尺寸标签覆盖的区域
+  QRect selectionBounds(const QRect& selectionRect) const;            // 选择框、边框和锚点覆盖的区域
+  QRect selectionInterior(const QRect& selectionRect) const;          // 选择框内部不受边框和锚点影响
 
   // 获取指定位置的像素颜色
   QColor getPixelColor(const QPoint& pos) const;
@@ -36,32 +72,54 @@ public:
   // 颜色转换为十六进制字符串
   QString colorToHex(const QColor& color) const;
 
+  // 放大镜缩放（滚轮调整，从缩小预览到32倍）
+  bool stepMagnifierZoom(int steps); // 按级别调整，返回级别是否变化
+  QString magnifierZoomText() const; // 当前缩放倍数的显示文字
+
+  // 放大镜像素网格（放大后的像素足够大时才绘制）
+  void setMagnifierGridEnabled(bool enabled);
+  bool isMagnifierGridEnabled() const;
+
+  // 放大镜需要的缩小级别是否还在后台生成（生成完成前放大镜暂时显示原始帧，完成后需要重绘）
+  bool isMagnifierLevelPending() const;
+
   // 性能优化相关函数
-  void clearCache();                                        // 清除所有缓存
-  bool isMagnifierCacheValid(const QPoint& mousePos) const; // 检查放大镜缓存是否有效
-  void updateBackgroundCache();                             // 更新背景缓存
+  void clearCache(); // 清除所有缓存
 
 private:
   // 常量定义
   static constexpr int MAGNIFIER_SIZE = 120;    // 放大镜尺寸
-  static constexpr int MAGNIFIER_ZOOM = 3;      // 放大倍数
   static constexpr int MAGNIFIER_OFFSET_X = 20; // 放大镜X偏移
   static constexpr int MAGNIFIER_OFFSET_Y = 20; // 放大镜Y偏移
   static constexpr int HANDLE_SIZE = 8;         // 锚点尺寸
+  static constexpr int INFO_HEIGHT = 55;        // 放大镜下方信息区域高度
+  static constexpr int BORDER_MARGIN = 2;       // 边框画笔和抗锯齿的额外重绘余量
+  static constexpr int MAGNIFIER_GRID_MIN_ZOOM = 6;           // 显示像素网格的最小放大倍数
+  static constexpr QRgb MAGNIFIER_OUTSIDE_COLOR = 0xFFF0F0F0; // 放大镜中帧外区域的颜色
+
+  ScreenshotFrame::Ptr m_frame; // 共享的截图帧（只读）
+
+  // 预合成的变暗背景（会话开始时在后台线程生成）
+  std::future<QImage> m_dimmedFuture; // 后台生成任务
+  QImage m_dimmedBackdrop;            // 生成完成的变暗背景
+
+  // 放大镜缓冲区（物理像素，设备像素比为1，按物理像素1:1绘制，尺寸不变时重复使用）
+  QImage m_magnifierBuffer;
+  bool m_magnifierGridEnabled; // 是否绘制像素网格
+  int m_magnifierLevel;        // 当前缩放级别索引
+  FramePyramid m_pyramid;      // 缩小预览使用的帧金字塔（按需在后台生成）
 
-  QPixmap m_screenshot; // 截图数据
+  HudLayer m_hud; // 文字和信息面板
 
   // 性能优化缓存
-  mutable QImage m_cachedScreenshotImage;  // 缓存的截图Image（避免重复转换）
-  mutable bool m_imageCacheValid;          // Image缓存是否有效
-  mutable QPixmap m_cachedMagnifierSource; // 缓存的放大镜源像素图
-  mutable QPoint m_cachedMagnifierPos;     // 缓存的放大镜位置
-  mutable QColor m_cachedPixelColor;       // 缓存的像素颜色
-  mutable QPoint m_cachedColorPos;         // 缓存的颜色位置
+  mutable QColor m_cachedPixelColor; // 缓存的像素颜色
+  mutable QPoint m_cachedColorPos;   // 缓存的颜色位置
 
   // 私有辅助函数
-  void ensureImageCache() const;                                  // 确保Image缓存有效
-  QPixmap getMagnifierSourcePixmap(const QPoint& mousePos) const; // 获取放大镜源像素图
+  static QImage buildDimmedBackdrop(ScreenshotFrame::Ptr frame); // 生成变暗背景
+  QRect toDeviceRect(const QRect& logicalRect) const;            // 逻辑坐标转换为物理像素
+  QRect magnifierLensRect(const QPoint& mousePos, int widgetWidth, int widgetHeight) const;
+  const QImage& renderMagnifier(const QPoint& centerPixel); // 将源像素放大写入放大镜缓冲区
 };
 
 #endif // SCREENSHOTRENDERER_H
\ No newline at end of file
@@ -1,266 +1,378 @@
 #include "ScreenshotToolbar.h"
 
 #include <QDebug>
+#include <QEvent>
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QToolTip>
 
-#include "../../utils/UIUtils.h"
 #include "IconProvider.h"
 
+namespace
+{
+// 颜色（与原样式表一致）
+const QColor TOOLBAR_BACKGROUND(42, 42, 42, 240); // 工具栏背景
+const QColor TOOLBAR_BORDER(255, 255, 255, 26);   // 工具栏边框
+const QColor SEPARATOR_COLOR(255, 255, 255, 51);  // 分隔线
+const QColor BUTTON_HOVER(255, 255, 255, 38);     // 悬停的按钮
+const QColor BUTTON_PRESSED(255, 255, 255, 64);   // 按下的按钮
+const QColor BUTTON_CHECKED(64, 158, 255, 204);   // 选中的按钮
+constexpr qreal DISABLED_OPACITY = 0.4;           // 不可用按钮的图标透明度
+} // namespace
 
 ScreenshotToolbar::ScreenshotToolbar(QWidget* parent)
   : QWidget(parent),
-    m_mainLayout(nullptr),
-    m_toolButtonGroup(nullptr),
-    m_rectButton(nullptr),
-    m_stepButton(nullptr),
-    m_arrowButton(nullptr),
-    m_penButton(nullptr),
-    m_textButton(nullptr),
-    m_mosaicButton(nullptr),
-    m_markerButton(nullptr),
-    m_undoButton(nullptr),
-    m_pinButton(nullptr),
-    m_saveButton(nullptr),
-    m_okButton(nullptr),
-    m_cancelButton(nullptr),
-    // 分割线
-    m_separator1(nullptr),
-    m_separator2(nullptr),
     // 是否正在编辑
-    m_isEditing(false)
+    m_isEditing(false),
+    m_hoveredButton(-1),
+    m_pressedButton(-1)
 {
-  initializeUI();
+  // 鼠标悬停需要在不按键时也收到移动事件；不抢占覆盖层的键盘焦点
+  setMouseTracking(true);
+  setFocusPolicy(Qt::NoFocus);
+
+  createButtons();
+  hide(); // 初始隐藏
 }
 
 ScreenshotToolbar::~ScreenshotToolbar()
 {
-  // Qt 会自动清理子对象，无需手动删除
 }
 
-void ScreenshotToolbar::initializeUI()
+// 创建按钮并计算布局：工具按钮 | 撤销、钉在桌面、保存 | 取消、确定
+void ScreenshotToolbar::createButtons()
 {
-  // 设置对象名称用于样式选择器
-  setObjectName("ScreenshotToolbar");
-
-  // 确保背景会被绘制
-  setAttribute(Qt::WA_StyledBackground, true);
-
-  // 设置工具栏样式
-  setStyleSheet(UIUtilsConstants::DEFAULT_TOOLBAR_STYLE);
-
-  // 创建各个组件
-  createToolButtons();
-  createFunctionButtons();
-  setupLayout();
+  auto addTool = [this](ToolType tool, const char* iconName, const QString& toolTip)
+  {
+    Button button;
+    button.iconName = iconName;
+    button.toolTip = toolTip;
+    button.isTool = true;
+    button.id = int(tool);
+    button.checkable = true;
+    m_buttons.push_back(button);
+  };
+  auto addAction = [this](ActionType action, const char* iconName, const QString& toolTip)
+  {
+    Button button;
+    button.iconName = iconName;
+    button.toolTip = toolTip;
+    button.id = int(action);
+    button.checkable = action == ActionType::Pin; // 钉在桌面是开关
+    m_buttons.push_back(button);
+  };
+
+  addTool(ToolType::Rectangle, "geometry_24.svg", "矩形/椭圆");
+  addTool(ToolType::Step, "one_circle_24.svg", "步骤标注");
+  addTool(ToolType::Arrow, "arrows_24.svg", "绘制箭头");
+  addTool(ToolType::Pen, "edit_24.svg", "自由画笔");
+  addTool(ToolType::Text, "text_24.svg", "添加文字");
+  addTool(ToolType::Mosaic, "mosaic_24.svg", "马赛克");
+  addTool(ToolType::Marker, "highlight_24.svg", "区域高亮");
+  const size_t firstAction = m_buttons.size();
+  addAction(ActionType::Undo, "recall_24.svg", "撤销上一步");
+  addAction(ActionType::Pin, "pin_24.svg", "钉在桌面");
+  addAction(ActionType::Save, "download_24.svg", "保存图片");
+  const size_t firstConfirm = m_buttons.size();
+  addAction(ActionType::Cancel, "close_24.svg", "取消");
+  addAction(ActionType::Ok, "tick_24.svg", "复制到剪切板");
+
+  // 从左到右排列，分组之间插入分隔线
+  int x = MARGIN_X;
+  const int separatorY = MARGIN_Y + (BUTTON_SIZE - SEPARATOR_HEIGHT) / 2;
+  for (size_t i = 0; i < m_buttons.size(); ++i)
+  {
+    if (i == firstAction || i == firstConfirm)
+    {
+      m_separators.push_back(QRect(x, separatorY, 1, SEPARATOR_HEIGHT));
+      x += 1 + SPACING;
+    }
+
+    Button& button = m_buttons[i];
+    button.rect = QRect(x, MARGIN_Y, BUTTON_SIZE, BUTTON_SIZE);
+    button.icon = IconProvider::createToolIcon(button.iconName);
+    x += BUTTON_SIZE + SPACING;
+  }
 
-  // 调整工具栏大小
-  adjustSize();
-  hide(); // 初始隐藏
+  setFixedSize(x - SPACING + MARGIN_X, BUTTON_SIZE + 2 * MARGIN_Y);
 }
 
-void ScreenshotToolbar::createToolButtons()
+void ScreenshotToolbar::showAt(const QPoint& position)
 {
-  // 创建按钮组用于工具按钮的互斥选择
-  m_toolButtonGroup = new QButtonGroup(this);
-  m_toolButtonGroup->setExclusive(true);
-
-  // 创建工具按钮
-  m_rectButton = UIUtils::createToolbarButton({this, "geometry_24.svg", "矩形/椭圆"});
-  m_toolButtonGroup->addButton(m_rectButton, static_cast<int>(ToolType::Rectangle));
-
-  m_stepButton = UIUtils::createToolbarButton({this, "one_circle_24.svg", "步骤标注"});
-  m_toolButtonGroup->addButton(m_stepButton, static_cast<int>(ToolType::Step));
-
-  m_arrowButton = UIUtils::createToolbarButton({this, "arrows_24.svg", "绘制箭头"});
-  m_toolButtonGroup->addButton(m_arrowButton, static_cast<int>(ToolType::Arrow));
+  move(position);
+  show();
+}
 
-  m_penButton = UIUtils::createToolbarButton({this, "edit_24.svg", "自由画笔"});
-  m_toolButtonGroup->addButton(m_penButton, static_cast<int>(ToolType::Pen));
+void ScreenshotToolbar::hideToolbar()
+{
+  hide();
+}
 
-  m_textButton = UIUtils::createToolbarButton({this, "text_24.svg", "添加文字"});
-  m_toolButtonGroup->addButton(m_textButton, static_cast<int>(ToolType::Text));
+void ScreenshotToolbar::reset()
+{
+  hide();
+  m_isEditing = false;
+  m_hoveredButton = -1;
+  m_pressedButton = -1;
 
-  m_mosaicButton = UIUtils::createToolbarButton({this, "mosaic_24.svg", "马赛克"});
-  m_toolButtonGroup->addButton(m_mosaicButton, static_cast<int>(ToolType::Mosaic));
+  for (Button& button : m_buttons)
+  {
+    button.checked = false;
+    button.enabled = true;
+  }
+}
 
-  m_markerButton = UIUtils::createToolbarButton({
-      this,
-      "highlight_24.svg",
-      "区域高亮",
-  });
-  m_toolButtonGroup->addButton(m_markerButton, static_cast<int>(ToolType::Marker));
+ScreenshotToolbar::ToolType ScreenshotToolbar::getCurrentTool() const
+{
+  for (const Button& button : m_buttons)
+  {
+    if (button.isTool && button.checked)
+    {
+      return static_cast<ToolType>(button.id);
+    }
+  }
 
-  // 连接按钮组信号
-  connect(m_toolButtonGroup,
-          &QButtonGroup::buttonClicked,
-          this,
-          &ScreenshotToolbar::onToolButtonClicked);
+  return ToolType::Rectangle; // 默认工具
 }
 
-void ScreenshotToolbar::createFunctionButtons()
+void ScreenshotToolbar::setUndoEnabled(bool enabled)
 {
-  // 创建功能按钮
-  m_undoButton = UIUtils::createToolbarButton({
-      this,
-      "recall_24.svg",
-      "撤销上一步",
-  });
-  connect(m_undoButton, &QPushButton::clicked, this, &ScreenshotToolbar::onUndoButtonClicked);
-
-  m_pinButton = UIUtils::createToolbarButton({
-      this,
-      "pin_24.svg",
-      "钉在桌面",
-  });
-  connect(m_pinButton, &QPushButton::toggled, this, &ScreenshotToolbar::onPinButtonClicked);
-
-  m_saveButton = UIUtils::createToolbarButton({
-      this,
-      "download_24.svg",
-      "保存图片",
-  });
-  connect(m_saveButton, &QPushButton::clicked, this, &ScreenshotToolbar::onSaveButtonClicked);
-
-  m_okButton = UIUtils::createToolbarButton({
-      this,
-      "tick_24.svg",
-      "复制到剪切板",
-  });
-  connect(m_okButton, &QPushButton::clicked, this, &ScreenshotToolbar::onOkButtonClicked);
-
-  m_cancelButton = UIUtils::createToolbarButton({
-      this,
-      "close_24.svg",
-      "取消",
-  });
-  connect(m_cancelButton, &QPushButton::clicked, this, &ScreenshotToolbar::onCancelButtonClicked);
+  for (size_t i = 0; i < m_buttons.size(); ++i)
+  {
+    Button& button = m_buttons[i];
+    if (!button.isTool && button.id == int(ActionType::Undo) && button.enabled != enabled)
+    {
+      button.enabled = enabled;
+      updateButton(int(i));
+    }
+  }
 }
 
-void ScreenshotToolbar::setupLayout()
+// 位置所在的按钮
+int ScreenshotToolbar::buttonAt(const QPoint& pos) const
 {
-  // 创建分隔线
-  m_separator1 = new QFrame(this);
-  m_separator1->setFrameShape(QFrame::VLine);
-  m_separator1->setFixedSize(1, 24);
-  m_separator1->setStyleSheet(UIUtilsConstants::DEFAULT_SEPARATOR_STYLE);
-
-  m_separator2 = new QFrame(this);
-  m_separator2->setFrameShape(QFrame::VLine);
-  m_separator2->setFixedSize(1, 24);
-  m_separator2->setStyleSheet(UIUtilsConstants::DEFAULT_SEPARATOR_STYLE);
-
-  // 设置主布局
-  m_mainLayout = new QHBoxLayout(this);
-  m_mainLayout->setContentsMargins(8, 4, 8, 4);
-  m_mainLayout->setSpacing(4);
-
-  // 添加工具按钮
-  m_mainLayout->addWidget(m_rectButton);
-  m_mainLayout->addWidget(m_stepButton);
-  m_mainLayout->addWidget(m_arrowButton);
-  m_mainLayout->addWidget(m_penButton);
-  m_mainLayout->addWidget(m_textButton);
-  m_mainLayout->addWidget(m_mosaicButton);
-  m_mainLayout->addWidget(m_markerButton);
-
-  // 添加分隔线1
-  m_mainLayout->addWidget(m_separator1);
-
-  // 添加功能按钮
-  m_mainLayout->addWidget(m_undoButton);
-  m_mainLayout->addWidget(m_pinButton);
-  m_mainLayout->addWidget(m_saveButton);
-
-  // 添加分隔线2
-  m_mainLayout->addWidget(m_separator2);
-
-  // 添加确定和取消按钮
-  m_mainLayout->addWidget(m_cancelButton);
-  m_mainLayout->addWidget(m_okButton);
+  for (size_t i = 0; i < m_buttons.size(); ++i)
+  {
+    if (m_buttons[i].rect.contains(pos))
+    {
+      return int(i);
+    }
+  }
+  return -1;
 }
 
-void ScreenshotToolbar::showAt(const QPoint& position)
+// 设置悬停的按钮
+void ScreenshotToolbar::setHoveredButton(int index)
 {
-  move(position);
-  show();
+  if (index == m_hoveredButton)
+  {
+    return;
+  }
+
+  updateButton(m_hoveredButton);
+  m_hoveredButton = index;
+  updateButton(m_hoveredButton);
 }
 
-void ScreenshotToolbar::hideToolbar()
+// 重绘按钮所在的区域
+void ScreenshotToolbar::updateButton(int index)
 {
-  hide();
+  if (index >= 0 && index < int(m_buttons.size()))
+  {
+    update(m_buttons[size_t(index)].rect);
+  }
 }
 
-ScreenshotToolbar::ToolType ScreenshotToolbar::getCurrentTool() const
+// 执行按钮的点击
+void ScreenshotToolbar::clickButton(int index)
 {
-  if (!m_toolButtonGroup)
+  Button& clicked = m_buttons[size_t(index)];
+  if (!clicked.enabled)
   {
-    return ToolType::Rectangle; // 默认工具
+    return;
   }
 
-  QAbstractButton* checkedButton = m_toolButtonGroup->checkedButton();
-  if (checkedButton)
+  if (clicked.isTool)
   {
-    int buttonId = m_toolButtonGroup->id(checkedButton);
-    return static_cast<ToolType>(buttonId);
+    // 工具按钮互斥：再次点击已选中的工具保持选中
+    for (size_t i = 0; i < m_buttons.size(); ++i)
+    {
+      Button& button = m_buttons[i];
+      const bool checked = int(i) == index;
+      if (button.isTool && button.checked != checked)
+      {
+        button.checked = checked;
+        updateButton(int(i));
+      }
+    }
+    m_isEditing = true;
+
+    qDebug() << "工具栏：选择工具" << clicked.id;
+    emit toolSelected(static_cast<ToolType>(clicked.id));
+    return;
   }
 
-  return ToolType::Rectangle; // 默认工具
-}
+  if (clicked.checkable)
+  {
+    clicked.checked = !clicked.checked;
+    updateButton(index);
+  }
 
-void ScreenshotToolbar::setUndoEnabled(bool enabled)
-{
-  if (m_undoButton)
+  const ActionType action = static_cast<ActionType>(clicked.id);
+  switch (action)
   {
-    m_undoButton->setEnabled(enabled);
+    case ActionType::Undo:
+      qDebug() << "工具栏：执行撤销操作";
+      break;
+    case ActionType::Pin:
+      qDebug() << "工具栏：钉在桌面";
+      break;
+    case ActionType::Save:
+      qDebug() << "工具栏：保存截图";
+      break;
+    case ActionType::Ok:
+      qDebug() << "工具栏：确定";
+      break;
+    case ActionType::Cancel:
+      qDebug() << "工具栏：取消";
+      break;
   }
+  emit actionTriggered(action);
 }
 
-QIcon ScreenshotToolbar::createToolIcon(const QString& iconFileName)
+// 工具提示
+bool ScreenshotToolbar::event(QEvent* event)
 {
-  return IconProvider::createToolIcon(iconFileName);
+  if (event->type() == QEvent::ToolTip)
+  {
+    QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+    const int index = buttonAt(helpEvent->pos());
+    if (index >= 0)
+    {
+      const Button& button = m_buttons[size_t(index)];
+      QToolTip::showText(helpEvent->globalPos(), button.toolTip, this, button.rect);
+    }
+    else
+    {
+      QToolTip::hideText();
+      event->ignore();
+    }
+    return true;
+  }
+  return QWidget::event(event);
 }
 
-QIcon ScreenshotToolbar::createWhiteSvgIcon(const QString& svgPath)
+// 绘制工具栏：只绘制与重绘区域相交的按钮
+void ScreenshotToolbar::paintEvent(QPaintEvent* event)
 {
-  return IconProvider::createWhiteSvgIcon(svgPath);
-}
+  QPainter painter(this);
+  painter.setRenderHint(QPainter::Antialiasing);
 
-// 槽函数实现
-void ScreenshotToolbar::onToolButtonClicked(QAbstractButton* button)
-{
-  int buttonId = m_toolButtonGroup->id(button);
-  ToolType tool = static_cast<ToolType>(buttonId);
-  m_isEditing = true;
+  // 背景和边框（边框画笔居中于路径，向内缩进半个像素保持清晰）
+  painter.setPen(QPen(TOOLBAR_BORDER, 1));
+  painter.setBrush(TOOLBAR_BACKGROUND);
+  painter.drawRoundedRect(QRectF(rect()).adjusted(0.5, 0.5, -0.5, -0.5),
+                          TOOLBAR_RADIUS,
+                          TOOLBAR_RADIUS);
+
+  for (const QRect& separator : m_separators)
+  {
+    if (separator.intersects(event->rect()))
+    {
+      painter.fillRect(separator, SEPARATOR_COLOR);
+    }
+  }
 
-  qDebug() << "工具栏：选择工具" << buttonId;
-  emit toolSelected(tool);
+  for (size_t i = 0; i < m_buttons.size(); ++i)
+  {
+    Button& button = m_buttons[i];
+    if (button.rect.intersects(event->rect()))
+    {
+      const bool hovered = int(i) == m_hoveredButton && button.enabled;
+      const bool pressed = hovered && int(i) == m_pressedButton;
+      paintButton(painter, button, hovered, pressed);
+    }
+  }
 }
 
-void ScreenshotToolbar::onUndoButtonClicked()
+// 绘制一个按钮：状态背景和居中的图标
+void ScreenshotToolbar::paintButton(QPainter& painter, Button& button, bool hovered, bool pressed)
 {
-  qDebug() << "工具栏：执行撤销操作";
-  emit actionTriggered(ActionType::Undo);
+  QColor background;
+  if (button.checked)
+  {
+    background = BUTTON_CHECKED;
+  }
+  else if (pressed)
+  {
+    background = BUTTON_PRESSED;
+  }
+  else if (hovered)
+  {
+    background = BUTTON_HOVER;
+  }
+
+  if (background.isValid())
+  {
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(background);
+    painter.drawRoundedRect(button.rect, BUTTON_RADIUS, BUTTON_RADIUS);
+  }
+
+  // 图标按当前设备像素比从图集中取出一次，之后直接贴图
+  const qreal ratio = devicePixelRatioF();
+  if (button.pixmapRatio != ratio)
+  {
+    button.pixmap = button.icon.pixmap(QSize(ICON_SIZE, ICON_SIZE), ratio);
+    button.pixmapRatio = ratio;
+  }
+
+  const QRect iconRect(button.rect.center() - QPoint(ICON_SIZE / 2 - 1, ICON_SIZE / 2 - 1),
+                       QSize(ICON_SIZE, ICON_SIZE));
+  painter.setOpacity(button.enabled ? 1.0 : DISABLED_OPACITY);
+  painter.drawPixmap(iconRect, button.pixmap);
+  painter.setOpacity(1.0);
 }
 
-void ScreenshotToolbar::onPinButtonClicked()
+// 鼠标按下：记录按下的按钮，事件不再传给覆盖层
+void ScreenshotToolbar::mousePressEvent(QMouseEvent* event)
 {
-  qDebug() << "工具栏：钉在桌面";
-  emit actionTriggered(ActionType::Pin);
+  if (event->button() == Qt::LeftButton)
+  {
+    m_pressedButton = buttonAt(event->pos());
+    updateButton(m_pressedButton);
+  }
+  event->accept();
 }
 
-void ScreenshotToolbar::onSaveButtonClicked()
+// 鼠标移动：更新悬停的按钮
+void ScreenshotToolbar::mouseMoveEvent(QMouseEvent* event)
 {
-  qDebug() << "工具栏：保存截图";
-  emit actionTriggered(ActionType::Save);
+  setHoveredButton(buttonAt(event->pos()));
+  event->accept();
 }
 
-void ScreenshotToolbar::onOkButtonClicked()
+// 鼠标释放：在按下的同一个按钮上释放才算点击
+void ScreenshotToolbar::mouseReleaseEvent(QMouseEvent* event)
 {
-  qDebug() << "工具栏：确定";
-  emit actionTriggered(ActionType::Ok);
+  if (event->button() == Qt::LeftButton && m_pressedButton >= 0)
+  {
+    const int pressed = m_pressedButton;
+    m_pressedButton = -1;
+    updateButton(pressed);
+    if (buttonAt(event->pos()) == pressed)
+    {
+      clickButton(pressed);
+    }
+  }
+  event->accept();
 }
 
-void ScreenshotToolbar::onCancelButtonClicked()
+// 鼠标离开：清除悬停状态
+void ScreenshotToolbar::leaveEvent(QEvent* event)
 {
-  qDebug() << "工具栏：取消";
-  emit actionTriggered(ActionType::Cancel);
-}
\ No newline at end of file
+  setHoveredButton(-1);
+  QWidget::leaveEvent(event);
+}
@@ -1,17 +1,20 @@
 #ifndef SCREENSHOTTOOLBAR_H
 #define SCREENSHOTTOOLBAR_H
 
-#include <QButtonGroup>
-#include <QFrame>
-#include <QHBoxLayout>
 #include <QIcon>
-#include <QPushButton>
-#include <QStyle>
+#include <QPainter>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QString>
 #include <QWidget>
+#include <vector>
 
 /**
  * 截图工具栏组件
  * 提供截图编辑和操作的工具按钮界面
+ * 整个工具栏是一个自绘部件：按钮的命中测试、悬停、按下和选中状态都在内部处理，
+ * 不使用子控件和样式表，状态变化只重绘对应按钮的区域
  */
 class ScreenshotToolbar : public QWidget
 {
@@ -47,6 +50,7 @@ public:
   // 显示和隐藏工具栏
   void showAt(const QPoint& position);
   void hideToolbar();
+  void reset(); // 恢复初始状态（隐藏、退出编辑、取消工具选择），覆盖层复用时调用
 
   // 获取当前选中的工具
   ToolType getCurrentTool() const;
@@ -61,49 +65,56 @@ signals:
   // 功能按钮点击信号
   void actionTriggered(ActionType action);
 
-private slots:
-  // 内部槽函数
-  void onToolButtonClicked(QAbstractButton* button);
-  void onUndoButtonClicked();
-  void onPinButtonClicked();
-  void onSaveButtonClicked();
-  void onOkButtonClicked();
-  void onCancelButtonClicked();
+protected:
+  // 重写的事件处理函数
+  bool event(QEvent* event) override; // 工具提示
+  void paintEvent(QPaintEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+  void mouseReleaseEvent(QMouseEvent* event) override;
+  void leaveEvent(QEvent* event) override;
 
 private:
+  // 工具栏按钮
+  struct Button
+  {
+    QString iconName;        // 图标文件名
+    QString toolTip;         // 工具提示
+    bool isTool = false;     // 是否为互斥的工具按钮
+    int id = 0;              // 工具按钮为ToolType，功能按钮为ActionType
+    bool checkable = false;  // 是否可切换选中状态
+    bool checked = false;    // 是否选中
+    bool enabled = true;     // 是否可用
+    QRect rect;              // 按钮区域
+    QIcon icon;              // 图标（来自图标图集）
+    QPixmap pixmap;          // 按当前设备像素比取出的图标
+    qreal pixmapRatio = 0.0; // pixmap对应的设备像素比
+  };
+
   // 初始化方法
-  void initializeUI();
-  void createToolButtons();
-  void createFunctionButtons();
-  void setupLayout();
-
-  // 图标创建方法
-  QIcon createToolIcon(const QString& iconFileName);
-  QIcon createWhiteSvgIcon(const QString& svgPath);
-
-  // UI组件
-  QHBoxLayout* m_mainLayout;
-
-  // 工具按钮组
-  QButtonGroup* m_toolButtonGroup;
-  QPushButton* m_rectButton;   // 矩形/椭圆工具
-  QPushButton* m_stepButton;   // 步骤标注工具
-  QPushButton* m_arrowButton;  // 箭头工具
-  QPushButton* m_penButton;    // 画笔工具
-  QPushButton* m_textButton;   // 文字工具
-  QPushButton* m_mosaicButton; // 马赛克工具
-  QPushButton* m_markerButton; // 区域高亮工具
-
-  // 功能按钮
-  QPushButton* m_undoButton;   // 撤销按钮
-  QPushButton* m_pinButton;    // 钉在桌面按钮
-  QPushButton* m_saveButton;   // 保存按钮
-  QPushButton* m_okButton;     // 确定按钮
-  QPushButton* m_cancelButton; // 取消按钮
-
-  // 分隔线
-  QFrame* m_separator1;
-  QFrame* m_separator2;
+  void createButtons(); // 创建按钮并计算布局
+
+  // 按钮状态
+  int buttonAt(const QPoint& pos) const; // 位置所在的按钮，不在任何按钮上时为-1
+  void setHoveredButton(int index);      // 设置悬停的按钮（只重绘变化的按钮）
+  void updateButton(int index);          // 重绘按钮所在的区域
+  void clickButton(int index);           // 执行按钮的点击
+  void paintButton(QPainter& painter, Button& button, bool hovered, bool pressed);
+
+  std::vector<Button> m_buttons;   // 所有按钮（从左到右）
+  std::vector<QRect> m_separators; // 分隔线区域
+  int m_hoveredButton;             // 鼠标悬停的按钮
+  int m_pressedButton;             // 鼠标按下的按钮
+
+  // 常量定义
+  static constexpr int BUTTON_SIZE = 32;      // 按钮尺寸
+  static constexpr int ICON_SIZE = 16;        // 图标尺寸
+  static constexpr int BUTTON_RADIUS = 4;     // 按钮背景圆角
+  static constexpr int TOOLBAR_RADIUS = 8;    // 工具栏背景圆角
+  static constexpr int SPACING = 4;           // 按钮间距
+  static constexpr int MARGIN_X = 8;          // 左右边距
+  static constexpr int MARGIN_Y = 4;          // 上下边距
+  static constexpr int SEPARATOR_HEIGHT = 24; // 分隔线高度
 };
 
-#endif // SCREENSHOTTOOLBAR_H
\ No newline at end of file
+#endif // SCREENSHOTTOOLBAR_H
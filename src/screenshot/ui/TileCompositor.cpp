@@ -0,0 +1,172 @@
+#include "TileCompositor.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "../core/ScreenshotFrame.h"
+
+// 构造函数
+TileCompositor::TileCompositor() : m_devicePixelRatio(1.0)
+{
+  // GUI线程也参与合成，线程池只需要补足剩余的核心
+  m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+// 析构函数
+TileCompositor::~TileCompositor()
+{
+  m_pool.waitForDone();
+}
+
+// 确保后台缓冲区与窗口尺寸一致
+bool TileCompositor::resize(const QSize& logicalSize, qreal devicePixelRatio)
+{
+  QSize deviceSize(qRound(logicalSize.width() * devicePixelRatio),
+                   qRound(logicalSize.height() * devicePixelRatio));
+  if (m_backBuffer.size() == deviceSize && m_devicePixelRatio == devicePixelRatio)
+  {
+    return false;
+  }
+
+  m_devicePixelRatio = devicePixelRatio;
+  m_backBuffer = QImage(deviceSize, ScreenshotFrameView::FORMAT);
+  if (m_backBuffer.isNull())
+  {
+    qWarning() << "后台缓冲区内存分配失败，尺寸:" << deviceSize;
+    return true;
+  }
+
+  qDebug() << "后台缓冲区已分配，尺寸:" << deviceSize << "线程数:" << m_pool.maxThreadCount() + 1;
+  return true;
+}
+
+// 释放后台缓冲区
+void TileCompositor::release()
+{
+  if (!m_backBuffer.isNull())
+  {
+    qDebug() << "后台缓冲区已释放，尺寸:" << m_backBuffer.size();
+  }
+  m_backBuffer = QImage();
+}
+
+// 在指定区域内合成场景
+void TileCompositor::compose(const QRegion& region, const TilePainter& paintTile)
+{
+  if (m_backBuffer.isNull() || region.isEmpty())
+  {
+    return;
+  }
+
+  // 按固定网格切分脏区域，每个分块只重绘与脏区域相交的部分
+  const QRect bounds = region.boundingRect().intersected(
+      QRect(QPoint(0, 0), (QSizeF(m_backBuffer.size()) / m_devicePixelRatio).toSize()));
+  std::vector<Tile> tiles;
+  for (int y = bounds.top() / TILE_SIZE * TILE_SIZE; y <= bounds.bottom(); y += TILE_SIZE)
+  {
+    for (int x = bounds.left() / TILE_SIZE * TILE_SIZE; x <= bounds.right(); x += TILE_SIZE)
+    {
+      QRect rect(x, y, TILE_SIZE, TILE_SIZE);
+      QRegion clip = region.intersected(rect);
+      if (!clip.isEmpty())
+      {
+        tiles.push_back({rect, clip, QRect()});
+      }
+    }
+  }
+
+  // 所有分块共享同一块像素内存，各自使用独立的QImage包装，互不重叠
+  uchar* bits = m_backBuffer.bits();
+
+  if (int(tiles.size()) < MIN_PARALLEL_TILES)
+  {
+    // 分块很少时线程调度的开销大于收益
+    for (const Tile& tile : tiles)
+    {
+      this->paintTile(bits, tile, paintTile);
+    }
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // 工作线程和GUI线程从同一个计数器领取分块，先完成的线程继续领取剩余分块
+  std::atomic<int> nextTile(0);
+  auto worker = [&]()
+  {
+    for (int i = nextTile++; i < int(tiles.size()); i = nextTile++)
+    {
+      this->paintTile(bits, tiles[i], paintTile);
+    }
+  };
+
+  const int helpers = qMin(m_pool.maxThreadCount(), int(tiles.size()) - 1);
+  for (int i = 0; i < helpers; ++i)
+  {
+    m_pool.start(worker);
+  }
+  worker();
+  m_pool.waitForDone();
+
+  qDebug() << "并行合成" << tiles.size() << "个分块，耗时:" << timer.nsecsElapsed() / 1000 << "us";
+}
+
+// 把后台缓冲区呈现到窗口
+void TileCompositor::present(QPainter& painter) const
+{
+  // 后台缓冲区完全不透明，直接拷贝像素，无需混合
+  painter.save();
+  painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+  // 抵消窗口的设备像素比缩放，在物理像素坐标系中绘制：
+  // 非整数缩放比例（1.25/1.5/1.75）下Qt不会再逐帧重采样整张图像，而是直接拷贝
+  if (m_devicePixelRatio != 1.0)
+  {
+    painter.setWorldTransform(
+        QTransform::fromScale(1.0 / m_devicePixelRatio, 1.0 / m_devicePixelRatio));
+  }
+  painter.drawImage(QPoint(0, 0), m_backBuffer);
+  painter.restore();
+}
+
+// 获取后台缓冲区
+const QImage& TileCompositor::backBuffer() const
+{
+  return m_backBuffer;
+}
+
+// 绘制单个分块（在工作线程中执行）
+void TileCompositor::paintTile(uchar* bits, Tile tile, const TilePainter& paintTile) const
+{
+  tile.deviceRect = ScreenshotFrame::mapToDevice(tile.rect, m_devicePixelRatio)
+                        .intersected(m_backBuffer.rect());
+  if (tile.deviceRect.isEmpty())
+  {
+    return;
+  }
+
+  // 包装分块对应的像素区域，每个分块拥有独立的绘制设备
+  uchar* tileBits = bits + tile.deviceRect.y() * m_backBuffer.bytesPerLine() +
+                    tile.deviceRect.x() * int(sizeof(QRgb));
+  QImage pixels(tileBits,
+                tile.deviceRect.width(),
+                tile.deviceRect.height(),
+                m_backBuffer.bytesPerLine(),
+                ScreenshotFrameView::FORMAT);
+  QImage target(tileBits,
+                tile.deviceRect.width(),
+                tile.deviceRect.height(),
+                m_backBuffer.bytesPerLine(),
+                ScreenshotFrameView::FORMAT);
+  target.setDevicePixelRatio(m_devicePixelRatio);
+
+  // 分块边长乘以常见的缩放比例都是整数，分块左上角的逻辑坐标正好对应物理像素边界
+  QPainter painter(&target);
+  painter.translate(-tile.rect.topLeft());
+  painter.setClipRegion(tile.clip);
+  paintTile(painter, pixels, tile);
+}
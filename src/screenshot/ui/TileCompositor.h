@@ -0,0 +1,58 @@
+#ifndef TILECOMPOSITOR_H
+#define TILECOMPOSITOR_H
+
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+#include <QRegion>
+#include <QSize>
+#include <QThreadPool>
+#include <functional>
+
+// 分块并行合成器 - 把覆盖层场景按屏幕分块，在线程池中并行绘制到后台缓冲区
+// GUI线程只负责把后台缓冲区中变化的部分呈现到窗口
+class TileCompositor
+{
+public:
+  // 单个分块
+  struct Tile
+  {
+    QRect rect;       // 分块矩形（逻辑坐标）
+    QRegion clip;     // 分块内需要重绘的区域（逻辑坐标）
+    QRect deviceRect; // 分块在后台缓冲区中的物理像素矩形
+  };
+
+  // 分块绘制函数，在工作线程中调用
+  // painter：使用逻辑坐标，已裁剪到本帧的脏区域
+  // pixels：同一块内存的物理像素视图（左上角对应deviceRect的左上角），可以直接按行写入；
+  //         需要在使用painter绘制之前写入
+  using TilePainter = std::function<void(QPainter& painter, QImage& pixels, const Tile& tile)>;
+
+  TileCompositor();
+  ~TileCompositor();
+
+  // 确保后台缓冲区与窗口尺寸一致，尺寸变化时返回true（缓冲区内容需要完整重绘）
+  bool resize(const QSize& logicalSize, qreal devicePixelRatio);
+  // 释放后台缓冲区（空闲时不保留上一次截图的像素），下一次resize重新分配
+  void release();
+
+  // 在指定区域内合成场景，阻塞直到所有分块完成
+  void compose(const QRegion& region, const TilePainter& paintTile);
+
+  // 把后台缓冲区按物理像素1:1呈现到窗口（窗口绘制已裁剪到更新区域）
+  void present(QPainter& painter) const;
+
+  const QImage& backBuffer() const;
+
+private:
+  void paintTile(uchar* bits, Tile tile, const TilePainter& paintTile) const;
+
+  QImage m_backBuffer;      // 后台缓冲区（物理像素，设备像素比保持为1）
+  qreal m_devicePixelRatio; // 窗口的设备像素比
+  QThreadPool m_pool;       // 合成线程池
+
+  static constexpr int TILE_SIZE = 256;        // 分块边长（逻辑像素）
+  static constexpr int MIN_PARALLEL_TILES = 4; // 分块数少于该值时直接在GUI线程绘制
+};
+
+#endif // TILECOMPOSITOR_H
@@ -12,6 +12,10 @@ SystemTray::SystemTray(QObject* parent)
     ,
     m_screenshotAction(nullptr) // 初始化截图动作指针为空
     ,
+    m_traceExportAction(nullptr) // 初始化导出跟踪数据动作指针为空
+    ,
+    m_cancelExportAction(nullptr) // 初始化取消保存动作指针为空
+    ,
     m_exitAction(nullptr) // 初始化退出动作指针为空
 {
   createTrayIcon(); // 创建托盘图标
@@ -50,6 +54,21 @@ void SystemTray::createMenu()
           this,
           &SystemTray::onScreenshotAction); // 到截图动作处理函数
 
+  // 创建导出跟踪数据动作
+  m_traceExportAction = new QAction("导出性能跟踪", this); // 创建导出跟踪数据动作
+  connect(m_traceExportAction,
+          &QAction::triggered, // 连接动作触发信号
+          this,
+          &SystemTray::onTraceExportAction); // 到导出跟踪数据处理函数
+
+  // 创建取消保存动作（只在有正在进行的导出时可用）
+  m_cancelExportAction = new QAction("取消保存", this); // 创建取消保存动作
+  m_cancelExportAction->setEnabled(false);              // 默认没有正在进行的导出
+  connect(m_cancelExportAction,
+          &QAction::triggered, // 连接动作触发信号
+          this,
+          &SystemTray::onCancelExportAction); // 到取消保存处理函数
+
   // 创建退出动作
   m_exitAction = new QAction("退出", this); // 创建退出动作，显示文字为"退出"
   connect(m_exitAction,
@@ -58,9 +77,11 @@ void SystemTray::createMenu()
           &SystemTray::onExitAction); // 到退出动作处理函数
 
   // 添加到菜单
-  m_trayMenu->addAction(m_screenshotAction); // 添加截图动作到菜单
-  m_trayMenu->addSeparator();                // 添加分隔线
-  m_trayMenu->addAction(m_exitAction);       // 添加退出动作到菜单
+  m_trayMenu->addAction(m_screenshotAction);   // 添加截图动作到菜单
+  m_trayMenu->addAction(m_cancelExportAction); // 添加取消保存动作到菜单
+  m_trayMenu->addAction(m_traceExportAction);  // 添加导出跟踪数据动作到菜单
+  m_trayMenu->addSeparator();                  // 添加分隔线
+  m_trayMenu->addAction(m_exitAction);         // 添加退出动作到菜单
 
   // 设置上下文菜单
   setContextMenu(m_trayMenu); // 设置右键菜单
@@ -95,4 +116,24 @@ void SystemTray::onExitAction()
 {
   qDebug() << "托盘：请求退出"; // 输出调试信息
   emit exitRequested();         // 发射退出请求信号
-}
\ No newline at end of file
+}
+
+// 处理导出跟踪数据动作触发
+void SystemTray::onTraceExportAction()
+{
+  qDebug() << "托盘：请求导出跟踪数据"; // 输出调试信息
+  emit traceExportRequested();          // 发射导出跟踪数据信号
+}
+
+// 处理取消保存动作触发
+void SystemTray::onCancelExportAction()
+{
+  qDebug() << "托盘：请求取消保存"; // 输出调试信息
+  emit exportCancelRequested();     // 发射取消保存信号
+}
+
+// 设置是否有正在进行的导出
+void SystemTray::setExportInProgress(bool inProgress)
+{
+  m_cancelExportAction->setEnabled(inProgress); // 只有导出进行中时可以取消
+}
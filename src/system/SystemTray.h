@@ -13,12 +13,18 @@ class SystemTray : public QSystemTrayIcon
         public :
         // 构造函数：创建系统托盘，接收父对象参数
         explicit SystemTray(QObject *parent = nullptr);
+    // 设置是否有正在进行的导出（决定"取消保存"是否可用）
+    void setExportInProgress(bool inProgress);
 
 signals:
     // 信号：请求截图
     void screenshotRequested();
     // 信号：请求退出应用程序
     void exitRequested();
+    // 信号：请求导出跟踪数据
+    void traceExportRequested();
+    // 信号：请求取消所有正在进行的截图保存
+    void exportCancelRequested();
 
 private slots:
     // 私有槽函数：处理托盘图标激活事件
@@ -27,6 +33,10 @@ private slots:
     void onScreenshotAction();
     // 私有槽函数：处理退出动作触发
     void onExitAction();
+    // 私有槽函数：处理导出跟踪数据动作触发
+    void onTraceExportAction();
+    // 私有槽函数：处理取消保存动作触发
+    void onCancelExportAction();
 
 private:
     // 私有成员函数：创建托盘图标
@@ -35,9 +45,11 @@ private:
     void createMenu();
 
     // 私有成员变量
-    QMenu *m_trayMenu;           // 托盘右键菜单
-    QAction *m_screenshotAction; // 截图动作
-    QAction *m_exitAction;       // 退出动作
+    QMenu *m_trayMenu;             // 托盘右键菜单
+    QAction *m_screenshotAction;   // 截图动作
+    QAction *m_traceExportAction;  // 导出跟踪数据动作
+    QAction *m_cancelExportAction; // 取消保存动作
+    QAction *m_exitAction;         // 退出动作
 };
 
 #endif // SYSTEMTRAY_H      // 防止头文件重复包含的宏定义结束
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "ImageEncoder.h"
+
+#include <QDebug>
+#include <QImageWriter>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+
+#include "JpegEncoder.h"
+#include "PngEncoder.h"
+#include "QoiCodec.h"
+
+namespace
+{
+std::atomic<int> configuredThreadCount(0); // 设置的线程数，0表示使用全部核心
+
+// 编码线程池（有意不释放，应用退出时仍在编码的导出任务可以安全结束）
+QThreadPool* encoderPool()
+{
+  static QThreadPool* pool = []()
+  {
+    QThreadPool* threadPool = new QThreadPool();
+    threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1)); // 调用线程也参与编码
+    return threadPool;
+  }();
+  return pool;
+}
+} // namespace
+
+// 编码图像并写入设备
+bool ImageEncoder::write(const QImage& image,
+                         QIODevice* device,
+                         const QByteArray& format,
+                         Level level,
+                         int quality,
+                         QString* errorMessage,
+                         const Progress& progress)
+{
+  const QByteArray name = format.toLower();
+  if (name == "png" && PngEncoder::isAvailable())
+  {
+    return PngEncoder::write(image, device, level, errorMessage, progress);
+  }
+  if (name == "jpg" || name == "jpeg")
+  {
+    return JpegEncoder::write(image, device, level, quality, errorMessage, progress);
+  }
+  if (name == "qoi")
+  {
+    return QoiEncoder::write(image, device, errorMessage, progress); // 单遍编码，没有等级和质量
+  }
+
+  // 其他格式使用Qt的编码器
+  QImageWriter writer(device, format);
+  writer.setQuality(quality);
+  if (!writer.write(image))
+  {
+    if (errorMessage)
+    {
+      *errorMessage = writer.errorString();
+    }
+    return false;
+  }
+  if (progress)
+  {
+    progress(100);
+  }
+  return true;
+}
+
+// 默认等级
+ImageEncoder::Level ImageEncoder::defaultLevel()
+{
+  return levelFromName(qgetenv("OPENCAP_ENCODE_LEVEL"), Level::Balanced);
+}
+
+// 按名称解析等级
+ImageEncoder::Level ImageEncoder::levelFromName(const QByteArray& name, Level fallback)
+{
+  const QByteArray value = name.trimmed().toLower();
+  if (value == "fast")
+  {
+    return Level::Fast;
+  }
+  if (value == "balanced")
+  {
+    return Level::Balanced;
+  }
+  if (value == "small")
+  {
+    return Level::Small;
+  }
+
+  if (!value.isEmpty())
+  {
+    qWarning() << "未知的编码等级:" << name << "使用:" << levelName(fallback);
+  }
+  return fallback;
+}
+
+// 等级名称
+const char* ImageEncoder::levelName(Level level)
+{
+  switch (level)
+  {
+    case Level::Fast:
+      return "fast";
+    case Level::Balanced:
+      return "balanced";
+    case Level::Small:
+      return "small";
+  }
+  return "balanced";
+}
+
+// 设置参与编码的线程数
+void ImageEncoder::setThreadCount(int threadCount)
+{
+  configuredThreadCount.store(qMax(0, threadCount), std::memory_order_relaxed);
+}
+
+// 参与编码的线程数
+int ImageEncoder::threadCount()
+{
+  const int count = configuredThreadCount.load(std::memory_order_relaxed);
+  return count > 0 ? count : encoderPool()->maxThreadCount() + 1;
+}
+
+// 并行执行任务
+void ImageEncoder::parallelFor(int count, const std::function<void(int)>& task)
+{
+  std::atomic<int> nextTask(0);
+  auto worker = [&]()
+  {
+    for (int i = nextTask++; i < count; i = nextTask++)
+    {
+      task(i);
+    }
+  };
+
+  // 线程池可能被其他导出任务占满：稍后才开始的辅助线程领不到任务会直接结束，
+  // 只需要等待本次启动的辅助线程，不能等待整个线程池
+  const int helpers = qMin(threadCount() - 1, count - 1);
+  QSemaphore finished;
+  for (int i = 0; i < helpers; ++i)
+  {
+    encoderPool()->start(
+        [&]()
+        {
+          worker();
+          finished.release();
+        });
+  }
+  worker();
+  finished.acquire(qMax(0, helpers));
+}
@@ -0,0 +1,70 @@
+#ifndef IMAGEENCODER_H
+#define IMAGEENCODER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QImage>
+#include <QString>
+#include <functional>
+
+/**
+ * 图像编码器
+ * 大尺寸截图的PNG和JPEG编码按行切分成条带，在编码线程池中并行压缩，输出仍然是单个标准文件：
+ * PNG的每个条带独立deflate后拼接成一个zlib数据流，JPEG的每个条带是一个重启间隔
+ * QOI逐行单遍编码；其他格式（以及编译时没有zlib的PNG）交给QImageWriter
+ */
+class ImageEncoder
+{
+public:
+  // 私有构造函数（静态类）
+  ImageEncoder() = delete;
+
+  // 速度/体积等级
+  enum class Level
+  {
+    Fast,     // 最快：PNG使用固定的行过滤器和最低压缩等级
+    Balanced, // 默认：PNG逐行选择过滤器，压缩等级6
+    Small     // 最小：PNG最高压缩等级；JPEG按图像内容生成最优霍夫曼表（编码两遍）
+  };
+
+  // 编码进度回调（0~100）：并行编码时在编码线程中调用，不同线程报告的进度可能乱序到达
+  using Progress = std::function<void(int percent)>;
+
+  /**
+   * 编码图像并写入设备
+   * @param image 要编码的图像
+   * @param device 已打开的目标设备
+   * @param format 图像格式（png/jpg/jpeg使用并行编码器，qoi使用QoiEncoder，其他使用QImageWriter）
+   * @param level 速度/体积等级
+   * @param quality 编码质量（JPEG为1~100，-1表示默认值75；PNG和QOI忽略该参数）
+   * @param errorMessage 失败时写入错误信息，可以为空
+   * @param progress 进度回调，可以为空（QImageWriter编码的格式只在完成时报告100）
+   * @return 是否成功
+   */
+  static bool write(const QImage& image,
+                    QIODevice* device,
+                    const QByteArray& format,
+                    Level level = Level::Balanced,
+                    int quality = -1,
+                    QString* errorMessage = nullptr,
+                    const Progress& progress = Progress());
+
+  // 默认等级：环境变量 OPENCAP_ENCODE_LEVEL=fast|balanced|small，未设置时为Balanced
+  static Level defaultLevel();
+  static Level levelFromName(const QByteArray& name, Level fallback); // 按名称解析等级
+  static const char* levelName(Level level);                          // 等级名称
+
+  // 参与编码的线程数（包括调用线程），0表示使用全部核心；用于基准测试对比单线程编码
+  static void setThreadCount(int threadCount);
+  static int threadCount();
+
+  /**
+   * 并行执行count个任务：调用线程和编码线程池从同一个计数器领取任务，全部完成后返回
+   * 多个导出任务同时编码时共享线程池，调用线程始终参与，不会互相等待
+   * @param count 任务数量
+   * @param task 任务函数，参数为任务序号
+   */
+  static void parallelFor(int count, const std::function<void(int)>& task);
+};
+
+#endif // IMAGEENCODER_H
@@ -0,0 +1,761 @@
+#include "JpegEncoder.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "TraceRecorder.h"
+
+namespace
+{
+constexpr int MCU_SIZE = 16;         // 4:2:0采样下一个MCU覆盖16x16像素
+constexpr int MAX_DIMENSION = 65535; // JPEG的最大宽高
+constexpr int DEFAULT_QUALITY = 75;  // 与Qt的JPEG编码器相同的默认质量
+
+// 之字形序号到自然序号的映射
+constexpr uchar ZIGZAG[64] = {0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+                              12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+                              35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+                              58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+// 标准量化表（自然顺序，JPEG标准附录K.1）
+constexpr uchar LUMA_QUANT[64] = {16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,
+                                  58, 60, 55, 14, 13,  16,  24,  40,  57, 69, 56, 14, 17,
+                                  22, 29, 51, 87, 80,  62,  18,  22,  37, 56, 68, 109, 103,
+                                  77, 24, 35, 55, 64,  81,  104, 113, 92, 49, 64, 78,  87,
+                                  103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+constexpr uchar CHROMA_QUANT[64] = {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99,
+                                    99, 99, 99, 24, 26, 56, 99, 99, 99, 99, 99, 47, 66,
+                                    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+                                    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+                                    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+
+// 标准霍夫曼表（JPEG标准附录K.3）：各码长的码字数量（1~16位）和符号
+constexpr uchar DC_LUMA_BITS[16] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+constexpr uchar DC_CHROMA_BITS[16] = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+constexpr uchar DC_VALUES[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+constexpr uchar AC_LUMA_BITS[16] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d};
+constexpr uchar AC_LUMA_VALUES[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+    0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52,
+    0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25,
+    0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45,
+    0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64,
+    0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83,
+    0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6,
+    0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3,
+    0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+    0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+constexpr uchar AC_CHROMA_BITS[16] = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77};
+constexpr uchar AC_CHROMA_VALUES[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61,
+    0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33,
+    0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18,
+    0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44,
+    0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63,
+    0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+    0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+    0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4,
+    0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca,
+    0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7,
+    0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+
+// 霍夫曼表序号
+enum Table
+{
+  DC_LUMA = 0,
+  AC_LUMA = 1,
+  DC_CHROMA = 2,
+  AC_CHROMA = 3,
+  TABLE_COUNT = 4
+};
+
+// 霍夫曼表定义（写入DHT段）
+struct HuffmanSpec
+{
+  std::array<uchar, 16> bits{}; // 各码长（1~16位）的码字数量
+  std::vector<uchar> values;    // 按码长排列的符号
+};
+
+// 由表定义生成的编码表（JPEG标准附录C）
+struct HuffmanCode
+{
+  std::array<quint16, 256> code{}; // 符号的码字
+  std::array<uchar, 256> size{};   // 符号的码长（0表示没有码字）
+
+  explicit HuffmanCode(const HuffmanSpec& spec)
+  {
+    int next = 0;
+    int index = 0;
+    for (int length = 1; length <= 16; ++length)
+    {
+      for (int i = 0; i < spec.bits[size_t(length - 1)]; ++i, ++index)
+      {
+        const uchar symbol = spec.values[size_t(index)];
+        code[symbol] = quint16(next++);
+        size[symbol] = uchar(length);
+      }
+      next <<= 1;
+    }
+  }
+};
+
+HuffmanSpec makeSpec(const uchar* bits, const uchar* values)
+{
+  HuffmanSpec spec;
+  int count = 0;
+  for (int i = 0; i < 16; ++i)
+  {
+    spec.bits[size_t(i)] = bits[i];
+    count += bits[i];
+  }
+  spec.values.assign(values, values + count);
+  return spec;
+}
+
+// 按符号频率生成最优霍夫曼表，码长限制在16位以内（JPEG标准附录K.2，与libjpeg的做法相同）
+HuffmanSpec optimalSpec(const std::array<qint64, 256>& symbolFrequency)
+{
+  std::array<qint64, 257> frequency{};
+  std::copy(symbolFrequency.begin(), symbolFrequency.end(), frequency.begin());
+  frequency[256] = 1; // 保留一个码字，保证不会出现全1的码字
+
+  std::array<int, 257> codeSize{};
+  std::array<int, 257> others;
+  others.fill(-1);
+
+  // 反复合并频率最小的两个节点，同时累计每个符号的码长
+  for (;;)
+  {
+    int c1 = -1;
+    qint64 v = std::numeric_limits<qint64>::max();
+    for (int i = 0; i <= 256; ++i)
+    {
+      if (frequency[size_t(i)] != 0 && frequency[size_t(i)] <= v)
+      {
+        v = frequency[size_t(i)];
+        c1 = i;
+      }
+    }
+    int c2 = -1;
+    v = std::numeric_limits<qint64>::max();
+    for (int i = 0; i <= 256; ++i)
+    {
+      if (frequency[size_t(i)] != 0 && frequency[size_t(i)] <= v && i != c1)
+      {
+        v = frequency[size_t(i)];
+        c2 = i;
+      }
+    }
+    if (c2 < 0)
+    {
+      break;
+    }
+
+    frequency[size_t(c1)] += frequency[size_t(c2)];
+    frequency[size_t(c2)] = 0;
+    ++codeSize[size_t(c1)];
+    while (others[size_t(c1)] >= 0)
+    {
+      c1 = others[size_t(c1)];
+      ++codeSize[size_t(c1)];
+    }
+    others[size_t(c1)] = c2;
+    ++codeSize[size_t(c2)];
+    while (others[size_t(c2)] >= 0)
+    {
+      c2 = others[size_t(c2)];
+      ++codeSize[size_t(c2)];
+    }
+  }
+
+  // 统计各码长的码字数量，把超过16位的码字调整到16位以内
+  std::array<int, 33> bits{};
+  for (int i = 0; i <= 256; ++i)
+  {
+    if (codeSize[size_t(i)] > 0)
+    {
+      ++bits[size_t(qMin(codeSize[size_t(i)], 32))];
+    }
+  }
+  for (int i = 32; i > 16; --i)
+  {
+    while (bits[size_t(i)] > 0)
+    {
+      int j = i - 2;
+      while (bits[size_t(j)] == 0)
+      {
+        --j;
+      }
+      bits[size_t(i)] -= 2;
+      ++bits[size_t(i - 1)];
+      bits[size_t(j + 1)] += 2;
+      --bits[size_t(j)];
+    }
+  }
+  int longest = 16;
+  while (bits[size_t(longest)] == 0)
+  {
+    --longest;
+  }
+  --bits[size_t(longest)]; // 去掉保留的码字
+
+  HuffmanSpec spec;
+  for (int i = 1; i <= 16; ++i)
+  {
+    spec.bits[size_t(i - 1)] = uchar(bits[size_t(i)]);
+  }
+  for (int length = 1; length <= 32; ++length)
+  {
+    for (int symbol = 0; symbol < 256; ++symbol)
+    {
+      if (codeSize[size_t(symbol)] == length)
+      {
+        spec.values.push_back(uchar(symbol));
+      }
+    }
+  }
+  return spec;
+}
+
+// 按质量缩放量化表（IJG的缩放公式），返回之字形顺序的量化表
+std::array<uchar, 64> scaleQuantTable(const uchar* base, int quality)
+{
+  quality = qBound(1, quality, 100);
+  const int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+  std::array<uchar, 64> table{};
+  for (int k = 0; k < 64; ++k)
+  {
+    table[size_t(k)] = uchar(qBound(1, (base[ZIGZAG[k]] * scale + 50) / 100, 255));
+  }
+  return table;
+}
+
+// 量化除数（自然顺序）：量化步长乘以AAN DCT的各行列缩放因子
+std::array<float, 64> quantDivisors(const std::array<uchar, 64>& table)
+{
+  static constexpr float AAN_SCALE[8] = {1.0f,
+                                         1.387039845f,
+                                         1.306562965f,
+                                         1.175875602f,
+                                         1.0f,
+                                         0.785694958f,
+                                         0.541196100f,
+                                         0.275899379f};
+  std::array<float, 64> divisors{};
+  for (int k = 0; k < 64; ++k)
+  {
+    const int natural = ZIGZAG[k];
+    divisors[size_t(natural)] =
+        1.0f / (table[size_t(k)] * AAN_SCALE[natural / 8] * AAN_SCALE[natural % 8] * 8.0f);
+  }
+  return divisors;
+}
+
+// 一维AAN浮点DCT（IJG jfdctflt），输出带有各行列的缩放因子，在量化时抵消
+inline void dct8(float* d, int stride)
+{
+  float* p0 = d;
+  float* p1 = d + stride;
+  float* p2 = d + stride * 2;
+  float* p3 = d + stride * 3;
+  float* p4 = d + stride * 4;
+  float* p5 = d + stride * 5;
+  float* p6 = d + stride * 6;
+  float* p7 = d + stride * 7;
+
+  const float tmp0 = *p0 + *p7;
+  const float tmp7 = *p0 - *p7;
+  const float tmp1 = *p1 + *p6;
+  const float tmp6 = *p1 - *p6;
+  const float tmp2 = *p2 + *p5;
+  const float tmp5 = *p2 - *p5;
+  const float tmp3 = *p3 + *p4;
+  const float tmp4 = *p3 - *p4;
+
+  // 偶数部分
+  float tmp10 = tmp0 + tmp3;
+  const float tmp13 = tmp0 - tmp3;
+  float tmp11 = tmp1 + tmp2;
+  float tmp12 = tmp1 - tmp2;
+
+  *p0 = tmp10 + tmp11;
+  *p4 = tmp10 - tmp11;
+  const float z1 = (tmp12 + tmp13) * 0.707106781f;
+  *p2 = tmp13 + z1;
+  *p6 = tmp13 - z1;
+
+  // 奇数部分
+  tmp10 = tmp4 + tmp5;
+  tmp11 = tmp5 + tmp6;
+  tmp12 = tmp6 + tmp7;
+
+  const float z5 = (tmp10 - tmp12) * 0.382683433f;
+  const float z2 = tmp10 * 0.541196100f + z5;
+  const float z4 = tmp12 * 1.306562965f + z5;
+  const float z3 = tmp11 * 0.707106781f;
+  const float z11 = tmp7 + z3;
+  const float z13 = tmp7 - z3;
+
+  *p5 = z13 + z2;
+  *p3 = z13 - z2;
+  *p1 = z11 + z4;
+  *p7 = z11 - z4;
+}
+
+// 对一个8x8块做DCT并量化，结果按之字形顺序输出
+void transformBlock(float* block, const std::array<float, 64>& divisors, short* out)
+{
+  for (int row = 0; row < 8; ++row)
+  {
+    dct8(block + row * 8, 1);
+  }
+  for (int column = 0; column < 8; ++column)
+  {
+    dct8(block + column, 8);
+  }
+  for (int k = 0; k < 64; ++k)
+  {
+    const int natural = ZIGZAG[k];
+    const float value = block[natural] * divisors[size_t(natural)];
+    out[k] = short(value < 0 ? value - 0.5f : value + 0.5f);
+  }
+}
+
+// 数值的位数（霍夫曼编码的类别）
+inline int bitLength(int value)
+{
+  int length = 0;
+  for (value = std::abs(value); value != 0; value >>= 1)
+  {
+    ++length;
+  }
+  return length;
+}
+
+// 熵编码输出：写入字节流，0xFF后补0
+class BitWriter
+{
+public:
+  BitWriter(const std::array<const HuffmanCode*, TABLE_COUNT>& tables, QByteArray& out)
+    : m_tables(tables), m_out(out), m_buffer(0), m_count(0)
+  {
+  }
+
+  void symbol(int table, int value)
+  {
+    const HuffmanCode& code = *m_tables[size_t(table)];
+    bits(code.code[size_t(value)], code.size[size_t(value)]);
+  }
+
+  void bits(quint32 value, int count)
+  {
+    m_buffer = (m_buffer << count) | (value & ((1u << count) - 1));
+    m_count += count;
+    while (m_count >= 8)
+    {
+      const char byte = char(m_buffer >> (m_count - 8));
+      m_out.append(byte);
+      if (byte == char(0xff))
+      {
+        m_out.append(char(0));
+      }
+      m_count -= 8;
+    }
+  }
+
+  // 用1补齐最后一个字节（重启标记和文件结束前必须字节对齐）
+  void flush()
+  {
+    if (m_count > 0)
+    {
+      bits(0x7f, 8 - m_count);
+    }
+  }
+
+private:
+  const std::array<const HuffmanCode*, TABLE_COUNT>& m_tables; // 霍夫曼编码表
+  QByteArray& m_out;                                          // 输出字节流
+  quint32 m_buffer;                                           // 未输出的位
+  int m_count;                                                // 未输出的位数
+};
+
+// 只统计符号频率，用于生成最优霍夫曼表
+class FrequencyCounter
+{
+public:
+  void symbol(int table, int value)
+  {
+    ++frequency[size_t(table)][size_t(value)];
+  }
+
+  void bits(quint32, int)
+  {
+  }
+
+  void flush()
+  {
+  }
+
+  std::array<std::array<qint64, 256>, TABLE_COUNT> frequency{}; // 各表的符号频率
+};
+
+// 熵编码一个量化后的块
+template <typename Sink>
+void encodeBlock(const short* coefficients, int& dcPrediction, int dcTable, int acTable, Sink& sink)
+{
+  const int difference = coefficients[0] - dcPrediction;
+  dcPrediction = coefficients[0];
+  const int dcCategory = bitLength(difference);
+  sink.symbol(dcTable, dcCategory);
+  if (dcCategory > 0)
+  {
+    sink.bits(quint32(difference < 0 ? difference - 1 : difference), dcCategory);
+  }
+
+  int zeroRun = 0;
+  for (int k = 1; k < 64; ++k)
+  {
+    const int value = coefficients[k];
+    if (value == 0)
+    {
+      ++zeroRun;
+      continue;
+    }
+    while (zeroRun > 15)
+    {
+      sink.symbol(acTable, 0xf0); // 16个连续的0
+      zeroRun -= 16;
+    }
+    const int category = bitLength(value);
+    sink.symbol(acTable, (zeroRun << 4) | category);
+    sink.bits(quint32(value < 0 ? value - 1 : value), category);
+    zeroRun = 0;
+  }
+  if (zeroRun > 0)
+  {
+    sink.symbol(acTable, 0x00); // 块结束
+  }
+}
+
+// 编码参数
+struct Context
+{
+  const QImage* image;                 // 源图像（RGB32/ARGB32/ARGB32_Premultiplied）
+  int mcusPerRow;                      // 每行的MCU数量
+  std::array<float, 64> lumaDivisor;   // 亮度量化除数
+  std::array<float, 64> chromaDivisor; // 色度量化除数
+};
+
+// 编码一个条带（若干MCU行），条带开始时直流预测清零
+template <typename Sink>
+void encodeStripe(const Context& context, int firstMcuRow, int lastMcuRow, Sink& sink)
+{
+  const QImage& image = *context.image;
+  const int width = image.width();
+  const int height = image.height();
+
+  float y[4][64];
+  float cb[64];
+  float cr[64];
+  short coefficients[64];
+  int dcY = 0;
+  int dcCb = 0;
+  int dcCr = 0;
+
+  for (int mcuRow = firstMcuRow; mcuRow < lastMcuRow; ++mcuRow)
+  {
+    // 超出图像的部分重复边缘像素
+    const QRgb* rows[MCU_SIZE];
+    for (int i = 0; i < MCU_SIZE; ++i)
+    {
+      rows[i] = reinterpret_cast<const QRgb*>(
+          image.constScanLine(qMin(mcuRow * MCU_SIZE + i, height - 1)));
+    }
+
+    for (int mcuColumn = 0; mcuColumn < context.mcusPerRow; ++mcuColumn)
+    {
+      std::fill(cb, cb + 64, 0.0f);
+      std::fill(cr, cr + 64, 0.0f);
+      for (int py = 0; py < MCU_SIZE; ++py)
+      {
+        const QRgb* row = rows[py];
+        for (int px = 0; px < MCU_SIZE; ++px)
+        {
+          const QRgb pixel = row[qMin(mcuColumn * MCU_SIZE + px, width - 1)];
+          const float r = float(qRed(pixel));
+          const float g = float(qGreen(pixel));
+          const float b = float(qBlue(pixel));
+
+          // JFIF色彩转换，亮度减去128居中；色度按2x2取平均
+          const int block = (py / 8) * 2 + px / 8;
+          y[block][(py % 8) * 8 + px % 8] = 0.299f * r + 0.587f * g + 0.114f * b - 128.0f;
+          const int chroma = (py / 2) * 8 + px / 2;
+          cb[chroma] += (-0.168736f * r - 0.331264f * g + 0.5f * b) * 0.25f;
+          cr[chroma] += (0.5f * r - 0.418688f * g - 0.081312f * b) * 0.25f;
+        }
+      }
+
+      for (int block = 0; block < 4; ++block)
+      {
+        transformBlock(y[block], context.lumaDivisor, coefficients);
+        encodeBlock(coefficients, dcY, DC_LUMA, AC_LUMA, sink);
+      }
+      transformBlock(cb, context.chromaDivisor, coefficients);
+      encodeBlock(coefficients, dcCb, DC_CHROMA, AC_CHROMA, sink);
+      transformBlock(cr, context.chromaDivisor, coefficients);
+      encodeBlock(coefficients, dcCr, DC_CHROMA, AC_CHROMA, sink);
+    }
+  }
+  sink.flush();
+}
+
+// 追加标记段
+void appendMarker(QByteArray& out, uchar marker)
+{
+  out.append(char(0xff));
+  out.append(char(marker));
+}
+
+void appendUInt16(QByteArray& out, int value)
+{
+  out.append(char((value >> 8) & 0xff));
+  out.append(char(value & 0xff));
+}
+
+// 追加DHT段
+void appendHuffmanTable(QByteArray& out, int tableClass, int id, const HuffmanSpec& spec)
+{
+  appendMarker(out, 0xc4);
+  appendUInt16(out, 2 + 1 + 16 + int(spec.values.size()));
+  out.append(char((tableClass << 4) | id));
+  out.append(reinterpret_cast<const char*>(spec.bits.data()), 16);
+  out.append(reinterpret_cast<const char*>(spec.values.data()), qsizetype(spec.values.size()));
+}
+
+// 文件头：SOI、JFIF、量化表、帧信息、霍夫曼表、重启间隔、扫描头
+QByteArray fileHeader(const QImage& image,
+                      const std::array<uchar, 64>& lumaTable,
+                      const std::array<uchar, 64>& chromaTable,
+                      const std::array<HuffmanSpec, TABLE_COUNT>& specs,
+                      int restartInterval)
+{
+  QByteArray out;
+  appendMarker(out, 0xd8);
+
+  // JFIF 1.01，有像素密度时按每英寸点数写入
+  const int dpiX = qRound(image.dotsPerMeterX() * 0.0254);
+  const int dpiY = qRound(image.dotsPerMeterY() * 0.0254);
+  const bool hasDensity = dpiX > 0 && dpiY > 0 && dpiX <= 65535 && dpiY <= 65535;
+  appendMarker(out, 0xe0);
+  appendUInt16(out, 16);
+  out.append("JFIF", 5);
+  out.append(char(1));
+  out.append(char(1));
+  out.append(char(hasDensity ? 1 : 0));
+  appendUInt16(out, hasDensity ? dpiX : 1);
+  appendUInt16(out, hasDensity ? dpiY : 1);
+  out.append(char(0));
+  out.append(char(0));
+
+  appendMarker(out, 0xdb);
+  appendUInt16(out, 2 + 65 * 2);
+  out.append(char(0));
+  out.append(reinterpret_cast<const char*>(lumaTable.data()), 64);
+  out.append(char(1));
+  out.append(reinterpret_cast<const char*>(chromaTable.data()), 64);
+
+  // 基线帧：Y分量2x2采样，Cb/Cr 1x1采样
+  appendMarker(out, 0xc0);
+  appendUInt16(out, 17);
+  out.append(char(8));
+  appendUInt16(out, image.height());
+  appendUInt16(out, image.width());
+  out.append(char(3));
+  const char components[9] = {1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1};
+  out.append(components, 9);
+
+  appendHuffmanTable(out, 0, 0, specs[DC_LUMA]);
+  appendHuffmanTable(out, 1, 0, specs[AC_LUMA]);
+  appendHuffmanTable(out, 0, 1, specs[DC_CHROMA]);
+  appendHuffmanTable(out, 1, 1, specs[AC_CHROMA]);
+
+  if (restartInterval > 0)
+  {
+    appendMarker(out, 0xdd);
+    appendUInt16(out, 4);
+    appendUInt16(out, restartInterval);
+  }
+
+  appendMarker(out, 0xda);
+  appendUInt16(out, 12);
+  out.append(char(3));
+  const char scan[6] = {1, 0x00, 2, 0x11, 3, 0x11};
+  out.append(scan, 6);
+  out.append(char(0));
+  out.append(char(63));
+  out.append(char(0));
+  return out;
+}
+} // namespace
+
+// 编码JPEG并写入设备
+bool JpegEncoder::write(const QImage& sourceImage,
+                        QIODevice* device,
+                        ImageEncoder::Level level,
+                        int quality,
+                        QString* errorMessage,
+                        const ImageEncoder::Progress& progress)
+{
+  auto fail = [errorMessage](const QString& message)
+  {
+    if (errorMessage)
+    {
+      *errorMessage = message;
+    }
+    return false;
+  };
+
+  if (sourceImage.isNull())
+  {
+    return fail("图像为空");
+  }
+  if (sourceImage.width() > MAX_DIMENSION || sourceImage.height() > MAX_DIMENSION)
+  {
+    return fail("图像尺寸超出JPEG的限制");
+  }
+
+  // 截图帧已经是32位格式，其他格式先统一转换
+  QImage image = sourceImage;
+  if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32 &&
+      image.format() != QImage::Format_ARGB32_Premultiplied)
+  {
+    image = image.convertToFormat(QImage::Format_RGB32);
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  quality = quality < 0 ? DEFAULT_QUALITY : quality;
+  const std::array<uchar, 64> lumaTable = scaleQuantTable(LUMA_QUANT, quality);
+  const std::array<uchar, 64> chromaTable = scaleQuantTable(CHROMA_QUANT, quality);
+
+  Context context;
+  context.image = &image;
+  context.mcusPerRow = (image.width() + MCU_SIZE - 1) / MCU_SIZE;
+  context.lumaDivisor = quantDivisors(lumaTable);
+  context.chromaDivisor = quantDivisors(chromaTable);
+
+  // 条带大小：尽量让每个线程分到多个条带，重启间隔（MCU数量）不能超过65535
+  const int mcuRows = (image.height() + MCU_SIZE - 1) / MCU_SIZE;
+  const int threads = ImageEncoder::threadCount();
+  const int rowsPerStripe =
+      qBound(1, (mcuRows + threads * 4 - 1) / (threads * 4), 65535 / context.mcusPerRow);
+  const int stripeCount = (mcuRows + rowsPerStripe - 1) / rowsPerStripe;
+  auto stripeRows = [&](int index)
+  {
+    return std::make_pair(index * rowsPerStripe, qMin(mcuRows, (index + 1) * rowsPerStripe));
+  };
+
+  // 按完成的条带数报告0~90（Small的两遍各占一半），写入完成后报告100
+  const int passes = level == ImageEncoder::Level::Small ? 2 : 1;
+  std::atomic<int> finishedStripes(0);
+  auto stripeFinished = [&]()
+  {
+    if (progress)
+    {
+      progress(++finishedStripes * 90 / (stripeCount * passes));
+    }
+  };
+
+  std::array<HuffmanSpec, TABLE_COUNT> specs = {makeSpec(DC_LUMA_BITS, DC_VALUES),
+                                               makeSpec(AC_LUMA_BITS, AC_LUMA_VALUES),
+                                               makeSpec(DC_CHROMA_BITS, DC_VALUES),
+                                               makeSpec(AC_CHROMA_BITS, AC_CHROMA_VALUES)};
+
+  // Small：第一遍并行统计符号频率，合并后生成最优霍夫曼表
+  if (level == ImageEncoder::Level::Small)
+  {
+    std::vector<FrequencyCounter> counters(static_cast<size_t>(stripeCount));
+    ImageEncoder::parallelFor(stripeCount,
+                              [&](int index)
+                              {
+                                TraceRecorder::Scope traceScope("encode", "jpeg_statistics");
+                                const auto rows = stripeRows(index);
+                                encodeStripe(context, rows.first, rows.second,
+                                             counters[size_t(index)]);
+                                stripeFinished();
+                              });
+    for (int table = 0; table < TABLE_COUNT; ++table)
+    {
+      std::array<qint64, 256> frequency{};
+      for (const FrequencyCounter& counter : counters)
+      {
+        for (int symbol = 0; symbol < 256; ++symbol)
+        {
+          frequency[size_t(symbol)] += counter.frequency[size_t(table)][size_t(symbol)];
+        }
+      }
+      specs[size_t(table)] = optimalSpec(frequency);
+    }
+  }
+
+  const HuffmanCode dcLuma(specs[DC_LUMA]);
+  const HuffmanCode acLuma(specs[AC_LUMA]);
+  const HuffmanCode dcChroma(specs[DC_CHROMA]);
+  const HuffmanCode acChroma(specs[AC_CHROMA]);
+  const std::array<const HuffmanCode*, TABLE_COUNT> codes = {&dcLuma, &acLuma, &dcChroma,
+                                                             &acChroma};
+
+  // 每个条带是一个重启间隔，在线程中独立编码
+  std::vector<QByteArray> stripes(static_cast<size_t>(stripeCount));
+  ImageEncoder::parallelFor(stripeCount,
+                            [&](int index)
+                            {
+                              TraceRecorder::Scope traceScope("encode", "jpeg_stripe");
+                              const auto rows = stripeRows(index);
+                              BitWriter writer(codes, stripes[size_t(index)]);
+                              encodeStripe(context, rows.first, rows.second, writer);
+                              stripeFinished();
+                            });
+
+  // 按顺序写入，条带之间插入RST0~RST7标记
+  const int restartInterval = stripeCount > 1 ? rowsPerStripe * context.mcusPerRow : 0;
+  const QByteArray header = fileHeader(image, lumaTable, chromaTable, specs, restartInterval);
+  if (device->write(header) != header.size())
+  {
+    return fail(device->errorString());
+  }
+  for (int i = 0; i < stripeCount; ++i)
+  {
+    QByteArray& data = stripes[size_t(i)];
+    if (i < stripeCount - 1)
+    {
+      appendMarker(data, uchar(0xd0 + i % 8));
+    }
+    else
+    {
+      appendMarker(data, 0xd9);
+    }
+    if (device->write(data) != data.size())
+    {
+      return fail(device->errorString());
+    }
+  }
+
+  if (progress)
+  {
+    progress(100);
+  }
+
+  qDebug() << "JPEG编码完成，尺寸:" << image.size() << "质量:" << quality
+           << "等级:" << ImageEncoder::levelName(level) << "条带:" << stripeCount
+           << "线程:" << threads << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms";
+  return true;
+}
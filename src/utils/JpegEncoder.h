@@ -0,0 +1,40 @@
+#ifndef JPEGENCODER_H
+#define JPEGENCODER_H
+
+#include <QIODevice>
+#include <QImage>
+#include <QString>
+
+#include "ImageEncoder.h"
+
+/**
+ * 并行JPEG编码器（基线DCT，YCbCr 4:2:0）
+ * 图像按MCU行切分成条带，每个条带作为一个重启间隔在线程中独立编码（直流预测在条带开始时清零），
+ * 条带之间插入RSTn标记后拼接成一个标准的JPEG文件
+ * Small等级先并行统计各条带的符号频率，生成最优霍夫曼表后再编码，其他等级使用标准霍夫曼表
+ */
+class JpegEncoder
+{
+public:
+  // 私有构造函数（静态类）
+  JpegEncoder() = delete;
+
+  /**
+   * 编码JPEG并写入设备（忽略alpha通道）
+   * @param image 要编码的图像（宽高不能超过65535）
+   * @param device 已打开的目标设备
+   * @param level 速度/体积等级
+   * @param quality 编码质量（1~100，-1表示默认值75）
+   * @param errorMessage 失败时写入错误信息，可以为空
+   * @param progress 进度回调（每个条带编码完成时报告），可以为空
+   * @return 是否成功
+   */
+  static bool write(const QImage& image,
+                    QIODevice* device,
+                    ImageEncoder::Level level,
+                    int quality,
+                    QString* errorMessage,
+                    const ImageEncoder::Progress& progress = ImageEncoder::Progress());
+};
+
+#endif // JPEGENCODER_H
@@ -0,0 +1,163 @@
+#include "MetricSeries.h"
+
+#include <QJsonArray>
+#include <QtMath>
+
+// 构造函数
+MetricSeries::MetricSeries()
+{
+  reset();
+}
+
+// 记录一个样本
+void MetricSeries::record(qint64 nanoseconds)
+{
+  nanoseconds = qMax<qint64>(0, nanoseconds);
+
+  // 每个写入者独占一个位置，不需要加锁；环形缓冲区写满后覆盖最旧的样本
+  const quint64 index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+  m_samples[index % CAPACITY].store(nanoseconds, std::memory_order_relaxed);
+
+  m_buckets[bucketIndex(nanoseconds / 1000)].fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+  qint64 currentMax = m_max.load(std::memory_order_relaxed);
+  while (nanoseconds > currentMax &&
+         !m_max.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed))
+  {
+  }
+}
+
+// 样本总数
+quint64 MetricSeries::count() const
+{
+  return m_writeIndex.load(std::memory_order_relaxed);
+}
+
+// 最大值
+qint64 MetricSeries::maxValue() const
+{
+  return m_max.load(std::memory_order_relaxed);
+}
+
+// 平均值
+qint64 MetricSeries::mean() const
+{
+  const quint64 total = count();
+  return total == 0 ? 0 : m_sum.load(std::memory_order_relaxed) / qint64(total);
+}
+
+// 根据直方图计算百分位数
+qint64 MetricSeries::percentile(qreal p) const
+{
+  std::array<quint64, BUCKET_COUNT> buckets;
+  quint64 total = 0;
+  for (int i = 0; i < BUCKET_COUNT; ++i)
+  {
+    buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += buckets[i];
+  }
+
+  if (total == 0)
+  {
+    return 0;
+  }
+
+  // 第rank个样本所在分桶的上界，且不超过实际最大值
+  const quint64 rank = qMax<quint64>(1, quint64(qCeil(qBound(0.0, p, 1.0) * total)));
+  quint64 seen = 0;
+  for (int i = 0; i < BUCKET_COUNT; ++i)
+  {
+    seen += buckets[i];
+    if (seen >= rank)
+    {
+      return qMin(bucketUpperBound(i) * 1000, maxValue());
+    }
+  }
+  return maxValue();
+}
+
+// 最近的样本
+std::vector<qint64> MetricSeries::recent() const
+{
+  const quint64 end = count();
+  const quint64 begin = end > CAPACITY ? end - CAPACITY : 0;
+
+  std::vector<qint64> samples;
+  samples.reserve(size_t(end - begin));
+  for (quint64 i = begin; i < end; ++i)
+  {
+    samples.push_back(m_samples[i % CAPACITY].load(std::memory_order_relaxed));
+  }
+  return samples;
+}
+
+// 导出为JSON
+QJsonObject MetricSeries::toJson() const
+{
+  auto toMicroseconds = [](qint64 nanoseconds) { return double(nanoseconds) / 1000.0; };
+
+  QJsonArray samples;
+  for (qint64 value : recent())
+  {
+    samples.append(toMicroseconds(value));
+  }
+
+  QJsonObject json;
+  json["count"] = double(count());
+  json["mean_us"] = toMicroseconds(mean());
+  json["max_us"] = toMicroseconds(maxValue());
+  json["p50_us"] = toMicroseconds(percentile(0.50));
+  json["p90_us"] = toMicroseconds(percentile(0.90));
+  json["p95_us"] = toMicroseconds(percentile(0.95));
+  json["p99_us"] = toMicroseconds(percentile(0.99));
+  json["recent_us"] = samples;
+  return json;
+}
+
+// 清空所有样本
+void MetricSeries::reset()
+{
+  m_writeIndex.store(0, std::memory_order_relaxed);
+  for (auto& sample : m_samples)
+  {
+    sample.store(0, std::memory_order_relaxed);
+  }
+  for (auto& bucket : m_buckets)
+  {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_sum.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+// 计算样本所在的分桶
+int MetricSeries::bucketIndex(qint64 microseconds)
+{
+  if (microseconds < SUB_BUCKETS)
+  {
+    return int(microseconds);
+  }
+
+  // 最高位所在的2的幂区间，再用其后两位细分
+  int octave = 0;
+  for (qint64 value = microseconds; value > 1; value >>= 1)
+  {
+    ++octave;
+  }
+  const int sub = int(microseconds >> (octave - 2)) & (SUB_BUCKETS - 1);
+  return qMin(BUCKET_COUNT - 1, SUB_BUCKETS + (octave - 2) * SUB_BUCKETS + sub);
+}
+
+// 分桶上界
+qint64 MetricSeries::bucketUpperBound(int index)
+{
+  if (index < SUB_BUCKETS)
+  {
+    return index + 1;
+  }
+
+  const int octave = (index - SUB_BUCKETS) / SUB_BUCKETS + 2;
+  const int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+  return (qint64(1) << octave) + qint64(sub + 1) * (qint64(1) << (octave - 2));
+}
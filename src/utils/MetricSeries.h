@@ -0,0 +1,52 @@
+#ifndef METRICSERIES_H
+#define METRICSERIES_H
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * 耗时指标序列
+ * 最近样本保存在固定容量的环形缓冲区中，全部样本同时计入对数分桶直方图用于计算百分位数
+ * 记录和读取都不加锁，任意线程都可以并发调用record；读取得到的是近似一致的快照
+ */
+class MetricSeries
+{
+public:
+  static constexpr int CAPACITY = 512; // 环形缓冲区保存的最近样本数
+
+  MetricSeries();
+
+  // 记录一个样本（纳秒），无锁，可在任意线程调用
+  void record(qint64 nanoseconds);
+
+  // 统计信息
+  quint64 count() const;            // 样本总数
+  qint64 maxValue() const;          // 最大值（纳秒）
+  qint64 mean() const;              // 平均值（纳秒）
+  qint64 percentile(qreal p) const; // 百分位数（纳秒，p取0~1），误差不超过所在分桶宽度的25%
+  std::vector<qint64> recent() const; // 最近的样本（按时间顺序）
+
+  // 导出为JSON：样本数、平均值、最大值、p50/p90/p95/p99和最近样本（单位：微秒）
+  QJsonObject toJson() const;
+
+  // 清空所有样本（不能与record并发调用）
+  void reset();
+
+private:
+  // 直方图分桶：4微秒以下每微秒一个桶，之后每个2的幂区间再平分为4个桶
+  static constexpr int SUB_BUCKETS = 4;
+  static constexpr int BUCKET_COUNT = SUB_BUCKETS + 22 * SUB_BUCKETS; // 最大约16秒
+  static int bucketIndex(qint64 microseconds);
+  static qint64 bucketUpperBound(int index); // 分桶上界（微秒，不含）
+
+  std::atomic<quint64> m_writeIndex;                       // 下一个写入位置
+  std::array<std::atomic<qint64>, CAPACITY> m_samples;     // 最近样本
+  std::array<std::atomic<quint64>, BUCKET_COUNT> m_buckets; // 直方图
+  std::atomic<qint64> m_sum;                               // 样本总和
+  std::atomic<qint64> m_max;                               // 最大值
+};
+
+#endif // METRICSERIES_H
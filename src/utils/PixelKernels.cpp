@@ -0,0 +1,269 @@
+#include "PixelKernels.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define PIXELKERNELS_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define PIXELKERNELS_NEON
+#endif
+
+namespace
+{
+// 遮罩参数：叠加 alpha=127 的黑色后，颜色分量乘以 (255-127)/255，alpha 分量再加上 127
+constexpr uint DIM_ALPHA = 127;
+constexpr uint DIM_SCALE = 255 - DIM_ALPHA;
+
+// 标量实现：x * DIM_SCALE / 255，四舍五入
+inline uint dimChannel(uint x)
+{
+  uint t = x * DIM_SCALE + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+inline QRgb dimPixel(QRgb p)
+{
+  uint a = dimChannel(qAlpha(p)) + DIM_ALPHA;
+  uint r = dimChannel(qRed(p));
+  uint g = dimChannel(qGreen(p));
+  uint b = dimChannel(qBlue(p));
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// 标量实现：2x2像素逐分量取平均
+inline QRgb averagePixel(QRgb p00, QRgb p01, QRgb p10, QRgb p11)
+{
+  uint a = (qAlpha(p00) + qAlpha(p01) + qAlpha(p10) + qAlpha(p11) + 2) >> 2;
+  uint r = (qRed(p00) + qRed(p01) + qRed(p10) + qRed(p11) + 2) >> 2;
+  uint g = (qGreen(p00) + qGreen(p01) + qGreen(p10) + qGreen(p11) + 2) >> 2;
+  uint b = (qBlue(p00) + qBlue(p01) + qBlue(p10) + qBlue(p11) + 2) >> 2;
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+} // namespace
+
+// 将一行像素与半透明黑色遮罩合成
+void PixelKernels::dimRow(const QRgb* src, QRgb* dst, int count)
+{
+  int i = 0;
+
+#if defined(PIXELKERNELS_SSE2)
+  // 每次处理4个像素（16字节）：扩展到16位后计算 x*scale/255，再打包回8位
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i scale = _mm_set1_epi16(short(DIM_SCALE));
+  const __m128i half = _mm_set1_epi16(128);
+  const __m128i alphaBias = _mm_set1_epi32(int(DIM_ALPHA << 24));
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+    __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+    __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+    lo = _mm_add_epi16(_mm_mullo_epi16(lo, scale), half);
+    hi = _mm_add_epi16(_mm_mullo_epi16(hi, scale), half);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    __m128i result = _mm_add_epi32(_mm_packus_epi16(lo, hi), alphaBias);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+  }
+#elif defined(PIXELKERNELS_NEON)
+  // 每次处理4个像素（16字节）：vmull扩展乘法后用舍入窄化完成除以255
+  const uint8x8_t scale = vdup_n_u8(uint8_t(DIM_SCALE));
+  const uint32x4_t alphaBias = vdupq_n_u32(DIM_ALPHA << 24);
+  for (; i + 4 <= count; i += 4)
+  {
+    uint8x16_t pixels = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+
+    uint16x8_t lo = vmull_u8(vget_low_u8(pixels), scale);
+    uint16x8_t hi = vmull_u8(vget_high_u8(pixels), scale);
+    uint8x8_t dimLo = vraddhn_u16(lo, vrshrq_n_u16(lo, 8));
+    uint8x8_t dimHi = vraddhn_u16(hi, vrshrq_n_u16(hi, 8));
+
+    uint32x4_t result = vreinterpretq_u32_u8(vcombine_u8(dimLo, dimHi));
+    result = vaddq_u32(result, alphaBias);
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), result);
+  }
+#endif
+
+  // 剩余像素使用标量实现
+  for (; i < count; ++i)
+  {
+    dst[i] = dimPixel(src[i]);
+  }
+}
+
+// 最近邻放大一行像素
+void PixelKernels::zoomRow(const QRgb* src, QRgb* dst, int dstCount, int zoom, int phase)
+{
+  if (dstCount <= 0)
+  {
+    return;
+  }
+
+  if (zoom <= 1)
+  {
+    std::memcpy(dst, src, size_t(dstCount) * sizeof(QRgb));
+    return;
+  }
+
+  // 第一个源像素只剩 zoom - phase 个目标像素
+  int out = qMin(zoom - phase, dstCount);
+  fillRow(dst, *src++, out);
+
+#if defined(PIXELKERNELS_SSE2)
+  if (zoom == 2)
+  {
+    // 2倍：每4个源像素交错展开为8个目标像素
+    for (; out + 8 <= dstCount; out += 8, src += 4)
+    {
+      __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + out), _mm_unpacklo_epi32(pixels, pixels));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + out + 4),
+                       _mm_unpackhi_epi32(pixels, pixels));
+    }
+  }
+  else
+  {
+    // 3倍及以上：把源像素广播到向量后按4像素写入，超出当前格子的部分由下一个像素覆盖
+    const int span = (zoom + 3) & ~3;
+    for (; out + span <= dstCount; out += zoom, ++src)
+    {
+      const __m128i pixel = _mm_set1_epi32(int(*src));
+      for (int i = 0; i < span; i += 4)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + out + i), pixel);
+      }
+    }
+  }
+#elif defined(PIXELKERNELS_NEON)
+  if (zoom == 2)
+  {
+    // 2倍：每4个源像素交错展开为8个目标像素
+    for (; out + 8 <= dstCount; out += 8, src += 4)
+    {
+      uint32x4_t pixels = vld1q_u32(reinterpret_cast<const uint32_t*>(src));
+      uint32x4x2_t zipped = vzipq_u32(pixels, pixels);
+      vst1q_u32(reinterpret_cast<uint32_t*>(dst + out), zipped.val[0]);
+      vst1q_u32(reinterpret_cast<uint32_t*>(dst + out + 4), zipped.val[1]);
+    }
+  }
+  else
+  {
+    // 3倍及以上：把源像素广播到向量后按4像素写入，超出当前格子的部分由下一个像素覆盖
+    const int span = (zoom + 3) & ~3;
+    for (; out + span <= dstCount; out += zoom, ++src)
+    {
+      const uint32x4_t pixel = vdupq_n_u32(*src);
+      for (int i = 0; i < span; i += 4)
+      {
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + out + i), pixel);
+      }
+    }
+  }
+#endif
+
+  // 剩余像素使用标量实现
+  while (out < dstCount)
+  {
+    int run = qMin(zoom, dstCount - out);
+    fillRow(dst + out, *src++, run);
+    out += run;
+  }
+}
+
+// 用指定颜色填充一行像素
+void PixelKernels::fillRow(QRgb* dst, QRgb color, int count)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    dst[i] = color;
+  }
+}
+
+// 把一行像素的alpha分量设置为255
+void PixelKernels::opaqueRow(QRgb* row, qsizetype count)
+{
+  qsizetype i = 0;
+
+#if defined(PIXELKERNELS_SSE2)
+  // 每次处理16个像素
+  const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+  for (; i + 16 <= count; i += 16)
+  {
+    for (int k = 0; k < 16; k += 4)
+    {
+      __m128i* p = reinterpret_cast<__m128i*>(row + i + k);
+      _mm_storeu_si128(p, _mm_or_si128(_mm_loadu_si128(p), alpha));
+    }
+  }
+#elif defined(PIXELKERNELS_NEON)
+  // 每次处理16个像素
+  const uint32x4_t alpha = vdupq_n_u32(0xFF000000);
+  for (; i + 16 <= count; i += 16)
+  {
+    for (int k = 0; k < 16; k += 4)
+    {
+      uint32_t* p = reinterpret_cast<uint32_t*>(row + i + k);
+      vst1q_u32(p, vorrq_u32(vld1q_u32(p), alpha));
+    }
+  }
+#endif
+
+  // 剩余像素使用标量实现
+  for (; i < count; ++i)
+  {
+    row[i] |= 0xFF000000;
+  }
+}
+
+// 2x2盒式缩小一行像素
+void PixelKernels::downsampleRow(const QRgb* row0, const QRgb* row1, QRgb* dst, int dstCount)
+{
+  int i = 0;
+
+#if defined(PIXELKERNELS_SSE2)
+  // 每次输出4个像素：两行各读取8个像素，扩展到16位后先纵向相加，再把相邻两个像素相加
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i half = _mm_set1_epi16(2);
+  for (; i + 4 <= dstCount; i += 4)
+  {
+    __m128i packed[2];
+    for (int k = 0; k < 2; ++k)
+    {
+      __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i * 2 + k * 4));
+      __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i * 2 + k * 4));
+      __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+      __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+      lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+      hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+      packed[k] = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), half), 2);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(packed[0], packed[1]));
+  }
+#elif defined(PIXELKERNELS_NEON)
+  // 每次输出4个像素：按像素解交错后纵向、横向相加，再用舍入右移完成除以4
+  for (; i + 4 <= dstCount; i += 4)
+  {
+    uint32x4x2_t top = vld2q_u32(reinterpret_cast<const uint32_t*>(row0 + i * 2));
+    uint32x4x2_t bottom = vld2q_u32(reinterpret_cast<const uint32_t*>(row1 + i * 2));
+    uint16x8_t lo = vaddl_u8(vget_low_u8(vreinterpretq_u8_u32(top.val[0])),
+                             vget_low_u8(vreinterpretq_u8_u32(top.val[1])));
+    uint16x8_t hi = vaddl_u8(vget_high_u8(vreinterpretq_u8_u32(top.val[0])),
+                             vget_high_u8(vreinterpretq_u8_u32(top.val[1])));
+    lo = vaddw_u8(lo, vget_low_u8(vreinterpretq_u8_u32(bottom.val[0])));
+    lo = vaddw_u8(lo, vget_low_u8(vreinterpretq_u8_u32(bottom.val[1])));
+    hi = vaddw_u8(hi, vget_high_u8(vreinterpretq_u8_u32(bottom.val[0])));
+    hi = vaddw_u8(hi, vget_high_u8(vreinterpretq_u8_u32(bottom.val[1])));
+    uint8x16_t result = vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2));
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), vreinterpretq_u32_u8(result));
+  }
+#endif
+
+  // 剩余像素使用标量实现
+  for (; i < dstCount; ++i)
+  {
+    dst[i] = averagePixel(row0[i * 2], row0[i * 2 + 1], row1[i * 2], row1[i * 2 + 1]);
+  }
+}
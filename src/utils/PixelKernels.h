@@ -0,0 +1,58 @@
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include <QtGlobal>
+#include <QRgb>
+
+/**
+ * 像素处理内核
+ * 针对预乘ARGB32扫描线的批量处理函数，按平台选择SSE2/NEON实现，其余平台使用标量实现
+ */
+class PixelKernels
+{
+public:
+  // 私有构造函数（静态类）
+  PixelKernels() = delete;
+
+  /**
+   * 将一行像素与半透明黑色遮罩合成
+   * 结果等价于在原像素上以SourceOver方式叠加 QColor(0, 0, 0, 127)
+   * @param src 源像素行（预乘ARGB32）
+   * @param dst 目标像素行，可以与src相同
+   * @param count 像素数量
+   */
+  static void dimRow(const QRgb* src, QRgb* dst, int count);
+
+  /**
+   * 最近邻放大一行像素：每个源像素在目标行中重复zoom次
+   * @param src 源像素行，从第一个可见的源像素开始
+   * @param dst 目标像素行
+   * @param dstCount 需要写入的目标像素数量
+   * @param zoom 放大倍数（>= 1）
+   * @param phase 第一个源像素在目标行左侧被裁掉的像素数（0 <= phase < zoom）
+   */
+  static void zoomRow(const QRgb* src, QRgb* dst, int dstCount, int zoom, int phase);
+
+  // 用指定颜色填充一行像素
+  static void fillRow(QRgb* dst, QRgb color, int count);
+
+  /**
+   * 把一行像素的alpha分量设置为255（原地处理）
+   * 用于X11等平台返回的RGB32数据（最高字节未定义），处理后即为合法的预乘ARGB32
+   * @param row 像素行
+   * @param count 像素数量
+   */
+  static void opaqueRow(QRgb* row, qsizetype count);
+
+  /**
+   * 2x2盒式缩小：相邻两行中每2x2个像素取平均（四舍五入）得到一个目标像素
+   * 预乘格式下逐分量平均即为正确的结果
+   * @param row0 上一行源像素
+   * @param row1 下一行源像素
+   * @param dst 目标像素行
+   * @param dstCount 目标像素数量（源行至少包含 dstCount * 2 个像素）
+   */
+  static void downsampleRow(const QRgb* row0, const QRgb* row1, QRgb* dst, int dstCount);
+};
+
+#endif // PIXELKERNELS_H
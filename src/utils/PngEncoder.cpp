@@ -0,0 +1,509 @@
+#include "PngEncoder.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef OPENCAP_HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+#include "TraceRecorder.h"
+
+#ifdef OPENCAP_HAVE_ZLIB
+namespace
+{
+constexpr int WINDOW_SIZE = 32768;                  // deflate窗口大小（预设字典的最大长度）
+constexpr qsizetype MIN_STRIPE_BYTES = 64 * 1024;   // 条带的最小原始数据量
+constexpr qsizetype MAX_STRIPE_BYTES = 1024 * 1024; // 条带的最大原始数据量
+constexpr uchar PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// 行过滤器类型
+enum Filter
+{
+  FILTER_NONE = 0,
+  FILTER_SUB = 1,
+  FILTER_UP = 2,
+  FILTER_AVERAGE = 3,
+  FILTER_PAETH = 4
+};
+
+// 各等级的编码参数
+struct Settings
+{
+  int compressionLevel; // zlib压缩等级
+  bool adaptiveFilter;  // 是否逐行选择过滤器（否则固定使用Sub）
+};
+
+Settings settingsFor(ImageEncoder::Level level)
+{
+  switch (level)
+  {
+    case ImageEncoder::Level::Fast:
+      return {1, false};
+    case ImageEncoder::Level::Balanced:
+      return {6, true};
+    case ImageEncoder::Level::Small:
+      return {9, true};
+  }
+  return {6, true};
+}
+
+// 与压缩等级对应的zlib头（FLEVEL和校验位）
+QByteArray zlibHeader(int compressionLevel)
+{
+  uchar flags = 0x9c;
+  if (compressionLevel <= 1)
+  {
+    flags = 0x01;
+  }
+  else if (compressionLevel <= 5)
+  {
+    flags = 0x5e;
+  }
+  else if (compressionLevel >= 7)
+  {
+    flags = 0xda;
+  }
+  return QByteArray("\x78", 1) + char(flags);
+}
+
+// 大端序32位整数
+void appendUInt32(QByteArray& data, quint32 value)
+{
+  data.append(char(value >> 24));
+  data.append(char(value >> 16));
+  data.append(char(value >> 8));
+  data.append(char(value));
+}
+
+// 把一行像素转换成PNG的RGB/RGBA字节
+void convertRow(const QImage& image, int y, bool alpha, uchar* out)
+{
+  const QRgb* src = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+  const bool premultiplied = image.format() == QImage::Format_ARGB32_Premultiplied;
+  const int width = image.width();
+  if (alpha)
+  {
+    for (int x = 0; x < width; ++x, out += 4)
+    {
+      const QRgb pixel = premultiplied ? qUnpremultiply(src[x]) : src[x];
+      out[0] = uchar(qRed(pixel));
+      out[1] = uchar(qGreen(pixel));
+      out[2] = uchar(qBlue(pixel));
+      out[3] = uchar(qAlpha(pixel));
+    }
+  }
+  else
+  {
+    for (int x = 0; x < width; ++x, out += 3)
+    {
+      out[0] = uchar(qRed(src[x]));
+      out[1] = uchar(qGreen(src[x]));
+      out[2] = uchar(qBlue(src[x]));
+    }
+  }
+}
+
+// Paeth预测
+inline int paethPredictor(int a, int b, int c)
+{
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+  {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+// 用指定的过滤器过滤一行，返回过滤结果的绝对值之和（用于选择过滤器）
+template <int FILTER>
+quint64 filterRow(const uchar* row, const uchar* prev, int length, int bpp, uchar* out)
+{
+  quint64 cost = 0;
+  for (int i = 0; i < length; ++i)
+  {
+    const int a = i >= bpp ? row[i - bpp] : 0;
+    const int b = prev[i];
+    int predicted = 0;
+    if (FILTER == FILTER_SUB)
+    {
+      predicted = a;
+    }
+    else if (FILTER == FILTER_UP)
+    {
+      predicted = b;
+    }
+    else if (FILTER == FILTER_AVERAGE)
+    {
+      predicted = (a + b) / 2;
+    }
+    else if (FILTER == FILTER_PAETH)
+    {
+      predicted = paethPredictor(a, b, i >= bpp ? prev[i - bpp] : 0);
+    }
+    const uchar value = uchar(row[i] - predicted);
+    out[i] = value;
+    cost += value < 128 ? value : 256 - value; // 按有符号字节计算
+  }
+  return cost;
+}
+
+// 编码一行：写入过滤器类型字节和过滤后的数据（共length+1字节）
+void encodeRow(const uchar* row,
+               const uchar* prev,
+               int length,
+               int bpp,
+               bool adaptive,
+               std::vector<uchar>& scratch,
+               uchar* out)
+{
+  if (!adaptive)
+  {
+    out[0] = FILTER_SUB;
+    filterRow<FILTER_SUB>(row, prev, length, bpp, out + 1);
+    return;
+  }
+
+  // 逐个尝试五种过滤器，保留绝对值之和最小的结果（libpng的启发式规则）
+  using FilterFunction = quint64 (*)(const uchar*, const uchar*, int, int, uchar*);
+  static constexpr FilterFunction FILTERS[] = {filterRow<FILTER_SUB>,
+                                               filterRow<FILTER_UP>,
+                                               filterRow<FILTER_AVERAGE>,
+                                               filterRow<FILTER_PAETH>};
+  out[0] = FILTER_NONE;
+  quint64 bestCost = filterRow<FILTER_NONE>(row, prev, length, bpp, out + 1);
+  for (int filter = FILTER_SUB; filter <= FILTER_PAETH; ++filter)
+  {
+    const quint64 cost = FILTERS[filter - 1](row, prev, length, bpp, scratch.data());
+    if (cost < bestCost)
+    {
+      bestCost = cost;
+      out[0] = uchar(filter);
+      std::memcpy(out + 1, scratch.data(), size_t(length));
+    }
+  }
+}
+
+// 编码好的条带
+struct Stripe
+{
+  QByteArray data;       // 压缩数据（原始deflate块）
+  quint32 adler = 1;     // 过滤后原始数据的Adler-32
+  qsizetype rawSize = 0; // 过滤后原始数据的长度
+  quint32 crc = 0;       // 压缩数据的CRC-32（不含块类型）
+  bool ok = false;       // 是否成功
+};
+
+// 压缩一个条带：先过滤前一个条带末尾的几行作为预设字典，再过滤并压缩本条带
+void compressStripe(const QImage& image,
+                    int firstRow,
+                    int lastRow,
+                    bool alpha,
+                    bool finalStripe,
+                    const Settings& settings,
+                    Stripe& stripe)
+{
+  TraceRecorder::Scope traceScope("encode", "png_stripe");
+
+  const int bpp = alpha ? 4 : 3;
+  const int rowBytes = image.width() * bpp;
+  const int filteredBytes = rowBytes + 1;
+  const int dictionaryRows = qMin(firstRow, (WINDOW_SIZE + filteredBytes - 1) / filteredBytes);
+  const int startRow = firstRow - dictionaryRows;
+
+  std::vector<uchar> previous(size_t(rowBytes), 0);
+  std::vector<uchar> current(static_cast<size_t>(rowBytes));
+  std::vector<uchar> scratch(static_cast<size_t>(rowBytes));
+  std::vector<uchar> filtered(size_t(lastRow - startRow) * size_t(filteredBytes));
+  if (startRow > 0)
+  {
+    convertRow(image, startRow - 1, alpha, previous.data());
+  }
+  for (int y = startRow; y < lastRow; ++y)
+  {
+    convertRow(image, y, alpha, current.data());
+    encodeRow(current.data(),
+              previous.data(),
+              rowBytes,
+              bpp,
+              settings.adaptiveFilter,
+              scratch,
+              filtered.data() + size_t(y - startRow) * size_t(filteredBytes));
+    current.swap(previous);
+  }
+
+  const uchar* dictionary = filtered.data();
+  const qsizetype dictionarySize = qsizetype(dictionaryRows) * filteredBytes;
+  const uchar* raw = dictionary + dictionarySize;
+  stripe.rawSize = qsizetype(filtered.size()) - dictionarySize;
+  stripe.adler = quint32(adler32(1, raw, uInt(stripe.rawSize)));
+
+  // 原始deflate（无zlib头和校验和），由写入时统一添加
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream,
+                   settings.compressionLevel,
+                   Z_DEFLATED,
+                   -15,
+                   8,
+                   settings.adaptiveFilter ? Z_FILTERED : Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return;
+  }
+  if (dictionarySize > 0)
+  {
+    const qsizetype size = qMin<qsizetype>(dictionarySize, WINDOW_SIZE);
+    deflateSetDictionary(&stream, raw - size, uInt(size));
+  }
+
+  // 同步刷新以字节对齐的空存储块结束，下一个条带的数据可以直接拼接在后面
+  stripe.data.resize(qsizetype(deflateBound(&stream, uLong(stripe.rawSize))) + 64);
+  stream.next_in = const_cast<Bytef*>(raw);
+  stream.avail_in = uInt(stripe.rawSize);
+  stream.next_out = reinterpret_cast<Bytef*>(stripe.data.data());
+  stream.avail_out = uInt(stripe.data.size());
+  const int result = deflate(&stream, finalStripe ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool complete =
+      finalStripe ? result == Z_STREAM_END
+                  : result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+  stripe.data.resize(qsizetype(stream.total_out));
+  deflateEnd(&stream);
+
+  if (!complete)
+  {
+    return;
+  }
+  stripe.crc = quint32(crc32(0, reinterpret_cast<const Bytef*>(stripe.data.constData()),
+                             uInt(stripe.data.size())));
+  stripe.ok = true;
+}
+
+// 写入一个数据块
+bool writeChunk(QIODevice* device, const char* type, const QByteArray& data)
+{
+  QByteArray chunk;
+  chunk.reserve(data.size() + 12);
+  appendUInt32(chunk, quint32(data.size()));
+  chunk.append(type, 4);
+  chunk.append(data);
+  appendUInt32(chunk,
+               quint32(crc32(0, reinterpret_cast<const Bytef*>(chunk.constData() + 4),
+                             uInt(data.size() + 4))));
+  return device->write(chunk) == chunk.size();
+}
+
+// 写入一个条带对应的IDAT块：首个条带前加zlib头，最后一个条带后加Adler-32，
+// 条带数据的CRC已在工作线程中算好，这里只需要与前后缀的CRC组合
+bool writeStripeChunk(QIODevice* device,
+                      const QByteArray& prefix,
+                      const Stripe& stripe,
+                      const QByteArray& suffix)
+{
+  QByteArray header;
+  appendUInt32(header, quint32(prefix.size() + stripe.data.size() + suffix.size()));
+  header.append("IDAT", 4);
+  header.append(prefix);
+
+  uLong crc = crc32(0, reinterpret_cast<const Bytef*>(header.constData() + 4),
+                    uInt(header.size() - 4));
+  crc = crc32_combine(crc, stripe.crc, z_off_t(stripe.data.size()));
+  crc = crc32(crc, reinterpret_cast<const Bytef*>(suffix.constData()), uInt(suffix.size()));
+
+  QByteArray trailer = suffix;
+  appendUInt32(trailer, quint32(crc));
+  return device->write(header) == header.size() &&
+         device->write(stripe.data) == stripe.data.size() &&
+         device->write(trailer) == trailer.size();
+}
+} // namespace
+#endif // OPENCAP_HAVE_ZLIB
+
+// 编译时是否启用了zlib
+bool PngEncoder::isAvailable()
+{
+#ifdef OPENCAP_HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+// 编码PNG并写入设备
+bool PngEncoder::write(const QImage& sourceImage,
+                       QIODevice* device,
+                       ImageEncoder::Level level,
+                       QString* errorMessage,
+                       const ImageEncoder::Progress& progress)
+{
+#ifdef OPENCAP_HAVE_ZLIB
+  auto fail = [errorMessage](const QString& message)
+  {
+    if (errorMessage)
+    {
+      *errorMessage = message;
+    }
+    return false;
+  };
+
+  if (sourceImage.isNull())
+  {
+    return fail("图像为空");
+  }
+
+  // 截图帧已经是32位格式，其他格式先统一转换
+  QImage image = sourceImage;
+  if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32 &&
+      image.format() != QImage::Format_ARGB32_Premultiplied)
+  {
+    image = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32
+                                                          : QImage::Format_RGB32);
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  const Settings settings = settingsFor(level);
+  const int width = image.width();
+  const int height = image.height();
+
+  // 截图通常完全不透明：并行检查alpha，不透明时写为RGB，数据量减少四分之一
+  std::atomic<bool> translucent(false);
+  if (image.format() != QImage::Format_RGB32)
+  {
+    const int checkRows = 64;
+    ImageEncoder::parallelFor((height + checkRows - 1) / checkRows,
+                              [&](int index)
+                              {
+                                const int last = qMin(height, (index + 1) * checkRows);
+                                for (int y = index * checkRows; y < last; ++y)
+                                {
+                                  if (translucent.load(std::memory_order_relaxed))
+                                  {
+                                    return;
+                                  }
+                                  const QRgb* row =
+                                      reinterpret_cast<const QRgb*>(image.constScanLine(y));
+                                  for (int x = 0; x < width; ++x)
+                                  {
+                                    if (qAlpha(row[x]) != 255)
+                                    {
+                                      translucent.store(true, std::memory_order_relaxed);
+                                      return;
+                                    }
+                                  }
+                                }
+                              });
+  }
+  const bool alpha = translucent.load();
+
+  // 条带大小：原始数据64KB~1MB，尽量让每个线程分到多个条带
+  const qsizetype filteredBytes = qsizetype(width) * (alpha ? 4 : 3) + 1;
+  const int threads = ImageEncoder::threadCount();
+  const int minRows = int(qMax<qsizetype>(1, MIN_STRIPE_BYTES / filteredBytes));
+  const int maxRows = int(qMax<qsizetype>(minRows, MAX_STRIPE_BYTES / filteredBytes));
+  const int rowsPerStripe = qBound(minRows, (height + threads * 2 - 1) / (threads * 2), maxRows);
+  const int stripeCount = (height + rowsPerStripe - 1) / rowsPerStripe;
+
+  // 压缩占编码的绝大部分时间，按完成的条带数报告0~90，写入完成后报告100
+  std::vector<Stripe> stripes(static_cast<size_t>(stripeCount));
+  std::atomic<int> finishedStripes(0);
+  ImageEncoder::parallelFor(stripeCount,
+                            [&](int index)
+                            {
+                              compressStripe(image,
+                                             index * rowsPerStripe,
+                                             qMin(height, (index + 1) * rowsPerStripe),
+                                             alpha,
+                                             index == stripeCount - 1,
+                                             settings,
+                                             stripes[size_t(index)]);
+                              if (progress)
+                              {
+                                progress(++finishedStripes * 90 / stripeCount);
+                              }
+                            });
+
+  // 合并各条带的Adler-32
+  uLong adler = 1;
+  for (const Stripe& stripe : stripes)
+  {
+    if (!stripe.ok)
+    {
+      return fail("PNG压缩失败");
+    }
+    adler = adler32_combine(adler, stripe.adler, z_off_t(stripe.rawSize));
+  }
+
+  // 文件头和图像信息
+  QByteArray header;
+  appendUInt32(header, quint32(width));
+  appendUInt32(header, quint32(height));
+  header.append(char(8));             // 位深度
+  header.append(char(alpha ? 6 : 2)); // 颜色类型：RGBA/RGB
+  header.append(char(0));             // 压缩方法
+  header.append(char(0));             // 过滤方法
+  header.append(char(0));             // 不隔行
+  if (device->write(reinterpret_cast<const char*>(PNG_SIGNATURE), 8) != 8 ||
+      !writeChunk(device, "IHDR", header))
+  {
+    return fail(device->errorString());
+  }
+
+  // 物理像素密度（与Qt的PNG编码器一致）
+  if (image.dotsPerMeterX() > 0 && image.dotsPerMeterY() > 0)
+  {
+    QByteArray physical;
+    appendUInt32(physical, quint32(image.dotsPerMeterX()));
+    appendUInt32(physical, quint32(image.dotsPerMeterY()));
+    physical.append(char(1)); // 单位：米
+    if (!writeChunk(device, "pHYs", physical))
+    {
+      return fail(device->errorString());
+    }
+  }
+
+  // 每个条带写入一个IDAT块
+  QByteArray checksum;
+  appendUInt32(checksum, quint32(adler));
+  for (int i = 0; i < stripeCount; ++i)
+  {
+    const QByteArray prefix = i == 0 ? zlibHeader(settings.compressionLevel) : QByteArray();
+    const QByteArray suffix = i == stripeCount - 1 ? checksum : QByteArray();
+    if (!writeStripeChunk(device, prefix, stripes[size_t(i)], suffix))
+    {
+      return fail(device->errorString());
+    }
+  }
+  if (!writeChunk(device, "IEND", QByteArray()))
+  {
+    return fail(device->errorString());
+  }
+
+  if (progress)
+  {
+    progress(100);
+  }
+
+  qDebug() << "PNG编码完成，尺寸:" << image.size() << "等级:" << ImageEncoder::levelName(level)
+           << "条带:" << stripeCount << "线程:" << threads
+           << "耗时:" << timer.nsecsElapsed() / 1000000.0 << "ms";
+  return true;
+#else
+  Q_UNUSED(sourceImage);
+  Q_UNUSED(device);
+  Q_UNUSED(level);
+  Q_UNUSED(progress);
+  if (errorMessage)
+  {
+    *errorMessage = "编译时未启用zlib";
+  }
+  return false;
+#endif
+}
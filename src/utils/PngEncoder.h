@@ -0,0 +1,40 @@
+#ifndef PNGENCODER_H
+#define PNGENCODER_H
+
+#include <QIODevice>
+#include <QImage>
+#include <QString>
+
+#include "ImageEncoder.h"
+
+/**
+ * 并行PNG编码器
+ * 图像按行切分成条带，每个条带在线程中独立过滤和deflate（以前一个条带末尾的32KB作为预设字典，
+ * 压缩率与单线程接近），除最后一个条带外都以同步刷新结束，拼接后是一个完整的zlib数据流
+ * 需要zlib（编译时定义OPENCAP_HAVE_ZLIB），否则isAvailable()返回false
+ */
+class PngEncoder
+{
+public:
+  // 私有构造函数（静态类）
+  PngEncoder() = delete;
+
+  static bool isAvailable(); // 编译时是否启用了zlib
+
+  /**
+   * 编码PNG并写入设备：不透明图像写为RGB，否则写为RGBA（非预乘）
+   * @param image 要编码的图像
+   * @param device 已打开的目标设备
+   * @param level 速度/体积等级
+   * @param errorMessage 失败时写入错误信息，可以为空
+   * @param progress 进度回调（每个条带压缩完成时报告），可以为空
+   * @return 是否成功
+   */
+  static bool write(const QImage& image,
+                    QIODevice* device,
+                    ImageEncoder::Level level,
+                    QString* errorMessage,
+                    const ImageEncoder::Progress& progress = ImageEncoder::Progress());
+};
+
+#endif // PNGENCODER_H
@@ -0,0 +1,434 @@
+#include "QoiCodec.h"
+
+#include <QDebug>
+#include <QFile>
+#include <climits>
+
+namespace
+{
+constexpr uchar OP_INDEX = 0x00; // 00xxxxxx：引用索引中的像素
+constexpr uchar OP_DIFF = 0x40;  // 01xxxxxx：与上一个像素的小差值
+constexpr uchar OP_LUMA = 0x80;  // 10xxxxxx：以绿色差值为基准的差值（2字节）
+constexpr uchar OP_RUN = 0xc0;   // 11xxxxxx：重复上一个像素
+constexpr uchar OP_RGB = 0xfe;   // 完整的RGB，透明度不变
+constexpr uchar OP_RGBA = 0xff;  // 完整的RGBA
+constexpr uchar OP_MASK = 0xc0;  // 两位操作码的掩码
+
+constexpr int HEADER_SIZE = 14;                           // 文件头长度
+constexpr uchar END_MARKER[8] = {0, 0, 0, 0, 0, 0, 0, 1}; // 结束标记
+constexpr qsizetype BUFFER_SIZE = 64 * 1024;              // 读写缓冲区大小
+constexpr QRgb INITIAL_PIXEL = 0xff000000;                // 初始的上一个像素（不透明黑色）
+constexpr qint64 MAX_PIXELS = qint64(400) * 1000 * 1000;  // 像素数上限（与参考实现一致）
+constexpr int PROGRESS_ROWS = 64;                         // 每编码这么多行报告一次进度
+
+// 像素在索引中的位置
+inline int indexPosition(QRgb pixel)
+{
+  return (qRed(pixel) * 3 + qGreen(pixel) * 5 + qBlue(pixel) * 7 + qAlpha(pixel) * 11) % 64;
+}
+
+// 大端序32位整数
+void appendUInt32(QByteArray& data, quint32 value)
+{
+  data.append(char(value >> 24));
+  data.append(char(value >> 16));
+  data.append(char(value >> 8));
+  data.append(char(value));
+}
+
+quint32 readUInt32(const uchar* data)
+{
+  return (quint32(data[0]) << 24) | (quint32(data[1]) << 16) | (quint32(data[2]) << 8) |
+         quint32(data[3]);
+}
+} // namespace
+
+// 构造函数
+QoiEncoder::QoiEncoder(QIODevice* device)
+  : m_device(device), m_previous(INITIAL_PIXEL), m_run(0), m_width(0), m_rowsLeft(0)
+{
+}
+
+// 写入文件头
+bool QoiEncoder::begin(int width, int height, bool alpha)
+{
+  if (width <= 0 || height <= 0 || qint64(width) * height > MAX_PIXELS)
+  {
+    m_error = QString("图像尺寸不受支持: %1x%2").arg(width).arg(height);
+    return false;
+  }
+
+  m_width = width;
+  m_rowsLeft = height;
+  m_previous = INITIAL_PIXEL;
+  m_run = 0;
+  m_index.fill(0);
+
+  m_buffer.clear();
+  m_buffer.reserve(BUFFER_SIZE + 64);
+  m_buffer.append("qoif", 4);
+  appendUInt32(m_buffer, quint32(width));
+  appendUInt32(m_buffer, quint32(height));
+  m_buffer.append(char(alpha ? 4 : 3));
+  m_buffer.append(char(0)); // sRGB，透明度为线性
+  return true;
+}
+
+// 写入一行像素
+bool QoiEncoder::writeRow(const QRgb* row, bool premultiplied)
+{
+  if (m_rowsLeft <= 0)
+  {
+    m_error = "写入的行数超过了图像高度";
+    return false;
+  }
+  --m_rowsLeft;
+
+  for (int x = 0; x < m_width; ++x)
+  {
+    QRgb pixel = row[x];
+    if (premultiplied && qAlpha(pixel) != 255)
+    {
+      pixel = qUnpremultiply(pixel);
+    }
+
+    // 连续相同的像素（截图中的大片纯色）合并为一个操作，跨行继续计数
+    if (pixel == m_previous)
+    {
+      if (++m_run == 62)
+      {
+        m_buffer.append(char(OP_RUN | (m_run - 1)));
+        m_run = 0;
+      }
+      continue;
+    }
+    if (m_run > 0)
+    {
+      m_buffer.append(char(OP_RUN | (m_run - 1)));
+      m_run = 0;
+    }
+
+    const int position = indexPosition(pixel);
+    if (m_index[size_t(position)] == pixel)
+    {
+      m_buffer.append(char(OP_INDEX | position));
+    }
+    else
+    {
+      m_index[size_t(position)] = pixel;
+      if (qAlpha(pixel) == qAlpha(m_previous))
+      {
+        const int dr = qint8(qRed(pixel) - qRed(m_previous));
+        const int dg = qint8(qGreen(pixel) - qGreen(m_previous));
+        const int db = qint8(qBlue(pixel) - qBlue(m_previous));
+        const int drg = dr - dg;
+        const int dbg = db - dg;
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+        {
+          m_buffer.append(char(OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+        }
+        else if (drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7)
+        {
+          m_buffer.append(char(OP_LUMA | (dg + 32)));
+          m_buffer.append(char(((drg + 8) << 4) | (dbg + 8)));
+        }
+        else
+        {
+          m_buffer.append(char(OP_RGB));
+          m_buffer.append(char(qRed(pixel)));
+          m_buffer.append(char(qGreen(pixel)));
+          m_buffer.append(char(qBlue(pixel)));
+        }
+      }
+      else
+      {
+        m_buffer.append(char(OP_RGBA));
+        m_buffer.append(char(qRed(pixel)));
+        m_buffer.append(char(qGreen(pixel)));
+        m_buffer.append(char(qBlue(pixel)));
+        m_buffer.append(char(qAlpha(pixel)));
+      }
+    }
+    m_previous = pixel;
+  }
+
+  return m_buffer.size() < BUFFER_SIZE || flush();
+}
+
+// 写入结束标记
+bool QoiEncoder::finish()
+{
+  if (m_rowsLeft != 0)
+  {
+    m_error = QString("还有%1行没有写入").arg(m_rowsLeft);
+    return false;
+  }
+  if (m_run > 0)
+  {
+    m_buffer.append(char(OP_RUN | (m_run - 1)));
+    m_run = 0;
+  }
+  m_buffer.append(reinterpret_cast<const char*>(END_MARKER), 8);
+  return flush();
+}
+
+// 最近一次错误
+QString QoiEncoder::errorString() const
+{
+  return m_error;
+}
+
+// 把缓冲区写入设备
+bool QoiEncoder::flush()
+{
+  if (m_device->write(m_buffer) != m_buffer.size())
+  {
+    m_error = m_device->errorString();
+    return false;
+  }
+  m_buffer.resize(0);
+  return true;
+}
+
+// 编码整张图像
+bool QoiEncoder::write(const QImage& sourceImage,
+                       QIODevice* device,
+                       QString* errorMessage,
+                       const ImageEncoder::Progress& progress)
+{
+  // 截图帧已经是32位格式，直接读取扫描线；其他格式先统一转换
+  QImage image = sourceImage;
+  if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32 &&
+      image.format() != QImage::Format_ARGB32_Premultiplied)
+  {
+    image = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32
+                                                          : QImage::Format_RGB32);
+  }
+
+  QoiEncoder encoder(device);
+  bool ok = encoder.begin(image.width(), image.height(), image.hasAlphaChannel());
+  const bool premultiplied = image.format() == QImage::Format_ARGB32_Premultiplied;
+  for (int y = 0; ok && y < image.height(); ++y)
+  {
+    ok = encoder.writeRow(reinterpret_cast<const QRgb*>(image.constScanLine(y)), premultiplied);
+    if (progress && (y + 1) % PROGRESS_ROWS == 0)
+    {
+      progress(int(qint64(y + 1) * 100 / image.height()));
+    }
+  }
+  ok = ok && encoder.finish();
+  if (ok && progress)
+  {
+    progress(100);
+  }
+
+  if (!ok && errorMessage)
+  {
+    *errorMessage = encoder.errorString();
+  }
+  return ok;
+}
+
+// 构造函数
+QoiDecoder::QoiDecoder(QIODevice* device)
+  : m_device(device),
+    m_position(0),
+    m_previous(INITIAL_PIXEL),
+    m_run(0),
+    m_width(0),
+    m_height(0),
+    m_channels(0),
+    m_rowsLeft(0)
+{
+}
+
+// 读取并校验文件头
+bool QoiDecoder::readHeader()
+{
+  const QByteArray header = m_device->read(HEADER_SIZE);
+  if (header.size() != HEADER_SIZE || !header.startsWith("qoif"))
+  {
+    m_error = "不是QOI文件";
+    return false;
+  }
+
+  const uchar* data = reinterpret_cast<const uchar*>(header.constData());
+  const quint32 width = readUInt32(data + 4);
+  const quint32 height = readUInt32(data + 8);
+  m_channels = data[12];
+  if (width == 0 || height == 0 || width > quint32(INT_MAX) || height > quint32(INT_MAX) ||
+      qint64(width) * qint64(height) > MAX_PIXELS || (m_channels != 3 && m_channels != 4))
+  {
+    m_error = QString("QOI文件头无效: %1x%2，通道数%3").arg(width).arg(height).arg(m_channels);
+    return false;
+  }
+
+  m_width = int(width);
+  m_height = int(height);
+  m_rowsLeft = m_height;
+  m_previous = INITIAL_PIXEL;
+  m_run = 0;
+  m_index.fill(0);
+  m_buffer.clear();
+  m_position = 0;
+  return true;
+}
+
+int QoiDecoder::width() const
+{
+  return m_width;
+}
+
+int QoiDecoder::height() const
+{
+  return m_height;
+}
+
+bool QoiDecoder::hasAlpha() const
+{
+  return m_channels == 4;
+}
+
+// 读取一行像素
+bool QoiDecoder::readRow(QRgb* row)
+{
+  if (m_rowsLeft <= 0)
+  {
+    m_error = "读取的行数超过了图像高度";
+    return false;
+  }
+  --m_rowsLeft;
+
+  for (int x = 0; x < m_width; ++x)
+  {
+    // 重复上一个像素（跨行继续）
+    if (m_run > 0)
+    {
+      --m_run;
+      row[x] = qPremultiply(m_previous);
+      continue;
+    }
+
+    uchar op = 0;
+    if (!readByte(op))
+    {
+      return false;
+    }
+
+    QRgb pixel = m_previous;
+    if (op == OP_RGB || op == OP_RGBA)
+    {
+      uchar r = 0;
+      uchar g = 0;
+      uchar b = 0;
+      uchar a = uchar(qAlpha(m_previous));
+      if (!readByte(r) || !readByte(g) || !readByte(b) || (op == OP_RGBA && !readByte(a)))
+      {
+        return false;
+      }
+      pixel = qRgba(r, g, b, a);
+    }
+    else if ((op & OP_MASK) == OP_INDEX)
+    {
+      pixel = m_index[op & 0x3f];
+    }
+    else if ((op & OP_MASK) == OP_DIFF)
+    {
+      pixel = qRgba((qRed(m_previous) + ((op >> 4) & 0x03) - 2) & 0xff,
+                    (qGreen(m_previous) + ((op >> 2) & 0x03) - 2) & 0xff,
+                    (qBlue(m_previous) + (op & 0x03) - 2) & 0xff,
+                    qAlpha(m_previous));
+    }
+    else if ((op & OP_MASK) == OP_LUMA)
+    {
+      uchar next = 0;
+      if (!readByte(next))
+      {
+        return false;
+      }
+      const int dg = (op & 0x3f) - 32;
+      pixel = qRgba((qRed(m_previous) + dg + ((next >> 4) & 0x0f) - 8) & 0xff,
+                    (qGreen(m_previous) + dg) & 0xff,
+                    (qBlue(m_previous) + dg + (next & 0x0f) - 8) & 0xff,
+                    qAlpha(m_previous));
+    }
+    else
+    {
+      m_run = op & 0x3f; // 本像素之外还要重复的次数
+    }
+
+    m_index[size_t(indexPosition(pixel))] = pixel;
+    m_previous = pixel;
+    row[x] = qPremultiply(pixel);
+  }
+  return true;
+}
+
+// 最近一次错误
+QString QoiDecoder::errorString() const
+{
+  return m_error;
+}
+
+// 从输入缓冲区读取一个字节
+bool QoiDecoder::readByte(uchar& value)
+{
+  if (m_position >= m_buffer.size())
+  {
+    m_buffer = m_device->read(BUFFER_SIZE);
+    m_position = 0;
+    if (m_buffer.isEmpty())
+    {
+      m_error = "QOI数据不完整";
+      return false;
+    }
+  }
+  value = uchar(m_buffer.at(m_position++));
+  return true;
+}
+
+// 解码整个文件为帧格式的QImage
+QImage QoiDecoder::read(QIODevice* device, QString* errorMessage)
+{
+  QoiDecoder decoder(device);
+  QImage image;
+  bool ok = decoder.readHeader();
+  if (ok)
+  {
+    image = QImage(decoder.width(), decoder.height(), QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull())
+    {
+      ok = false;
+      decoder.m_error = "图像内存分配失败";
+    }
+  }
+  for (int y = 0; ok && y < decoder.height(); ++y)
+  {
+    ok = decoder.readRow(reinterpret_cast<QRgb*>(image.scanLine(y)));
+  }
+
+  if (!ok)
+  {
+    if (errorMessage)
+    {
+      *errorMessage = decoder.errorString();
+    }
+    return QImage();
+  }
+  return image;
+}
+
+// 解码文件
+QImage QoiDecoder::read(const QString& filePath, QString* errorMessage)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    if (errorMessage)
+    {
+      *errorMessage = file.errorString();
+    }
+    return QImage();
+  }
+  return read(&file, errorMessage);
+}
@@ -0,0 +1,98 @@
+#ifndef QOICODEC_H
+#define QOICODEC_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QImage>
+#include <QRgb>
+#include <QString>
+#include <array>
+
+#include "ImageEncoder.h"
+
+/**
+ * QOI编码器（Quite OK Image，https://qoiformat.org）
+ * 单遍无损编码，速度远高于PNG，用于临时文件和工具链之间传递截图
+ * 逐行写入：直接读取帧的扫描线（预乘ARGB32），不需要先转换或拷贝成完整的QImage
+ */
+class QoiEncoder
+{
+public:
+  explicit QoiEncoder(QIODevice* device);
+
+  /**
+   * 写入文件头
+   * @param width 宽度
+   * @param height 高度
+   * @param alpha 是否包含透明通道（只写入文件头作为提示，不影响编码）
+   */
+  bool begin(int width, int height, bool alpha);
+
+  /**
+   * 写入一行像素
+   * @param row 像素行（ARGB32，宽度与文件头一致）
+   * @param premultiplied 像素是否为预乘格式（QOI保存非预乘的RGBA）
+   */
+  bool writeRow(const QRgb* row, bool premultiplied);
+
+  bool finish();               // 写入结束标记（所有行写完后调用）
+  QString errorString() const; // 最近一次错误
+
+  // 编码整张图像（32位格式直接逐行读取扫描线），progress可以为空
+  static bool write(const QImage& image,
+                    QIODevice* device,
+                    QString* errorMessage,
+                    const ImageEncoder::Progress& progress = ImageEncoder::Progress());
+
+private:
+  bool flush(); // 把缓冲区写入设备
+
+  QIODevice* m_device;            // 目标设备
+  QByteArray m_buffer;            // 输出缓冲区
+  std::array<QRgb, 64> m_index{}; // 最近出现过的像素（按哈希索引，非预乘）
+  QRgb m_previous;                // 上一个像素（非预乘）
+  int m_run;                      // 与上一个像素相同的连续像素数
+  int m_width;                    // 宽度
+  int m_rowsLeft;                 // 剩余行数
+  QString m_error;                // 最近一次错误
+};
+
+/**
+ * QOI解码器
+ * 逐行读取，输出帧格式（预乘ARGB32）的像素，可以直接解码到帧或QImage的扫描线中
+ */
+class QoiDecoder
+{
+public:
+  explicit QoiDecoder(QIODevice* device);
+
+  bool readHeader(); // 读取并校验文件头
+  int width() const;
+  int height() const;
+  bool hasAlpha() const; // 文件头中的透明通道提示
+
+  // 读取一行像素（预乘ARGB32，宽度为width()）
+  bool readRow(QRgb* row);
+  QString errorString() const; // 最近一次错误
+
+  // 解码整个文件为帧格式的QImage（像素直接写入图像的扫描线）
+  static QImage read(QIODevice* device, QString* errorMessage);
+  static QImage read(const QString& filePath, QString* errorMessage);
+
+private:
+  bool readByte(uchar& value); // 从输入缓冲区读取一个字节，缓冲区用完时从设备补充
+
+  QIODevice* m_device;            // 源设备
+  QByteArray m_buffer;            // 输入缓冲区
+  qsizetype m_position;           // 缓冲区中的读取位置
+  std::array<QRgb, 64> m_index{}; // 最近出现过的像素（按哈希索引，非预乘）
+  QRgb m_previous;                // 上一个像素（非预乘）
+  int m_run;                      // 还需要重复上一个像素的次数
+  int m_width;                    // 宽度
+  int m_height;                   // 高度
+  int m_channels;                 // 通道数（3或4）
+  int m_rowsLeft;                 // 剩余行数
+  QString m_error;                // 最近一次错误
+};
+
+#endif // QOICODEC_H
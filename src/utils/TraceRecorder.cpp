@@ -0,0 +1,239 @@
+#include "TraceRecorder.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// 当前线程的标识
+quintptr currentThread()
+{
+  return quintptr(QThread::currentThreadId());
+}
+} // namespace
+
+// 构造函数
+TraceRecorder::TraceRecorder() : m_mainThread(currentThread()), m_writeIndex(0)
+{
+  for (Slot& slot : m_slots)
+  {
+    slot.sequence.store(0, std::memory_order_relaxed);
+    slot.category.store(nullptr, std::memory_order_relaxed);
+    slot.name.store(nullptr, std::memory_order_relaxed);
+    slot.start.store(0, std::memory_order_relaxed);
+    slot.duration.store(0, std::memory_order_relaxed);
+    slot.thread.store(0, std::memory_order_relaxed);
+  }
+  m_clock.start();
+}
+
+// 进程共享的记录器（有意不释放，静态对象析构之后的跟踪点仍然安全）
+TraceRecorder& TraceRecorder::instance()
+{
+  static TraceRecorder* recorder = new TraceRecorder();
+  return *recorder;
+}
+
+// 跟踪时钟的当前读数
+qint64 TraceRecorder::now()
+{
+  return instance().m_clock.nsecsElapsed();
+}
+
+// 记录持续区间
+void TraceRecorder::complete(const char* category,
+                             const char* name,
+                             qint64 startNs,
+                             qint64 durationNs)
+{
+  if (durationNs < 0)
+  {
+    durationNs = m_clock.nsecsElapsed() - startNs;
+  }
+  record(category, name, startNs, qMax<qint64>(0, durationNs));
+}
+
+// 记录瞬时事件
+void TraceRecorder::instant(const char* category, const char* name)
+{
+  record(category, name, m_clock.nsecsElapsed(), -1);
+}
+
+// 写入一个事件：每个写入者独占一个位置，不需要加锁；写满后覆盖最旧的事件
+void TraceRecorder::record(const char* category,
+                           const char* name,
+                           qint64 startNs,
+                           qint64 durationNs)
+{
+  const quint64 index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = m_slots[index % CAPACITY];
+
+  slot.sequence.store(index * 2 + 1, std::memory_order_relaxed); // 正在写入
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.category.store(category, std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start.store(startNs, std::memory_order_relaxed);
+  slot.duration.store(durationNs, std::memory_order_relaxed);
+  slot.thread.store(currentThread(), std::memory_order_relaxed);
+  slot.sequence.store(index * 2 + 2, std::memory_order_release); // 写入完成
+}
+
+// 导出为Chrome跟踪JSON
+QByteArray TraceRecorder::toChromeJson() const
+{
+  struct Event
+  {
+    quint64 index;
+    const char* category;
+    const char* name;
+    qint64 start;
+    qint64 duration;
+    quintptr thread;
+  };
+
+  // 读取所有完整的事件（读取期间被覆盖或正在写入的事件丢弃）
+  std::vector<Event> events;
+  events.reserve(CAPACITY);
+  for (const Slot& slot : m_slots)
+  {
+    const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence == 0 || sequence % 2 != 0)
+    {
+      continue;
+    }
+
+    Event event;
+    event.index = sequence / 2 - 1;
+    event.category = slot.category.load(std::memory_order_relaxed);
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.start = slot.start.load(std::memory_order_relaxed);
+    event.duration = slot.duration.load(std::memory_order_relaxed);
+    event.thread = slot.thread.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+    {
+      events.push_back(event);
+    }
+  }
+  std::sort(events.begin(),
+            events.end(),
+            [](const Event& a, const Event& b) { return a.index < b.index; });
+
+  const qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray traceEvents;
+
+  // 线程编号：主线程为1，其他线程按第一次出现的顺序从2开始编号
+  QHash<quintptr, int> threadIds;
+  auto threadId = [&](quintptr thread)
+  {
+    auto it = threadIds.find(thread);
+    if (it != threadIds.end())
+    {
+      return it.value();
+    }
+
+    const int id = thread == m_mainThread ? 1 : int(threadIds.size()) + 1; // 主线程总是最先编号
+    threadIds.insert(thread, id);
+
+    QJsonObject args;
+    args["name"] = id == 1 ? QString("GUI") : QString("worker %1").arg(id - 1);
+    QJsonObject metadata;
+    metadata["name"] = "thread_name";
+    metadata["ph"] = "M";
+    metadata["pid"] = pid;
+    metadata["tid"] = id;
+    metadata["args"] = args;
+    traceEvents.append(metadata);
+    return id;
+  };
+
+  QJsonObject processArgs;
+  processArgs["name"] = QCoreApplication::applicationName();
+  QJsonObject processName;
+  processName["name"] = "process_name";
+  processName["ph"] = "M";
+  processName["pid"] = pid;
+  processName["args"] = processArgs;
+  traceEvents.append(processName);
+  threadId(m_mainThread);
+
+  for (const Event& event : events)
+  {
+    QJsonObject json;
+    json["cat"] = event.category;
+    json["name"] = event.name;
+    json["pid"] = pid;
+    json["tid"] = threadId(event.thread);
+    json["ts"] = double(event.start) / 1000.0; // 微秒
+    if (event.duration < 0)
+    {
+      json["ph"] = "i";
+      json["s"] = "t";
+    }
+    else
+    {
+      json["ph"] = "X";
+      json["dur"] = double(event.duration) / 1000.0;
+    }
+    traceEvents.append(json);
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = traceEvents;
+  root["displayTimeUnit"] = "ms";
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+// 保存到文件
+QString TraceRecorder::exportTo(const QString& filePath) const
+{
+  const QString path = filePath.isEmpty() ? defaultTracePath() : filePath;
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qWarning() << "跟踪数据保存失败:" << path << file.errorString();
+    return QString();
+  }
+
+  file.write(toChromeJson());
+  qDebug() << "跟踪数据已保存:" << path;
+  return path;
+}
+
+// 默认的跟踪文件路径
+QString TraceRecorder::defaultTracePath()
+{
+  const QString path = qEnvironmentVariable("OPENCAP_TRACE_FILE");
+  if (!path.isEmpty())
+  {
+    return path;
+  }
+
+  return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+         "/metrics/trace.json";
+}
+
+// 作用域跟踪：构造时开始
+TraceRecorder::Scope::Scope(const char* category, const char* name)
+  : m_category(category), m_name(name), m_start(TraceRecorder::now())
+{
+}
+
+// 作用域跟踪：析构时记录持续区间
+TraceRecorder::Scope::~Scope()
+{
+  TraceRecorder::instance().complete(m_category, m_name, m_start);
+}
@@ -0,0 +1,78 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+/**
+ * 跟踪记录器
+ * 命名的跟踪点（持续区间和瞬时事件）写入固定容量的环形缓冲区，写满后覆盖最旧的事件；
+ * 需要时导出为Chrome/Perfetto可以直接打开的跟踪JSON（chrome://tracing 或 ui.perfetto.dev）
+ * 记录不加锁，任意线程都可以并发调用；名称和分类必须是字符串字面量（只保存指针）
+ */
+class TraceRecorder
+{
+public:
+  static constexpr int CAPACITY = 8192; // 环形缓冲区保存的最近事件数
+
+  // 进程共享的记录器，第一次调用时开始计时（应在main开头调用）
+  static TraceRecorder& instance();
+
+  // 跟踪时钟的当前读数（纳秒，从第一次调用instance开始）
+  static qint64 now();
+
+  // 记录持续区间：从startNs开始持续durationNs（默认到现在）
+  void complete(const char* category, const char* name, qint64 startNs, qint64 durationNs = -1);
+  // 记录瞬时事件
+  void instant(const char* category, const char* name);
+
+  // 导出为Chrome跟踪JSON（按时间排序，带进程和线程名称）
+  QByteArray toChromeJson() const;
+  // 保存到文件（路径为空时使用默认路径），返回实际写入的路径，失败时为空
+  QString exportTo(const QString& filePath = QString()) const;
+  // 默认的跟踪文件路径：OPENCAP_TRACE_FILE指定的路径，否则为指标目录下的trace.json
+  static QString defaultTracePath();
+
+  // 作用域跟踪：构造时开始，析构时记录一个持续区间
+  class Scope
+  {
+  public:
+    Scope(const char* category, const char* name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const char* m_category;
+    const char* m_name;
+    qint64 m_start;
+  };
+
+private:
+  TraceRecorder();
+
+  // 环形缓冲区中的一个事件：sequence为奇数时正在写入，读取前后不一致时丢弃
+  struct Slot
+  {
+    std::atomic<quint64> sequence;     // 写入序号（0表示从未写入）
+    std::atomic<const char*> category; // 分类
+    std::atomic<const char*> name;     // 名称
+    std::atomic<qint64> start;         // 开始时间（纳秒）
+    std::atomic<qint64> duration;      // 持续时间（纳秒，瞬时事件为-1）
+    std::atomic<quintptr> thread;      // 记录事件的线程
+  };
+
+  void record(const char* category, const char* name, qint64 startNs, qint64 durationNs);
+
+  QElapsedTimer m_clock;              // 跟踪时钟
+  quintptr m_mainThread;              // 主线程（导出时命名为GUI）
+  std::atomic<quint64> m_writeIndex;  // 下一个写入位置
+  std::array<Slot, CAPACITY> m_slots; // 最近事件
+};
+
+#endif // TRACERECORDER_H